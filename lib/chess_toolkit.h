@@ -23,14 +23,24 @@
 #include "chess_toolkit/ct_square.h"
 #include "chess_toolkit/ct_piece.h"
 #include "chess_toolkit/ct_bit_board.h"
+#include "chess_toolkit/ct_bit_board_batch.h"
 #include "chess_toolkit/ct_position.h"
 #include "chess_toolkit/ct_move.h"
 #include "chess_toolkit/ct_move_command.h"
 #include "chess_toolkit/ct_move_stack.h"
+#include "chess_toolkit/ct_move_tree.h"
 #include "chess_toolkit/ct_piece_command.h"
 #include "chess_toolkit/ct_graph.h"
 #include "chess_toolkit/ct_command.h"
+#include "chess_toolkit/ct_cpu.h"
 #include "chess_toolkit/ct_game_tags.h"
+#include "chess_toolkit/ct_game_annotations.h"
+#include "chess_toolkit/ct_game_filter.h"
+#include "chess_toolkit/ct_pgn_input.h"
+#include "chess_toolkit/ct_pgn_error_log.h"
+#include "chess_toolkit/ct_pgn_index.h"
+#include "chess_toolkit/ct_pgn_reader.h"
+#include "chess_toolkit/ct_pgn_writer.h"
 
 void chess_toolkit_init(void);
 
@@ -23,6 +23,9 @@
 #define BITB_EMPTY ((CtBitBoard) 0)
 #define BITB_ONE ((CtBitBoard) 1)
 #define BITB_FULL ((CtBitBoard) 0xFFFFFFFFFFFFFFFF)
+#define BITB_FILE_A ((CtBitBoard) 0x0101010101010101)
+#define BITB_FILE_H ((CtBitBoard) 0x8080808080808080)
+#define BITB_RANK_1 ((CtBitBoard) 0xFF)
 
 /* making this inline appears to save significant time on the long perft test */
 static inline CtBitBoard
@@ -33,6 +36,12 @@ ct_bit_board_make(CtSquare square)
 
 /* if bit_board is empty, it returns SQUARE_NOT_FOUND (-1) */
 CtSquare ct_bit_board_find_first_square(CtBitBoard bit_board);
+int ct_bit_board_count_squares(CtBitBoard bit_board);
+
+/* the squares strictly between from and to, and the whole line through both, are empty unless from and to share a
+   rank, file or diagonal */
+CtBitBoard ct_bit_board_between(CtSquare from, CtSquare to);
+CtBitBoard ct_bit_board_line(CtSquare from, CtSquare to);
 
 /* ct_bit_board_to_s is defined in ct_bit_board_to_s.c */
 enum
@@ -45,5 +54,13 @@ void ct_bit_board_array_reset(CtBitBoardArray bit_board_array);
 
 bool ct_bit_board_array_is_white_attacking(CtBitBoardArray bit_board_array, CtSquare square);
 bool ct_bit_board_array_is_black_attacking(CtBitBoardArray bit_board_array, CtSquare square);
+bool ct_bit_board_array_is_attacking_from(CtBitBoardArray bit_board_array, CtPiece piece, CtSquare from, CtSquare to);
+bool ct_bit_board_is_attacking_from(CtPiece piece, CtSquare from, CtSquare to, CtBitBoard occupied);
+
+CtBitBoard ct_bit_board_array_attackers_to(CtBitBoardArray bit_board_array, CtSquare square, CtBitBoard occupied);
+CtBitBoard ct_bit_board_array_x_ray_attackers_to(CtBitBoardArray bit_board_array, CtSquare square, CtBitBoard occupied);
+CtBitBoard ct_bit_board_array_white_attacks(CtBitBoardArray bit_board_array);
+CtBitBoard ct_bit_board_array_black_attacks(CtBitBoardArray bit_board_array);
+CtBitBoard ct_bit_board_array_pinned(CtBitBoardArray bit_board_array, CtSquare square, CtPieceColor color);
 
 #endif                                /* CT_BIT_BOARD_H */
@@ -0,0 +1,46 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_BIT_BOARD_BATCH_H
+#define CT_BIT_BOARD_BATCH_H
+
+#include "ct_types.h"
+
+/* A batch keeps the bit boards of many positions column by column -- the bit boards of one piece in every position
+   are stored next to each other -- so a predicate can be applied to the whole batch with vector instructions instead
+   of one position at a time.  The predicates answer with bit sets: bit index % 64 of word index / 64 stands for the
+   position at index, and result needs room for ct_bit_board_batch_result_words(batch) words. */
+CtBitBoardBatch ct_bit_board_batch_new(void);
+void ct_bit_board_batch_free(CtBitBoardBatch batch);
+
+void ct_bit_board_batch_reset(CtBitBoardBatch batch);
+
+/* returns the index of the position in the batch */
+int ct_bit_board_batch_add(CtBitBoardBatch batch, CtPosition position);
+int ct_bit_board_batch_count(CtBitBoardBatch batch);
+int ct_bit_board_batch_result_words(CtBitBoardBatch batch);
+
+/* the bit boards of piece, one for each position added -- it moves when a position is added */
+CtBitBoard *ct_bit_board_batch_column(CtBitBoardBatch batch, CtPiece piece);
+
+/* attacks and mobility need room for one entry for each position */
+void ct_bit_board_batch_attacks(CtBitBoardBatch batch, CtPieceColor color, CtBitBoard *attacks);
+void ct_bit_board_batch_mobility(CtBitBoardBatch batch, CtPieceColor color, int *mobility);
+void ct_bit_board_batch_is_attacked(CtBitBoardBatch batch, CtPieceColor color, CtSquare square, uint64_t *result);
+void ct_bit_board_batch_is_check(CtBitBoardBatch batch, uint64_t *result);
+
+#endif                                /* CT_BIT_BOARD_BATCH_H */
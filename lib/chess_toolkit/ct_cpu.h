@@ -0,0 +1,33 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_CPU_H
+#define CT_CPU_H
+
+#include "ct_types.h"
+
+/* chess_toolkit_init asks the processor which instructions it has and chooses the first square, square count, slider
+   attack, bit board batch and newline counting kernels to match.  The environment variable CT_CPU_LEVEL, set to the
+   name of a lower level, holds the choice down to that level. */
+CtCpuLevel ct_cpu_detected_level(void);
+CtCpuLevel ct_cpu_level(void);
+const char *ct_cpu_level_name(CtCpuLevel level);
+
+/* chooses the kernels of a level no higher than the detected one, for comparing them -- returns false otherwise */
+bool ct_cpu_force_level(CtCpuLevel level);
+
+#endif                                /* CT_CPU_H */
@@ -20,7 +20,22 @@
 
 typedef void (*CtErrorHandler) (const char *);
 
+/* An error channel receives the errors raised on the threads that use it, so that each thread (or each job) can
+   handle its own errors.  If the channel's method is 0, the error is recorded and then handled as if there were no
+   channel. */
+typedef struct CtErrorChannelStruct *CtErrorChannel;
+typedef void (*CtErrorChannelMethod) (void *delegate, const char *str);
+
 void ct_error_set_custom_handler(CtErrorHandler error_handler);
 void ct_error(const char *str);
 
+CtErrorChannel ct_error_channel_new(void *delegate, CtErrorChannelMethod method);
+void ct_error_channel_free(CtErrorChannel error_channel);
+
+/* returns the channel the calling thread used before, so it can be restored -- 0 means no channel */
+CtErrorChannel ct_error_use_channel(CtErrorChannel error_channel);
+
+int ct_error_channel_count(CtErrorChannel error_channel);
+const char *ct_error_channel_last_error(CtErrorChannel error_channel);
+
 #endif                                /* CT_ERROR_H */
@@ -0,0 +1,45 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_GAME_ANNOTATIONS_H
+#define CT_GAME_ANNOTATIONS_H
+
+#include "ct_types.h"
+#include <limits.h>
+
+enum
+{
+  GAME_ANNOTATIONS_MISSING = INT_MIN,        /* a ply without a clock or evaluation */
+  GAME_ANNOTATIONS_MATE = 100000        /* mate in n is MATE - n centipawns, and being mated in n is n - MATE */
+};
+
+/* Game annotations hold the [%clk] and [%eval] commands found in the comments of a game, as numbers indexed by ply:
+   the comment after the first move is ply 1, and a comment before any moves is ply 0.  Clocks are in centiseconds,
+   and evaluations are in centipawns from white's point of view.  Attach them to a PGN input to have them filled in as
+   each game is read. */
+CtGameAnnotations ct_game_annotations_new(void);
+void ct_game_annotations_free(CtGameAnnotations game_annotations);
+
+void ct_game_annotations_reset(CtGameAnnotations game_annotations);
+void ct_game_annotations_read_comment(CtGameAnnotations game_annotations, int ply, char *comment, int length);
+
+/* the arrays have ct_game_annotations_ply_count entries, and stay valid until the annotations are next changed */
+int ct_game_annotations_ply_count(CtGameAnnotations game_annotations);
+int *ct_game_annotations_clocks(CtGameAnnotations game_annotations);
+int *ct_game_annotations_evals(CtGameAnnotations game_annotations);
+
+#endif                                /* CT_GAME_ANNOTATIONS_H */
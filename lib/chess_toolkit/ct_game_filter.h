@@ -0,0 +1,38 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_GAME_FILTER_H
+#define CT_GAME_FILTER_H
+
+#include "ct_types.h"
+
+/* A game filter decides from a game's tags alone whether the game is wanted, so that the moves of unwanted games
+   never have to be decoded.  A new filter accepts every game; each criterion that is set must also be met. */
+CtGameFilter ct_game_filter_new(void);
+void ct_game_filter_free(CtGameFilter game_filter);
+
+void ct_game_filter_reset(CtGameFilter game_filter);
+
+void ct_game_filter_set_elo_range(CtGameFilter game_filter, int minimum, int maximum);
+void ct_game_filter_set_date_range(CtGameFilter game_filter, char *earliest, char *latest);
+void ct_game_filter_set_player(CtGameFilter game_filter, char *player);
+void ct_game_filter_set_eco_range(CtGameFilter game_filter, char *first, char *last);
+void ct_game_filter_set_predicate(CtGameFilter game_filter, void *delegate, CtGameFilterMethod method);
+
+bool ct_game_filter_accepts(CtGameFilter game_filter, CtGameTags game_tags);
+
+#endif                                /* CT_GAME_FILTER_H */
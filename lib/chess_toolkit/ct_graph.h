@@ -30,11 +30,23 @@ void ct_graph_reset(CtGraph graph);
 int ct_graph_ply(CtGraph graph);
 
 void ct_graph_for_each_legal_move(CtGraph graph, CtMoveCommand move_command);
+/* the array stays valid until the graph changes position */
+CtMove *ct_graph_legal_moves(CtGraph graph);
+int ct_graph_legal_move_count(CtGraph graph);
 void ct_graph_for_each_move_made(CtGraph graph, CtMoveCommand move_command);
 
 void ct_graph_make_move(CtGraph graph, CtMove move);
 CtMove ct_graph_unmake_move(CtGraph graph);
 
+/* the moves made are kept as a line when the graph goes back to an earlier ply, until a different move is made there
+   -- any ply of the line can be reached with fewer than GRAPH_SNAPSHOT_INTERVAL moves made */
+enum
+{
+  GRAPH_SNAPSHOT_INTERVAL = 16
+};
+int ct_graph_line_length(CtGraph graph);
+bool ct_graph_goto_ply(CtGraph graph, int ply);
+
 /* ct_graph_move_to_san is defined in ct_move_writer.c */
 enum
 {
@@ -45,11 +57,38 @@ char *ct_graph_move_to_san(CtGraph graph, CtMove move, char *destination);
 /* ct_graph_move_from_san is defined in ct_move_reader.c */
 CtMove ct_graph_move_from_san(CtGraph graph, char *notation);
 
+/* ct_graph_line_to_san and ct_graph_line_from_san make the moves of the line as they go -- ct_graph_line_to_san is
+   defined in ct_move_writer.c and needs a destination (it has no shared one) of at least
+   move_count * CT_SAN_MAX_LENGTH characters */
+char *ct_graph_line_to_san(CtGraph graph, CtMove *moves, int move_count, char *destination);
+int ct_graph_line_from_san(CtGraph graph, char *notation, CtMove *moves, int max_moves);
+
+/* ct_graph_move_to_uci is defined in ct_move_writer.c */
+enum
+{
+  CT_UCI_MAX_LENGTH = 6
+};
+char *ct_graph_move_to_uci(CtGraph graph, CtMove move, char *destination);
+
+/* ct_graph_move_from_uci is defined in ct_move_reader.c */
+CtMove ct_graph_move_from_uci(CtGraph graph, char *notation);
+
+/* ct_graph_is_legal_move is defined in ct_graph_is_legal_move.c */
+bool ct_graph_is_legal_move(CtGraph graph, CtMove move);
+
+/* ct_graph_moves_by_stage is defined in ct_graph_moves_by_stage.c -- moves needs room for CT_GRAPH_MAX_MOVES */
+enum
+{
+  CT_GRAPH_MAX_MOVES = 256
+};
+int ct_graph_moves_by_stage(CtGraph graph, CtMoveStage stage, CtMove *moves);
+
 /* ct_graph_dfs is defined in ct_graph_dfs.c */
 void ct_graph_dfs(CtGraph graph, CtCommand command, int depth);
 
 /* the following are defined in ct_graph_position.c */
 CtPosition ct_graph_to_position(CtGraph graph, CtPosition position);
+CtPosition ct_graph_position_at(CtGraph graph, int ply, CtPosition position);
 CtGraph ct_graph_from_position(CtGraph graph, CtPosition position);
 char *ct_graph_to_fen(CtGraph graph, char *destination);
 CtGraph ct_graph_from_fen(CtGraph graph, char *fen);
@@ -63,12 +102,16 @@ char *ct_graph_to_s(CtGraph graph, char *destination);
 /* ct_graph_to_new_pgn is defined in ct_graph_to_new_pgn.c */
 char *ct_graph_to_new_pgn(CtGraph graph, CtGameTags game_tags);
 
-/* ct_graph_from_pgn and ct_graph_from_pgn_file are defined in ct_graph_from_pgn.c */
+/* the ct_graph_from_pgn functions are defined in ct_graph_from_pgn.c */
 enum
 {
   CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH = 60
 };
 CtGraph ct_graph_from_pgn(CtGraph graph, CtGameTags game_tags, char *pgn_string, char *error_message);
 void ct_graph_from_pgn_file(CtGraph graph, CtGameTags game_tags, FILE * file, CtCommand command, char *error_message);
+void ct_graph_from_pgn_input(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input, CtCommand command, char *error_message);
+void ct_graph_from_pgn_input_resumable(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input, CtPgnCheckpoint checkpoint, int games_between_checkpoints, CtCommand checkpoint_command, CtCommand command, char *error_message);
+void ct_graph_from_pgn_input_filtered(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input, CtGameFilter game_filter, CtCommand command, char *error_message);
+void ct_graph_from_pgn_index(CtGraph graph, CtGameTags game_tags, FILE * file, CtPgnIndex pgn_index, int first_game, int game_count, CtCommand command, char *error_message);
 
 #endif                                /* CT_GRAPH_H */
@@ -30,6 +30,10 @@ void ct_move_stack_reset(CtMoveStack move_stack);
 bool ct_move_stack_is_empty(CtMoveStack move_stack);
 unsigned int ct_move_stack_length(CtMoveStack move_stack);
 
+/* the move at index 0 is the first one pushed -- index must be less than the length */
+CtMove ct_move_stack_get(CtMoveStack move_stack, unsigned int index);
+void ct_move_stack_truncate(CtMoveStack move_stack, unsigned int length);
+
 CtMoveCommand ct_move_stack_push_command(CtMoveStack move_stack);
 void ct_move_stack_for_each(CtMoveStack move_stack, CtMoveCommand move_command);
 
@@ -0,0 +1,50 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_MOVE_TREE_H
+#define CT_MOVE_TREE_H
+
+#include "ct_types.h"
+
+enum
+{
+  MOVE_TREE_ROOT = 0,                /* the node for the starting position, which has no move */
+  MOVE_TREE_NONE = -1
+};
+
+/* A move tree holds a game with its variations.  Nodes are numbered in the order they are added, and each has a move,
+   a parent, a first child and a next sibling.  The first child of a node continues its line, and the siblings that
+   follow are the variations.  Nodes are kept in one block of memory and never move in the numbering, so they can be
+   referred to by number while the tree grows. */
+CtMoveTree ct_move_tree_new(void);
+void ct_move_tree_free(CtMoveTree move_tree);
+
+void ct_move_tree_reset(CtMoveTree move_tree);
+int ct_move_tree_add(CtMoveTree move_tree, int parent, CtMove move);
+
+int ct_move_tree_node_count(CtMoveTree move_tree);
+CtMove ct_move_tree_move(CtMoveTree move_tree, int node);
+int ct_move_tree_parent(CtMoveTree move_tree, int node);
+int ct_move_tree_first_child(CtMoveTree move_tree, int node);
+int ct_move_tree_next_sibling(CtMoveTree move_tree, int node);
+
+/* each move is made in the graph (which must be at the starting position) before the command is executed, and the
+   node being visited can be found with ct_move_tree_visited_node */
+void ct_move_tree_for_each_move(CtMoveTree move_tree, CtGraph graph, CtMoveCommand move_command);
+int ct_move_tree_visited_node(CtMoveTree move_tree);
+
+#endif                                /* CT_MOVE_TREE_H */
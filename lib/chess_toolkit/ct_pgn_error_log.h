@@ -0,0 +1,40 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_PGN_ERROR_LOG_H
+#define CT_PGN_ERROR_LOG_H
+
+#include "ct_types.h"
+
+/* A PGN error log is attached to a PGN input to decide what happens when a game cannot be parsed.  With
+   PGN_ERROR_ABORT, reading stops at the first error, just as it does without a log.  With PGN_ERROR_SKIP_GAME, the
+   game is skipped and counted, and reading continues with the next game.  PGN_ERROR_COLLECT also keeps the number of
+   each skipped game (counting from 0, including the skipped games) and a description of its error. */
+CtPgnErrorLog ct_pgn_error_log_new(CtPgnErrorPolicy policy);
+void ct_pgn_error_log_free(CtPgnErrorLog pgn_error_log);
+
+void ct_pgn_error_log_reset(CtPgnErrorLog pgn_error_log);
+void ct_pgn_error_log_add(CtPgnErrorLog pgn_error_log, int game, char *message);
+
+CtPgnErrorPolicy ct_pgn_error_log_policy(CtPgnErrorLog pgn_error_log);
+int ct_pgn_error_log_count(CtPgnErrorLog pgn_error_log);
+
+/* only available with PGN_ERROR_COLLECT, for index from 0 to ct_pgn_error_log_count - 1 */
+int ct_pgn_error_log_game(CtPgnErrorLog pgn_error_log, int index);
+char *ct_pgn_error_log_message(CtPgnErrorLog pgn_error_log, int index);
+
+#endif                                /* CT_PGN_ERROR_LOG_H */
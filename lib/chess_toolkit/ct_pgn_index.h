@@ -0,0 +1,44 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_PGN_INDEX_H
+#define CT_PGN_INDEX_H
+
+#include "ct_types.h"
+#include <stdio.h>                /* need to define FILE */
+
+/* A PGN index records where each game of an uncompressed PGN file starts, how many bytes long it is, and a hash of its
+   tags, so that any game can be read without reading the games before it.  Games are numbered from 0. */
+CtPgnIndex ct_pgn_index_new(void);
+void ct_pgn_index_free(CtPgnIndex pgn_index);
+
+void ct_pgn_index_reset(CtPgnIndex pgn_index);
+void ct_pgn_index_add(CtPgnIndex pgn_index, int64_t offset, int64_t length, uint64_t header_hash);
+
+int ct_pgn_index_game_count(CtPgnIndex pgn_index);
+int64_t ct_pgn_index_offset(CtPgnIndex pgn_index, int game);
+int64_t ct_pgn_index_length(CtPgnIndex pgn_index, int game);
+uint64_t ct_pgn_index_header_hash(CtPgnIndex pgn_index, int game);
+
+/* the index is saved in a small binary sidecar file */
+bool ct_pgn_index_to_file(CtPgnIndex pgn_index, FILE * file);
+CtPgnIndex ct_pgn_index_from_file(CtPgnIndex pgn_index, FILE * file);
+
+/* ct_pgn_index_from_pgn_file is defined in ct_graph_from_pgn.c */
+CtPgnIndex ct_pgn_index_from_pgn_file(CtPgnIndex pgn_index, FILE * pgn_file, char *error_message);
+
+#endif                                /* CT_PGN_INDEX_H */
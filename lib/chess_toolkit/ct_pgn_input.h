@@ -0,0 +1,53 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_PGN_INPUT_H
+#define CT_PGN_INPUT_H
+
+#include "ct_types.h"
+#include <stdio.h>                /* need to define FILE */
+
+/* A PGN input reads PGN text from a file that may be compressed with gzip, bzip2 or zstd.  The format is detected
+   from the first bytes of the file.  Compressed files are decompressed on a separate thread, which stays one block
+   ahead of the reader. */
+CtPgnInput ct_pgn_input_new(FILE * file);
+void ct_pgn_input_free(CtPgnInput pgn_input);
+
+int ct_pgn_input_read(CtPgnInput pgn_input, char *destination, int max_length);
+bool ct_pgn_input_skip(CtPgnInput pgn_input, int64_t length);
+
+/* an uncompressed file can be followed while it is being written, so reading waits for more instead of ending */
+bool ct_pgn_input_follow(CtPgnInput pgn_input, int idle_milliseconds);
+
+/* games that cannot be parsed are handled according to the policy of the error log (reading stops without one) */
+void ct_pgn_input_use_error_log(CtPgnInput pgn_input, CtPgnErrorLog pgn_error_log);
+CtPgnErrorLog ct_pgn_input_error_log(CtPgnInput pgn_input);
+
+/* the clocks and evaluations in the comments of each game are only extracted when there are annotations to hold them */
+void ct_pgn_input_use_game_annotations(CtPgnInput pgn_input, CtGameAnnotations game_annotations);
+CtGameAnnotations ct_pgn_input_game_annotations(CtPgnInput pgn_input);
+
+/* variations are always parsed, but the graph only holds the moves of the game -- a move tree holds the variations */
+void ct_pgn_input_use_move_tree(CtPgnInput pgn_input, CtMoveTree move_tree);
+CtMoveTree ct_pgn_input_move_tree(CtPgnInput pgn_input);
+
+char *ct_pgn_input_format(CtPgnInput pgn_input);
+bool ct_pgn_input_has_error(CtPgnInput pgn_input);
+int64_t ct_pgn_input_bytes_read(CtPgnInput pgn_input);
+double ct_pgn_input_megabytes_per_second(CtPgnInput pgn_input);
+
+#endif                                /* CT_PGN_INPUT_H */
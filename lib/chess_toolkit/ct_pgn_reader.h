@@ -0,0 +1,39 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_PGN_READER_H
+#define CT_PGN_READER_H
+
+#include "ct_types.h"
+
+/* A PGN reader hands out the games of a PGN input one at a time, instead of executing a command for each game.  Each
+   call to ct_pgn_reader_next_game reads the next game into the graph and game tags the reader was opened with, and
+   returns false once there are no more games (or there was an error).  Readers for different inputs can be used side
+   by side, as long as each has its own graph and game tags.
+
+   A reader can follow a PGN file that is still being written (see ct_pgn_input_follow).  The parser and graph carry on
+   from where they stopped each time more of the file is appended, so a game in progress is never read twice, and a
+   move command can be used to see each move as soon as it arrives. */
+
+/* the ct_pgn_reader functions are defined in ct_graph_from_pgn.c */
+CtPgnReader ct_pgn_reader_open(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input);
+bool ct_pgn_reader_next_game(CtPgnReader pgn_reader);
+void ct_pgn_reader_use_move_command(CtPgnReader pgn_reader, CtMoveCommand move_command);
+char *ct_pgn_reader_error_message(CtPgnReader pgn_reader);
+void ct_pgn_reader_close(CtPgnReader pgn_reader);
+
+#endif                                /* CT_PGN_READER_H */
@@ -0,0 +1,34 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_PGN_WRITER_H
+#define CT_PGN_WRITER_H
+
+#include "ct_types.h"
+#include <stdio.h>                /* need to define FILE */
+
+/* A PGN writer is created once per output stream and reused for every game written to it.  Output is collected in a
+   single buffer and written out in large blocks. */
+CtPgnWriter ct_pgn_writer_new(FILE * file);
+CtPgnWriter ct_pgn_writer_new_fd(int fd);
+CtPgnWriter ct_pgn_writer_new_gzip_fd(int fd);        /* returns 0 if the toolkit was built without zlib */
+void ct_pgn_writer_free(CtPgnWriter pgn_writer);
+
+void ct_pgn_writer_write(CtPgnWriter pgn_writer, CtGraph graph, CtGameTags game_tags);
+void ct_pgn_writer_flush(CtPgnWriter pgn_writer);
+
+#endif                                /* CT_PGN_WRITER_H */
@@ -50,6 +50,13 @@ void ct_position_set_castle(CtPosition position, CtCastleRights castle_rights);
 bool ct_position_is_legal(CtPosition position);
 bool ct_position_is_check(CtPosition position);
 CtCastleRights ct_position_can_castle(CtPosition position);
+CtBitBoard ct_position_attackers_to(CtPosition position, CtSquare square);
+CtBitBoard ct_position_pinned(CtPosition position);
+bool ct_position_gives_check(CtPosition position, CtMove move);
+
+/* ct_position_see and ct_position_see_ge are defined in ct_position_see.c -- they count material in centipawns */
+int ct_position_see(CtPosition position, CtMove move);
+bool ct_position_see_ge(CtPosition position, CtMove move, int threshold);
 
 /* ct_position_to_s is defined in ct_position_to_s.c */
 enum
@@ -79,13 +79,19 @@ typedef enum CtPieceColor
 } CtPieceColor;
 
  /* CtPiece = 14 is really the last piece value used, but 7, 8 and 15 are reserved for future use */
- /* 7 and 15 might be used in the future by bit_board for generic white and black pieces respectively */
+ /* 7 and 15 are used by bit_board for all of the white and black pieces respectively */
 enum
 {
   PIECE_MAX_VALUE = 15,
   PIECE_MASK_VALID_BITS = 0xF
 };
 
+enum
+{
+  WHITE_PIECES = 7,
+  BLACK_PIECES = 15
+};
+
 /* Piece values were chosen to simplify the categorization into steper, slider or pawn. */
 enum
 {
@@ -108,6 +114,8 @@ typedef uint64_t CtBitBoard;
 /* CtBitBoardArray has a BitBoard for every piece (including Empty) and is indexed by the piece value */
 typedef CtBitBoard *CtBitBoardArray;
 
+typedef struct CtBitBoardBatchStruct *CtBitBoardBatch;
+
 /* Position related */
 
 typedef struct CtPositionStruct *CtPosition;
@@ -138,11 +146,26 @@ enum
   NULL_MOVE = 0
 };
 
-/* Move Stack, Graph, Game Tags and PGN Reader are all straightforward... abstract data types */
+/* captures include en passant and every promotion, quiet moves are all the others */
+typedef enum CtMoveStage
+{
+  CAPTURE_STAGE, QUIET_STAGE, QUIET_CHECK_STAGE, EVASION_STAGE
+} CtMoveStage;
+
+/* Move Stack, Move Tree, Graph, Game Tags, Game Annotations, Game Filter, PGN Input, PGN Error Log, PGN Index, PGN
+   Reader and PGN Writer are all straightforward... abstract data types */
 
 typedef struct CtMoveStackStruct *CtMoveStack;
+typedef struct CtMoveTreeStruct *CtMoveTree;
 typedef struct CtGraphStruct *CtGraph;
 typedef struct CtGameTagsStruct *CtGameTags;
+typedef struct CtGameAnnotationsStruct *CtGameAnnotations;
+typedef struct CtGameFilterStruct *CtGameFilter;
+typedef struct CtPgnInputStruct *CtPgnInput;
+typedef struct CtPgnErrorLogStruct *CtPgnErrorLog;
+typedef struct CtPgnIndexStruct *CtPgnIndex;
+typedef struct CtPgnReaderStruct *CtPgnReader;
+typedef struct CtPgnWriterStruct *CtPgnWriter;
 
 /* Commands are simply a delegate and a method.  The structure is exposed so they can don't have to be allocated like
    an abstract data type.  There are commands that take no arguments and others that take an argument or two. */
@@ -171,4 +194,35 @@ typedef struct CtPieceCommandStruct
   CtPieceCommandMethod method;
 } CtPieceCommandStruct;
 
+/* A game filter method works like a command, but it answers whether the game with game_tags is wanted. */
+
+typedef bool (*CtGameFilterMethod) (void *delegate, CtGameTags game_tags);
+
+/* A PGN checkpoint marks the boundary between two games of a PGN input: the number of bytes before it, and the number
+   of games before it (which is also the number of the next game, since games are numbered from 0).  The structure is
+   exposed so it can be saved and restored by the caller. */
+
+typedef struct CtPgnCheckpointStruct *CtPgnCheckpoint;
+typedef struct CtPgnCheckpointStruct
+{
+  int64_t offset;
+  int game;
+} CtPgnCheckpointStruct;
+
+/* A PGN error policy decides what reading does when a game cannot be parsed: stop reading (the default), skip the game
+   and count it, or skip the game and keep a description of the error. */
+
+typedef enum CtPgnErrorPolicy
+{
+  PGN_ERROR_ABORT, PGN_ERROR_SKIP_GAME, PGN_ERROR_COLLECT
+} CtPgnErrorPolicy;
+
+/* A CPU level names the kernels chosen for the processor, each level having all the instructions of the ones before:
+   the POPCNT instruction, then AVX2 with BMI1 and BMI2, then AVX-512F. */
+
+typedef enum CtCpuLevel
+{
+  CPU_GENERIC, CPU_POPCNT, CPU_AVX2, CPU_AVX512
+} CtCpuLevel;
+
 #endif                                /* CT_TYPES_H */
@@ -17,26 +17,20 @@
 
 #include <config.h>
 
-void ct_rays_init(void);
-void ct_bit_board_init(void);
+void ct_cpu_init(void);
 void ct_piece_init(void);
 void ct_position_init(void);
-void ct_move_maker_init(void);
 void ct_position_from_fen_init(void);
-void ct_position_hash_init(void);
 void ct_graph_position_init(void);
 void ct_graph_from_pgn_init(void);
 
 void
 chess_toolkit_init(void)
 {
-  ct_rays_init();                /* must initialize rays before initializing bit_board */
-  ct_bit_board_init();
+  ct_cpu_init();
   ct_piece_init();
   ct_position_init();
-  ct_move_maker_init();
   ct_position_from_fen_init();
-  ct_position_hash_init();
   ct_graph_position_init();
   ct_graph_from_pgn_init();
 }
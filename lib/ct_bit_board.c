@@ -17,153 +17,324 @@
 
 #include <config.h>
 #include "ct_bit_board.h"
+#include "ct_cpu_private.h"
 #include "ct_utilities.h"
 #include "ct_square.h"
 #include "ct_piece.h"
-#include "ct_rays.h"
 #include <string.h>
 
 enum
 {
-  SIZE_OF_BIT_BOARD_ARRAY = sizeof(CtBitBoard) * CT_BIT_BOARD_ARRAY_LENGTH,
-  SIZE_OF_BIT_BOARD_ATTACKS = sizeof(CtBitBoard) * NUMBER_OF_SQUARES
+  SIZE_OF_BIT_BOARD_ARRAY = sizeof(CtBitBoard) * CT_BIT_BOARD_ARRAY_LENGTH
 };
 
 static bool ct_bit_board_is_attacked_by_line_piece(CtSquare square, CtBitBoard attackers, CtBitBoard occupied);
-
-static CtBitBoard king_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard knight_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard white_pawn_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard black_pawn_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard queen_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard rook_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard bishop_attacks[NUMBER_OF_SQUARES];
-static CtBitBoard blockers[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES];
-
-static void ct_bit_board_init_clear_all(void);
-static void ct_bit_board_init_pawn_attacks(CtBitBoard * destination, CtDirection queenside, CtDirection kingside, CtRank except_on);
-static void ct_bit_board_init_steper_attacks(CtBitBoard * destination, CtRays rays);
-static void ct_bit_board_init_slider_attacks(CtBitBoard * destination, CtRays rays);
-static void ct_bit_board_init_queen_attacks_from_rook_and_bishop(void);
+static CtBitBoard ct_bit_board_array_line_pieces_aimed_at(CtBitBoardArray bit_board_array, CtSquare square);
+static CtBitBoard ct_bit_board_white_pawns_attack(CtBitBoard pawns);
+static CtBitBoard ct_bit_board_black_pawns_attack(CtBitBoard pawns);
+static CtBitBoard ct_bit_board_steper_attacks(CtBitBoard stepers, const CtBitBoard * attack_table);
+static CtBitBoard ct_bit_board_slider_attacks(CtBitBoard sliders, const CtBitBoard * attack_table, CtBitBoard occupied);
+static CtSquare ct_bit_board_find_first_square_generic(CtBitBoard bit_board);
+static int ct_bit_board_count_squares_generic(CtBitBoard bit_board);
+static CtBitBoard ct_bit_board_line_piece_attacks_generic(CtBitBoard lines, CtBitBoard diagonals, CtBitBoard occupied);
+#ifdef CT_CPU_X86_64
+static CtSquare ct_bit_board_find_first_square_bmi(CtBitBoard bit_board);
+static int ct_bit_board_count_squares_popcnt(CtBitBoard bit_board);
+static CtBitBoard ct_bit_board_line_piece_attacks_avx2(CtBitBoard lines, CtBitBoard diagonals, CtBitBoard occupied);
+#endif
+
+/* the kernels are chosen for the processor by ct_bit_board_select_kernels, and start out as the generic ones */
+static CtSquare (*find_first_square_kernel) (CtBitBoard bit_board) = ct_bit_board_find_first_square_generic;
+static int (*count_squares_kernel) (CtBitBoard bit_board) = ct_bit_board_count_squares_generic;
+static CtBitBoard (*line_piece_attacks_kernel) (CtBitBoard lines, CtBitBoard diagonals, CtBitBoard occupied) =
+  ct_bit_board_line_piece_attacks_generic;
+
+#include "ct_bit_board_tables.h"
 
 void
-ct_bit_board_init(void)
+ct_bit_board_select_kernels(CtCpuLevel level)
 {
-  CtRays rays;
+  find_first_square_kernel = ct_bit_board_find_first_square_generic;
+  count_squares_kernel = ct_bit_board_count_squares_generic;
+  line_piece_attacks_kernel = ct_bit_board_line_piece_attacks_generic;
+#ifdef CT_CPU_X86_64
+  if (level >= CPU_POPCNT)
+    count_squares_kernel = ct_bit_board_count_squares_popcnt;
+  if (level >= CPU_AVX2)
+  {
+    find_first_square_kernel = ct_bit_board_find_first_square_bmi;
+    line_piece_attacks_kernel = ct_bit_board_line_piece_attacks_avx2;
+  }
+#endif
+}
 
-  ct_bit_board_init_clear_all();
+CtSquare
+ct_bit_board_find_first_square(CtBitBoard bit_board)
+{
+  return find_first_square_kernel(bit_board);
+}
+
+int
+ct_bit_board_count_squares(CtBitBoard bit_board)
+{
+  return count_squares_kernel(bit_board);
+}
 
-  ct_bit_board_init_pawn_attacks(white_pawn_attacks, D_SW, D_SE, RANK_1);
-  ct_bit_board_init_pawn_attacks(black_pawn_attacks, D_NW, D_NE, RANK_8);
+CtBitBoard
+ct_bit_board_between(CtSquare from, CtSquare to)
+{
+  return blockers[from][to];
+}
+
+CtBitBoard
+ct_bit_board_line(CtSquare from, CtSquare to)
+{
+  return lines[from][to];
+}
+
+void
+ct_bit_board_array_reset(CtBitBoardArray bit_board_array)
+{
+  memset(bit_board_array, 0, SIZE_OF_BIT_BOARD_ARRAY);
+  bit_board_array[EMPTY] = BITB_FULL;
+}
 
-  rays = ct_rays_new_king();
-  ct_bit_board_init_steper_attacks(king_attacks, rays);
-  ct_rays_free(rays);
+/* the white and black versions are written once, with the color's pieces and pawn attack table as parameters */
+#define CT_BIT_BOARD_ARRAY_IS_ATTACKING(color, COLOR)                                                                 \
+  bool                                                                                                                \
+  ct_bit_board_array_is_##color##_attacking(CtBitBoardArray bit_board_array, CtSquare square)                        \
+  {                                                                                                                   \
+    CtBitBoard attackers;                                                                                             \
+                                                                                                                      \
+    if (king_attacks[square] & bit_board_array[COLOR##_KING])                                                         \
+      return true;                                                                                                    \
+    if (knight_attacks[square] & bit_board_array[COLOR##_KNIGHT])                                                     \
+      return true;                                                                                                    \
+    if (color##_pawn_attacks[square] & bit_board_array[COLOR##_PAWN])                                                 \
+      return true;                                                                                                    \
+    attackers = queen_attacks[square] & bit_board_array[COLOR##_QUEEN];                                               \
+    attackers |= rook_attacks[square] & bit_board_array[COLOR##_ROOK];                                                \
+    attackers |= bishop_attacks[square] & bit_board_array[COLOR##_BISHOP];                                            \
+    return ct_bit_board_is_attacked_by_line_piece(square, attackers, ~bit_board_array[EMPTY]);                        \
+  }
 
-  rays = ct_rays_new_knight();
-  ct_bit_board_init_steper_attacks(knight_attacks, rays);
-  ct_rays_free(rays);
+CT_BIT_BOARD_ARRAY_IS_ATTACKING(white, WHITE)
+CT_BIT_BOARD_ARRAY_IS_ATTACKING(black, BLACK)
 
-  rays = ct_rays_new_rook();
-  ct_bit_board_init_slider_attacks(rook_attacks, rays);
-  ct_rays_free(rays);
+/* a pawn only attacks diagonally, so its moves forward are not included */
+bool
+ct_bit_board_array_is_attacking_from(CtBitBoardArray bit_board_array, CtPiece piece, CtSquare from, CtSquare to)
+{
+  return ct_bit_board_is_attacking_from(piece, from, to, ~bit_board_array[EMPTY]);
+}
 
-  rays = ct_rays_new_bishop();
-  ct_bit_board_init_slider_attacks(bishop_attacks, rays);
-  ct_rays_free(rays);
+/* as ct_bit_board_array_is_attacking_from, with only the pieces in occupied standing in the way */
+bool
+ct_bit_board_is_attacking_from(CtPiece piece, CtSquare from, CtSquare to, CtBitBoard occupied)
+{
+  CtBitBoard from_bit_board = ct_bit_board_make(from);
+  CtBitBoard attacks;
 
-  ct_bit_board_init_queen_attacks_from_rook_and_bishop();
+  switch (piece)
+  {
+  case WHITE_PAWN:
+    return (white_pawn_attacks[to] & from_bit_board) != 0;
+  case BLACK_PAWN:
+    return (black_pawn_attacks[to] & from_bit_board) != 0;
+  case WHITE_KING:
+  case BLACK_KING:
+    return (king_attacks[to] & from_bit_board) != 0;
+  case WHITE_KNIGHT:
+  case BLACK_KNIGHT:
+    return (knight_attacks[to] & from_bit_board) != 0;
+  case WHITE_QUEEN:
+  case BLACK_QUEEN:
+    attacks = queen_attacks[to];
+    break;
+  case WHITE_ROOK:
+  case BLACK_ROOK:
+    attacks = rook_attacks[to];
+    break;
+  case WHITE_BISHOP:
+  case BLACK_BISHOP:
+    attacks = bishop_attacks[to];
+    break;
+  default:
+    return false;
+  }
+  return (attacks & from_bit_board) != 0 && (blockers[from][to] & occupied) == 0;
 }
 
-static void
-ct_bit_board_init_clear_all(void)
+/* only pieces in occupied are attackers, and only pieces in occupied block -- a piece can be taken out of an exchange
+   by clearing its bit */
+CtBitBoard
+ct_bit_board_array_attackers_to(CtBitBoardArray bit_board_array, CtSquare square, CtBitBoard occupied)
 {
-  CtBitBoard *bit_board_attacks_array[] = {
-    king_attacks, knight_attacks, white_pawn_attacks, black_pawn_attacks, queen_attacks, rook_attacks, 0
-  };
-  CtBitBoard **bit_board_attacks = bit_board_attacks_array;
+  CtBitBoard attackers, line_pieces;
+  CtSquare from;
 
-  while (*bit_board_attacks != 0)
-    memset(*bit_board_attacks++, 0, SIZE_OF_BIT_BOARD_ATTACKS);
-  memset(blockers, 0, sizeof(blockers));
+  attackers = king_attacks[square] & (bit_board_array[WHITE_KING] | bit_board_array[BLACK_KING]);
+  attackers |= knight_attacks[square] & (bit_board_array[WHITE_KNIGHT] | bit_board_array[BLACK_KNIGHT]);
+  attackers |= white_pawn_attacks[square] & bit_board_array[WHITE_PAWN];
+  attackers |= black_pawn_attacks[square] & bit_board_array[BLACK_PAWN];
+  line_pieces = ct_bit_board_array_line_pieces_aimed_at(bit_board_array, square) & occupied;
+  while (line_pieces)
+  {
+    from = ct_bit_board_find_first_square(line_pieces);
+    line_pieces &= line_pieces - 1;
+    if ((blockers[from][square] & occupied) == 0)
+      attackers |= ct_bit_board_make(from);
+  }
+  return attackers & occupied;
 }
 
-static void
-ct_bit_board_init_pawn_attacks(CtBitBoard * destination, CtDirection queenside, CtDirection kingside, CtRank except_on)
+/* the queens, rooks and bishops that would attack square if the one piece standing in their way were gone */
+CtBitBoard
+ct_bit_board_array_x_ray_attackers_to(CtBitBoardArray bit_board_array, CtSquare square, CtBitBoard occupied)
 {
-  CtBitBoard *bit_board_ptr;
+  CtBitBoard x_ray_attackers = BITB_EMPTY;
+  CtBitBoard line_pieces = ct_bit_board_array_line_pieces_aimed_at(bit_board_array, square) & occupied;
+  CtBitBoard in_the_way;
   CtSquare from;
 
-  bit_board_ptr = destination;
-  for (from = 0; from < NUMBER_OF_SQUARES; from++, bit_board_ptr++)
+  while (line_pieces)
   {
-    if (ct_square_rank(from) != except_on)
-    {
-      if (ct_square_file(from) != FILE_A)
-        *bit_board_ptr |= ct_bit_board_make(from + queenside);
-      if (ct_square_file(from) < LAST_FILE)
-        *bit_board_ptr |= ct_bit_board_make(from + kingside);
-    }
+    from = ct_bit_board_find_first_square(line_pieces);
+    line_pieces &= line_pieces - 1;
+    in_the_way = blockers[from][square] & occupied;
+    if (in_the_way != 0 && (in_the_way & (in_the_way - 1)) == 0)
+      x_ray_attackers |= ct_bit_board_make(from);
   }
+  return x_ray_attackers;
 }
 
-static void
-ct_bit_board_init_steper_attacks(CtBitBoard * destination, CtRays rays)
+/* the pieces of color that stand alone between square and an enemy queen, rook or bishop on the same line */
+CtBitBoard
+ct_bit_board_array_pinned(CtBitBoardArray bit_board_array, CtSquare square, CtPieceColor color)
 {
-  CtBitBoard *bit_board_ptr;
+  CtPieceColor enemy = color ^ COLOR_BIT;
+  CtBitBoard occupied = ~bit_board_array[EMPTY];
+  CtBitBoard pinned = BITB_EMPTY;
+  CtBitBoard pinners, in_the_way;
   CtSquare from;
-  CtDirection direction;
 
-  bit_board_ptr = destination;
-  for (from = 0; from < NUMBER_OF_SQUARES; from++, bit_board_ptr++)
+  pinners = rook_attacks[square] & (bit_board_array[enemy | WHITE_QUEEN] | bit_board_array[enemy | WHITE_ROOK]);
+  pinners |= bishop_attacks[square] & (bit_board_array[enemy | WHITE_QUEEN] | bit_board_array[enemy | WHITE_BISHOP]);
+  while (pinners)
+  {
+    from = ct_bit_board_find_first_square(pinners);
+    pinners &= pinners - 1;
+    in_the_way = blockers[from][square] & occupied;
+    if ((in_the_way & (in_the_way - 1)) == 0)
+      pinned |= in_the_way;
+  }
+  return pinned & bit_board_array[color | WHITE_PIECES];
+}
+
+/* every square attacked by a color, whether or not it holds a piece of that color */
+#define CT_BIT_BOARD_ARRAY_ATTACKS(color, COLOR)                                                                      \
+  CtBitBoard                                                                                                          \
+  ct_bit_board_array_##color##_attacks(CtBitBoardArray bit_board_array)                                              \
+  {                                                                                                                   \
+    CtBitBoard occupied = ~bit_board_array[EMPTY];                                                                    \
+    CtBitBoard queens = bit_board_array[COLOR##_QUEEN];                                                               \
+    CtBitBoard attacks;                                                                                               \
+                                                                                                                      \
+    attacks = ct_bit_board_##color##_pawns_attack(bit_board_array[COLOR##_PAWN]);                                     \
+    attacks |= ct_bit_board_steper_attacks(bit_board_array[COLOR##_KING], king_attacks);                              \
+    attacks |= ct_bit_board_steper_attacks(bit_board_array[COLOR##_KNIGHT], knight_attacks);                          \
+    attacks |= line_piece_attacks_kernel(queens | bit_board_array[COLOR##_ROOK],                                      \
+                                         queens | bit_board_array[COLOR##_BISHOP], occupied);                         \
+    return attacks;                                                                                                   \
+  }
+
+CT_BIT_BOARD_ARRAY_ATTACKS(white, WHITE)
+CT_BIT_BOARD_ARRAY_ATTACKS(black, BLACK)
+
+static CtBitBoard
+ct_bit_board_array_line_pieces_aimed_at(CtBitBoardArray bit_board_array, CtSquare square)
+{
+  CtBitBoard queens = bit_board_array[WHITE_QUEEN] | bit_board_array[BLACK_QUEEN];
+  CtBitBoard rooks = bit_board_array[WHITE_ROOK] | bit_board_array[BLACK_ROOK];
+  CtBitBoard bishops = bit_board_array[WHITE_BISHOP] | bit_board_array[BLACK_BISHOP];
+
+  return (rook_attacks[square] & (queens | rooks)) | (bishop_attacks[square] & (queens | bishops));
+}
+
+static CtBitBoard
+ct_bit_board_white_pawns_attack(CtBitBoard pawns)
+{
+  return ((pawns & ~BITB_FILE_A) << 7) | ((pawns & ~BITB_FILE_H) << 9);
+}
+
+static CtBitBoard
+ct_bit_board_black_pawns_attack(CtBitBoard pawns)
+{
+  return ((pawns & ~BITB_FILE_A) >> 9) | ((pawns & ~BITB_FILE_H) >> 7);
+}
+
+static CtBitBoard
+ct_bit_board_steper_attacks(CtBitBoard stepers, const CtBitBoard * attack_table)
+{
+  CtBitBoard attacks = BITB_EMPTY;
+
+  while (stepers)
   {
-    ct_rays_from(rays, from);
-    while (direction = ct_rays_next_direction(rays))
-      *bit_board_ptr |= ct_bit_board_make(from + direction);
+    attacks |= attack_table[ct_bit_board_find_first_square(stepers)];
+    stepers &= stepers - 1;
   }
+  return attacks;
 }
 
-static void
-ct_bit_board_init_slider_attacks(CtBitBoard * destination, CtRays rays)
+/* a slider attacks each square of its table entry that has no piece between it and the slider */
+static CtBitBoard
+ct_bit_board_slider_attacks(CtBitBoard sliders, const CtBitBoard * attack_table, CtBitBoard occupied)
 {
-  CtBitBoard *bit_board_ptr;
-  CtBitBoard next_blockers;
+  CtBitBoard attacks = BITB_EMPTY;
+  CtBitBoard targets;
   CtSquare from, to;
-  CtDirection direction;
 
-  bit_board_ptr = destination;
-  for (from = 0; from < NUMBER_OF_SQUARES; from++, bit_board_ptr++)
+  while (sliders)
   {
-    ct_rays_from(rays, from);
-    while (direction = ct_rays_next_direction(rays))
+    from = ct_bit_board_find_first_square(sliders);
+    sliders &= sliders - 1;
+    targets = attack_table[from];
+    while (targets)
     {
-      to = from;
-      next_blockers = BITB_EMPTY;
-      do
-      {
-        to += direction;
-        *bit_board_ptr |= ct_bit_board_make(to);
-        blockers[from][to] |= next_blockers;
-        next_blockers |= ct_bit_board_make(to);
-      } while (ct_rays_can_continue_through(rays, to));
+      to = ct_bit_board_find_first_square(targets);
+      targets &= targets - 1;
+      if ((blockers[from][to] & occupied) == 0)
+        attacks |= ct_bit_board_make(to);
     }
   }
+  return attacks;
 }
 
-static void
-ct_bit_board_init_queen_attacks_from_rook_and_bishop(void)
+static bool
+ct_bit_board_is_attacked_by_line_piece(CtSquare square, CtBitBoard attackers, CtBitBoard occupied)
 {
-  CtBitBoard *bit_board_ptr;
-  CtSquare from;
+  CtSquare attacking_from;
 
-  bit_board_ptr = queen_attacks;
-  for (from = 0; from < NUMBER_OF_SQUARES; from++, bit_board_ptr++)
-    *bit_board_ptr = rook_attacks[from] | bishop_attacks[from];
+  while (attackers)
+  {
+    attacking_from = ct_bit_board_find_first_square(attackers);
+    attackers &= attackers - 1;
+    if ((blockers[attacking_from][square] & occupied) == 0)
+      return true;
+  }
+  return false;
 }
 
-CtSquare
-ct_bit_board_find_first_square(CtBitBoard bit_board)
+/* counting the trailing zeros is a single instruction on most processors, which matters because every loop over the
+   squares of a bit board calls this once per square */
+static CtSquare
+ct_bit_board_find_first_square_generic(CtBitBoard bit_board)
 {
+#ifdef __GNUC__
+  if (bit_board)
+    return __builtin_ctzll(bit_board);
+  return SQUARE_NOT_FOUND;        /* no bit found */
+#else
   int result;
 
   result = ffsl((long) bit_board);
@@ -173,66 +344,92 @@ ct_bit_board_find_first_square(CtBitBoard bit_board)
   if (result)
     return result + 31;
   return SQUARE_NOT_FOUND;        /* no bit found */
+#endif
 }
 
-void
-ct_bit_board_array_reset(CtBitBoardArray bit_board_array)
+static int
+ct_bit_board_count_squares_generic(CtBitBoard bit_board)
 {
-  memset(bit_board_array, 0, SIZE_OF_BIT_BOARD_ARRAY);
-  bit_board_array[EMPTY] = BITB_FULL;
+#ifdef __GNUC__
+  return __builtin_popcountll(bit_board);
+#else
+  int count = 0;
+
+  while (bit_board)
+  {
+    bit_board &= bit_board - 1;
+    count++;
+  }
+  return count;
+#endif
 }
 
-bool
-ct_bit_board_array_is_white_attacking(CtBitBoardArray bit_board_array, CtSquare square)
+static CtBitBoard
+ct_bit_board_line_piece_attacks_generic(CtBitBoard lines, CtBitBoard diagonals, CtBitBoard occupied)
 {
-  CtBitBoard attackers;
-
-  if (king_attacks[square] & bit_board_array[WHITE_KING])
-    return true;
-  if (knight_attacks[square] & bit_board_array[WHITE_KNIGHT])
-    return true;
-  if (white_pawn_attacks[square] & bit_board_array[WHITE_PAWN])
-    return true;
-  attackers = queen_attacks[square] & bit_board_array[WHITE_QUEEN];
-  attackers |= rook_attacks[square] & bit_board_array[WHITE_ROOK];
-  attackers |= bishop_attacks[square] & bit_board_array[WHITE_BISHOP];
-  return ct_bit_board_is_attacked_by_line_piece(square, attackers, ~bit_board_array[EMPTY]);
+  return ct_bit_board_slider_attacks(lines, rook_attacks, occupied)
+    | ct_bit_board_slider_attacks(diagonals, bishop_attacks, occupied);
 }
 
-bool
-ct_bit_board_array_is_black_attacking(CtBitBoardArray bit_board_array, CtSquare square)
+#ifdef CT_CPU_X86_64
+/* tzcnt gives 64 for an empty bit board instead of leaving the result undefined */
+static CT_TARGET_AVX2 CtSquare
+ct_bit_board_find_first_square_bmi(CtBitBoard bit_board)
 {
-  CtBitBoard attackers;
+  CtSquare square = _tzcnt_u64(bit_board);
 
-  if (king_attacks[square] & bit_board_array[BLACK_KING])
-    return true;
-  if (knight_attacks[square] & bit_board_array[BLACK_KNIGHT])
-    return true;
-  if (black_pawn_attacks[square] & bit_board_array[BLACK_PAWN])
-    return true;
-  attackers = queen_attacks[square] & bit_board_array[BLACK_QUEEN];
-  attackers |= rook_attacks[square] & bit_board_array[BLACK_ROOK];
-  attackers |= bishop_attacks[square] & bit_board_array[BLACK_BISHOP];
-  return ct_bit_board_is_attacked_by_line_piece(square, attackers, ~bit_board_array[EMPTY]);
+  return square < NUMBER_OF_SQUARES ? square : SQUARE_NOT_FOUND;
 }
 
-static bool
-ct_bit_board_is_attacked_by_line_piece(CtSquare square, CtBitBoard attackers, CtBitBoard occupied)
+static CT_TARGET_POPCNT int
+ct_bit_board_count_squares_popcnt(CtBitBoard bit_board)
 {
-  if (attackers)
-  {
-    CtSquare attacking_from = 0;
+  return __builtin_popcountll(bit_board);
+}
 
-    do
+/* A Kogge-Stone fill in each of the four lanes follows one direction at once -- north, east, northeast and northwest
+   going up the board, south, west, southeast and southwest going down -- with three shifts of 1, 2 and 4 steps
+   reaching the edge.  The wrap masks clear the squares a step along a rank would wrap around to. */
+static CT_TARGET_AVX2 CtBitBoard
+ct_bit_board_line_piece_attacks_avx2(CtBitBoard lines, CtBitBoard diagonals, CtBitBoard occupied)
+{
+  const long long full = (long long) BITB_FULL;
+  const long long not_a = (long long) ~BITB_FILE_A;
+  const long long not_h = (long long) ~BITB_FILE_H;
+  __m256i pieces = _mm256_set_epi64x((long long) diagonals, (long long) diagonals, (long long) lines,
+                                     (long long) lines);
+  __m256i shifts[2], wraps[2];
+  __m256i empty, generator, shift, attacks = _mm256_setzero_si256();
+  __m128i half;
+  int side, step;
+
+  shifts[0] = _mm256_set_epi64x(7, 9, 1, 8);
+  wraps[0] = _mm256_set_epi64x(not_h, not_a, not_a, full);
+  shifts[1] = _mm256_set_epi64x(9, 7, 1, 8);
+  wraps[1] = _mm256_set_epi64x(not_h, not_a, not_h, full);
+  for (side = 0; side < 2; side++)
+  {
+    generator = pieces;
+    empty = _mm256_andnot_si256(_mm256_set1_epi64x((long long) occupied), wraps[side]);
+    shift = shifts[side];
+    for (step = 0; step < 3; step++)
     {
-      if (attackers & 1)
+      if (side == 0)
       {
-        if ((blockers[attacking_from][square] & occupied) == 0)
-          return true;
+        generator = _mm256_or_si256(generator, _mm256_and_si256(empty, _mm256_sllv_epi64(generator, shift)));
+        empty = _mm256_and_si256(empty, _mm256_sllv_epi64(empty, shift));
       }
-      attacking_from++;
+      else
+      {
+        generator = _mm256_or_si256(generator, _mm256_and_si256(empty, _mm256_srlv_epi64(generator, shift)));
+        empty = _mm256_and_si256(empty, _mm256_srlv_epi64(empty, shift));
+      }
+      shift = _mm256_add_epi64(shift, shift);
     }
-    while (attackers >>= 1);
+    generator = side == 0 ? _mm256_sllv_epi64(generator, shifts[0]) : _mm256_srlv_epi64(generator, shifts[1]);
+    attacks = _mm256_or_si256(attacks, _mm256_and_si256(generator, wraps[side]));
   }
-  return false;
+  half = _mm_or_si128(_mm256_castsi256_si128(attacks), _mm256_extracti128_si256(attacks, 1));
+  return (CtBitBoard) (_mm_cvtsi128_si64(half) | _mm_extract_epi64(half, 1));
 }
+#endif
@@ -0,0 +1,331 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_bit_board_batch.h"
+#include "ct_bit_board.h"
+#include "ct_cpu_private.h"
+#include "ct_position_private.h"
+#include "ct_utilities.h"
+
+enum
+{
+  BATCH_INITIAL_CAPACITY = 64,
+  RESULT_WORD_BITS = 64
+};
+
+#define BITB_NOT_FILE_A (~BITB_FILE_A)
+#define BITB_NOT_FILE_H (~BITB_FILE_H)
+#define BITB_NOT_FILES_AB (~(BITB_FILE_A | BITB_FILE_A << 1))
+#define BITB_NOT_FILES_GH (~(BITB_FILE_H | BITB_FILE_H >> 1))
+
+typedef struct CtBitBoardBatchStruct
+{
+  int count;
+  int capacity;
+  CtBitBoard *columns[CT_BIT_BOARD_ARRAY_LENGTH];
+  CtBitBoard *white_to_move;        /* BITB_FULL where white has the move, so black is the side that could check */
+} CtBitBoardBatchStruct;
+
+/* A kernel writes to attacks[index - first] the squares attacked in each position from first to last by the side
+   chosen by black_sides[index], or by black_side when black_sides is null: white where the mask is empty and black
+   where it is full. */
+typedef void (*CtBitBoardBatchKernel) (CtBitBoardBatch batch, const CtBitBoard *black_sides, CtBitBoard black_side,
+                                       int first, int last, CtBitBoard *attacks);
+
+static void ct_bit_board_batch_attacks_scalar(CtBitBoardBatch batch, const CtBitBoard *black_sides,
+                                              CtBitBoard black_side, int first, int last, CtBitBoard *attacks);
+
+/* chosen for the processor by ct_bit_board_batch_select_kernels */
+static CtBitBoardBatchKernel attacks_kernel = ct_bit_board_batch_attacks_scalar;
+
+CtBitBoardBatch
+ct_bit_board_batch_new(void)
+{
+  CtBitBoardBatch batch;
+  int piece;
+
+  batch = ct_malloc(sizeof(CtBitBoardBatchStruct));
+  batch->capacity = BATCH_INITIAL_CAPACITY;
+  for (piece = 0; piece < CT_BIT_BOARD_ARRAY_LENGTH; piece++)
+    batch->columns[piece] = ct_malloc(batch->capacity * sizeof(CtBitBoard));
+  batch->white_to_move = ct_malloc(batch->capacity * sizeof(CtBitBoard));
+  ct_bit_board_batch_reset(batch);
+  return batch;
+}
+
+void
+ct_bit_board_batch_free(CtBitBoardBatch batch)
+{
+  int piece;
+
+  for (piece = 0; piece < CT_BIT_BOARD_ARRAY_LENGTH; piece++)
+    ct_free(batch->columns[piece]);
+  ct_free(batch->white_to_move);
+  ct_free(batch);
+}
+
+void
+ct_bit_board_batch_reset(CtBitBoardBatch batch)
+{
+  batch->count = 0;
+}
+
+int
+ct_bit_board_batch_add(CtBitBoardBatch batch, CtPosition position)
+{
+  int piece;
+
+  if (batch->count == batch->capacity)
+  {
+    batch->capacity *= 2;
+    for (piece = 0; piece < CT_BIT_BOARD_ARRAY_LENGTH; piece++)
+      batch->columns[piece] = ct_realloc(batch->columns[piece], batch->capacity * sizeof(CtBitBoard));
+    batch->white_to_move = ct_realloc(batch->white_to_move, batch->capacity * sizeof(CtBitBoard));
+  }
+  for (piece = 0; piece < CT_BIT_BOARD_ARRAY_LENGTH; piece++)
+    batch->columns[piece][batch->count] = position->bit_board_array[piece];
+  batch->white_to_move[batch->count] = position->is_white_to_move ? BITB_FULL : BITB_EMPTY;
+  return batch->count++;
+}
+
+int
+ct_bit_board_batch_count(CtBitBoardBatch batch)
+{
+  return batch->count;
+}
+
+int
+ct_bit_board_batch_result_words(CtBitBoardBatch batch)
+{
+  return (batch->count + RESULT_WORD_BITS - 1) / RESULT_WORD_BITS;
+}
+
+CtBitBoard *
+ct_bit_board_batch_column(CtBitBoardBatch batch, CtPiece piece)
+{
+  return batch->columns[piece & PIECE_MASK_VALID_BITS];
+}
+
+void
+ct_bit_board_batch_attacks(CtBitBoardBatch batch, CtPieceColor color, CtBitBoard *attacks)
+{
+  attacks_kernel(batch, 0, color == BLACK_PIECE ? BITB_FULL : BITB_EMPTY, 0, batch->count, attacks);
+}
+
+/* the squares attacked that do not hold a piece of color */
+void
+ct_bit_board_batch_mobility(CtBitBoardBatch batch, CtPieceColor color, int *mobility)
+{
+  CtBitBoard *own_pieces = batch->columns[color | WHITE_PIECES];
+  CtBitBoard attacks[RESULT_WORD_BITS];
+  int first, last, index;
+
+  for (first = 0; first < batch->count; first = last)
+  {
+    last = first + RESULT_WORD_BITS < batch->count ? first + RESULT_WORD_BITS : batch->count;
+    attacks_kernel(batch, 0, color == BLACK_PIECE ? BITB_FULL : BITB_EMPTY, first, last, attacks);
+    for (index = first; index < last; index++)
+      mobility[index] = ct_bit_board_count_squares(attacks[index - first] & ~own_pieces[index]);
+  }
+}
+
+void
+ct_bit_board_batch_is_attacked(CtBitBoardBatch batch, CtPieceColor color, CtSquare square, uint64_t *result)
+{
+  CtBitBoard attacks[RESULT_WORD_BITS];
+  int first, last, index;
+  uint64_t word;
+
+  for (first = 0; first < batch->count; first = last)
+  {
+    last = first + RESULT_WORD_BITS < batch->count ? first + RESULT_WORD_BITS : batch->count;
+    attacks_kernel(batch, 0, color == BLACK_PIECE ? BITB_FULL : BITB_EMPTY, first, last, attacks);
+    word = 0;
+    for (index = first; index < last; index++)
+      word |= ((attacks[index - first] >> square) & 1) << (index - first);
+    result[first / RESULT_WORD_BITS] = word;
+  }
+}
+
+/* the side to move is in check where the other side attacks its king */
+void
+ct_bit_board_batch_is_check(CtBitBoardBatch batch, uint64_t *result)
+{
+  CtBitBoard *white_kings = batch->columns[WHITE_KING];
+  CtBitBoard *black_kings = batch->columns[BLACK_KING];
+  CtBitBoard *white_to_move = batch->white_to_move;
+  CtBitBoard attacks[RESULT_WORD_BITS];
+  CtBitBoard king;
+  int first, last, index;
+  uint64_t word;
+
+  for (first = 0; first < batch->count; first = last)
+  {
+    last = first + RESULT_WORD_BITS < batch->count ? first + RESULT_WORD_BITS : batch->count;
+    attacks_kernel(batch, white_to_move, BITB_EMPTY, first, last, attacks);
+    word = 0;
+    for (index = first; index < last; index++)
+    {
+      king = (white_kings[index] & white_to_move[index]) | (black_kings[index] & ~white_to_move[index]);
+      word |= (uint64_t) ((attacks[index - first] & king) != 0) << (index - first);
+    }
+    result[first / RESULT_WORD_BITS] = word;
+  }
+}
+
+/* The vector types each get the same few operations, and the kernel is written once in terms of them and expanded
+   for each type.  Sliders are filled a whole line at a time with Kogge-Stone shifts -- three shifts of 1, 2 and 4
+   steps reach the edge of the board -- so every lane runs the same instructions whatever its pieces are. */
+#define scalar_load(source) (*(source))
+#define scalar_store(destination, lane) (*(destination) = (lane))
+#define scalar_set(bit_board) ((CtBitBoard) (bit_board))
+#define scalar_and(a, b) ((a) & (b))
+#define scalar_or(a, b) ((a) | (b))
+#define scalar_and_not(a, b) ((a) & ~(b))
+#define scalar_up(a, shift) ((a) << (shift))
+#define scalar_down(a, shift) ((a) >> (shift))
+
+#ifdef CT_CPU_X86_64
+#define avx2_load(source) _mm256_loadu_si256((const __m256i *) (source))
+#define avx2_store(destination, lane) _mm256_storeu_si256((__m256i *) (destination), lane)
+#define avx2_set(bit_board) _mm256_set1_epi64x((long long) (bit_board))
+#define avx2_and(a, b) _mm256_and_si256(a, b)
+#define avx2_or(a, b) _mm256_or_si256(a, b)
+#define avx2_and_not(a, b) _mm256_andnot_si256(b, a)
+#define avx2_up(a, shift) _mm256_slli_epi64(a, shift)
+#define avx2_down(a, shift) _mm256_srli_epi64(a, shift)
+
+#define avx512_load(source) _mm512_loadu_si512(source)
+#define avx512_store(destination, lane) _mm512_storeu_si512(destination, lane)
+#define avx512_set(bit_board) _mm512_set1_epi64((long long) (bit_board))
+#define avx512_and(a, b) _mm512_and_si512(a, b)
+#define avx512_or(a, b) _mm512_or_si512(a, b)
+#define avx512_and_not(a, b) _mm512_andnot_si512(b, a)
+#define avx512_up(a, shift) _mm512_slli_epi64(a, shift)
+#define avx512_down(a, shift) _mm512_srli_epi64(a, shift)
+#endif
+
+/* fill_up and fill_down return the squares each piece of generator attacks in the direction shift steps toward h8 or
+   a1, wrap clearing the squares a step along a rank would wrap around to */
+#define CT_BIT_BOARD_BATCH_KERNEL(v, Lane, LANES, TARGET)                                                             \
+  static inline TARGET Lane                                                                                           \
+  v##_fill_up(Lane generator, Lane empty, int shift, Lane wrap)                                                       \
+  {                                                                                                                   \
+    empty = v##_and(empty, wrap);                                                                                     \
+    generator = v##_or(generator, v##_and(empty, v##_up(generator, shift)));                                          \
+    empty = v##_and(empty, v##_up(empty, shift));                                                                     \
+    generator = v##_or(generator, v##_and(empty, v##_up(generator, 2 * shift)));                                      \
+    empty = v##_and(empty, v##_up(empty, 2 * shift));                                                                 \
+    generator = v##_or(generator, v##_and(empty, v##_up(generator, 4 * shift)));                                      \
+    return v##_and(v##_up(generator, shift), wrap);                                                                   \
+  }                                                                                                                   \
+                                                                                                                      \
+  static inline TARGET Lane                                                                                           \
+  v##_fill_down(Lane generator, Lane empty, int shift, Lane wrap)                                                     \
+  {                                                                                                                   \
+    empty = v##_and(empty, wrap);                                                                                     \
+    generator = v##_or(generator, v##_and(empty, v##_down(generator, shift)));                                        \
+    empty = v##_and(empty, v##_down(empty, shift));                                                                   \
+    generator = v##_or(generator, v##_and(empty, v##_down(generator, 2 * shift)));                                    \
+    empty = v##_and(empty, v##_down(empty, 2 * shift));                                                               \
+    generator = v##_or(generator, v##_and(empty, v##_down(generator, 4 * shift)));                                    \
+    return v##_and(v##_down(generator, shift), wrap);                                                                 \
+  }                                                                                                                   \
+                                                                                                                      \
+  /* the white bit boards where black_side is empty and the black ones where it is full */                            \
+  static inline TARGET Lane                                                                                           \
+  v##_side_pieces(CtBitBoardBatch batch, CtPiece white_piece, int index, Lane black_side)                             \
+  {                                                                                                                   \
+    return v##_or(v##_and_not(v##_load(batch->columns[white_piece] + index), black_side),                             \
+                  v##_and(v##_load(batch->columns[white_piece | COLOR_BIT] + index), black_side));                    \
+  }                                                                                                                   \
+                                                                                                                      \
+  static inline TARGET Lane                                                                                           \
+  v##_attacks(CtBitBoardBatch batch, int index, Lane black_side)                                                      \
+  {                                                                                                                   \
+    Lane full = v##_set(BITB_FULL), not_a = v##_set(BITB_NOT_FILE_A), not_h = v##_set(BITB_NOT_FILE_H);               \
+    Lane empty = v##_load(batch->columns[EMPTY] + index);                                                             \
+    Lane pieces, west, east, one_file, two_files, attacks, queens, lines, diagonals;                                  \
+                                                                                                                      \
+    pieces = v##_side_pieces(batch, WHITE_PAWN, index, black_side);                                                   \
+    west = v##_and(pieces, not_a);                                                                                    \
+    east = v##_and(pieces, not_h);                                                                                    \
+    attacks = v##_or(v##_and_not(v##_or(v##_up(west, 7), v##_up(east, 9)), black_side),                               \
+                     v##_and(v##_or(v##_down(west, 9), v##_down(east, 7)), black_side));                              \
+                                                                                                                      \
+    pieces = v##_side_pieces(batch, WHITE_KNIGHT, index, black_side);                                                 \
+    one_file = v##_or(v##_and(v##_down(pieces, 1), not_h), v##_and(v##_up(pieces, 1), not_a));                        \
+    two_files = v##_or(v##_and(v##_down(pieces, 2), v##_set(BITB_NOT_FILES_GH)),                                      \
+                       v##_and(v##_up(pieces, 2), v##_set(BITB_NOT_FILES_AB)));                                       \
+    attacks = v##_or(attacks, v##_or(v##_up(one_file, 16), v##_down(one_file, 16)));                                  \
+    attacks = v##_or(attacks, v##_or(v##_up(two_files, 8), v##_down(two_files, 8)));                                  \
+                                                                                                                      \
+    pieces = v##_side_pieces(batch, WHITE_KING, index, black_side);                                                   \
+    one_file = v##_or(v##_and(v##_down(pieces, 1), not_h), v##_and(v##_up(pieces, 1), not_a));                        \
+    pieces = v##_or(pieces, one_file);                                                                                \
+    attacks = v##_or(attacks, v##_or(one_file, v##_or(v##_up(pieces, 8), v##_down(pieces, 8))));                      \
+                                                                                                                      \
+    queens = v##_side_pieces(batch, WHITE_QUEEN, index, black_side);                                                  \
+    lines = v##_or(queens, v##_side_pieces(batch, WHITE_ROOK, index, black_side));                                    \
+    diagonals = v##_or(queens, v##_side_pieces(batch, WHITE_BISHOP, index, black_side));                              \
+    attacks = v##_or(attacks, v##_fill_up(lines, empty, 8, full));                                                    \
+    attacks = v##_or(attacks, v##_fill_down(lines, empty, 8, full));                                                  \
+    attacks = v##_or(attacks, v##_fill_up(lines, empty, 1, not_a));                                                   \
+    attacks = v##_or(attacks, v##_fill_down(lines, empty, 1, not_h));                                                 \
+    attacks = v##_or(attacks, v##_fill_up(diagonals, empty, 9, not_a));                                               \
+    attacks = v##_or(attacks, v##_fill_up(diagonals, empty, 7, not_h));                                               \
+    attacks = v##_or(attacks, v##_fill_down(diagonals, empty, 7, not_a));                                             \
+    attacks = v##_or(attacks, v##_fill_down(diagonals, empty, 9, not_h));                                             \
+    return attacks;                                                                                                   \
+  }                                                                                                                   \
+                                                                                                                      \
+  /* the positions left over after the last whole vector go through the scalar kernel */                              \
+  static TARGET void                                                                                                  \
+  ct_bit_board_batch_attacks_##v(CtBitBoardBatch batch, const CtBitBoard *black_sides, CtBitBoard black_side,         \
+                                 int first, int last, CtBitBoard *attacks)                                            \
+  {                                                                                                                   \
+    Lane side = v##_set(black_side);                                                                                  \
+    int index;                                                                                                        \
+                                                                                                                      \
+    for (index = first; index + LANES <= last; index += LANES)                                                        \
+    {                                                                                                                 \
+      if (black_sides != 0)                                                                                           \
+        side = v##_load(black_sides + index);                                                                         \
+      v##_store(attacks + (index - first), v##_attacks(batch, index, side));                                          \
+    }                                                                                                                 \
+    if (index < last)                                                                                                 \
+      ct_bit_board_batch_attacks_scalar(batch, black_sides, black_side, index, last, attacks + (index - first));      \
+  }
+
+CT_BIT_BOARD_BATCH_KERNEL(scalar, CtBitBoard, 1, )
+#ifdef CT_CPU_X86_64
+CT_BIT_BOARD_BATCH_KERNEL(avx2, __m256i, 4, CT_TARGET_AVX2)
+CT_BIT_BOARD_BATCH_KERNEL(avx512, __m512i, 8, CT_TARGET_AVX512)
+#endif
+
+void
+ct_bit_board_batch_select_kernels(CtCpuLevel level)
+{
+  attacks_kernel = ct_bit_board_batch_attacks_scalar;
+#ifdef CT_CPU_X86_64
+  if (level >= CPU_AVX512)
+    attacks_kernel = ct_bit_board_batch_attacks_avx512;
+  else if (level >= CPU_AVX2)
+    attacks_kernel = ct_bit_board_batch_attacks_avx2;
+#endif
+}
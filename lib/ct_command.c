@@ -43,8 +43,10 @@ ct_command_make(void *delegate, CtCommandMethod method)
   return result;
 }
 
+/* a command without a method does nothing */
 void
 ct_command_execute(CtCommand command)
 {
-  command->method(command->delegate);
+  if (command->method)
+    command->method(command->delegate);
 }
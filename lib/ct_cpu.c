@@ -0,0 +1,103 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_cpu.h"
+#include "ct_cpu_private.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *level_names[] = { "generic", "popcnt", "avx2", "avx512" };
+
+static CtCpuLevel detected_level = CPU_GENERIC;
+static CtCpuLevel current_level = CPU_GENERIC;
+
+static CtCpuLevel ct_cpu_detect(void);
+static void ct_cpu_select(CtCpuLevel level);
+
+/* called by chess_toolkit_init, before anything else needs a kernel */
+void
+ct_cpu_init(void)
+{
+  char *forced_name = getenv("CT_CPU_LEVEL");
+  CtCpuLevel level;
+
+  detected_level = ct_cpu_detect();
+  ct_cpu_select(detected_level);
+  if (forced_name == 0)
+    return;
+  for (level = CPU_GENERIC; level <= CPU_AVX512; level++)
+    if (strcmp(forced_name, level_names[level]) == 0)
+      ct_cpu_force_level(level);
+}
+
+CtCpuLevel
+ct_cpu_detected_level(void)
+{
+  return detected_level;
+}
+
+CtCpuLevel
+ct_cpu_level(void)
+{
+  return current_level;
+}
+
+const char *
+ct_cpu_level_name(CtCpuLevel level)
+{
+  if (level < CPU_GENERIC || level > CPU_AVX512)
+    return "unknown";
+  return level_names[level];
+}
+
+bool
+ct_cpu_force_level(CtCpuLevel level)
+{
+  if (level < CPU_GENERIC || level > detected_level)
+    return false;
+  ct_cpu_select(level);
+  return true;
+}
+
+/* __builtin_cpu_supports reads CPUID, and for AVX2 and AVX-512 also checks that the operating system saves the wider
+   registers */
+static CtCpuLevel
+ct_cpu_detect(void)
+{
+#ifdef CT_CPU_X86_64
+  __builtin_cpu_init();
+  if (!__builtin_cpu_supports("popcnt"))
+    return CPU_GENERIC;
+  if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("bmi") || !__builtin_cpu_supports("bmi2"))
+    return CPU_POPCNT;
+  if (!__builtin_cpu_supports("avx512f"))
+    return CPU_AVX2;
+  return CPU_AVX512;
+#else
+  return CPU_GENERIC;
+#endif
+}
+
+static void
+ct_cpu_select(CtCpuLevel level)
+{
+  current_level = level;
+  ct_bit_board_select_kernels(level);
+  ct_bit_board_batch_select_kernels(level);
+  ct_utilities_select_kernels(level);
+}
@@ -17,20 +17,95 @@
 
 #include <config.h>
 #include "ct_error.h"
+#include "ct_utilities.h"
 #include <stdio.h>
 #include <stdlib.h>
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+
+enum
+{
+  LAST_ERROR_MAX_LENGTH = 256
+};
+
+typedef struct CtErrorChannelStruct
+{
+  void *delegate;
+  CtErrorChannelMethod method;
+  int count;
+  char last_error[LAST_ERROR_MAX_LENGTH];
+} CtErrorChannelStruct;
 
 static CtErrorHandler _error_handler = 0;
 
+static CtErrorChannel ct_error_current_channel(void);
+static void ct_error_set_current_channel(CtErrorChannel error_channel);
+
+/* each thread has its own current channel -- without threads, there is only one */
+#ifdef HAVE_LIBPTHREAD
+static pthread_key_t channel_key;
+static pthread_once_t channel_key_once = PTHREAD_ONCE_INIT;
+
+static void
+ct_error_create_channel_key(void)
+{
+  pthread_key_create(&channel_key, 0);
+}
+
+static CtErrorChannel
+ct_error_current_channel(void)
+{
+  pthread_once(&channel_key_once, ct_error_create_channel_key);
+  return pthread_getspecific(channel_key);
+}
+
+static void
+ct_error_set_current_channel(CtErrorChannel error_channel)
+{
+  pthread_once(&channel_key_once, ct_error_create_channel_key);
+  pthread_setspecific(channel_key, error_channel);
+}
+#else
+static CtErrorChannel current_channel = 0;
+
+static CtErrorChannel
+ct_error_current_channel(void)
+{
+  return current_channel;
+}
+
+static void
+ct_error_set_current_channel(CtErrorChannel error_channel)
+{
+  current_channel = error_channel;
+}
+#endif
+
 void
 ct_error_set_custom_handler(CtErrorHandler error_handler)
 {
   _error_handler = error_handler;
 }
 
+/* A thread's channel method takes precedence over the custom handler, which is shared by every thread.  A channel
+   without a method records the error and carries on to the handler, since callers such as ct_malloc count on ct_error
+   not returning. */
 void
 ct_error(const char *str)
 {
+  CtErrorChannel error_channel = ct_error_current_channel();
+
+  if (error_channel)
+  {
+    error_channel->count++;
+    snprintf(error_channel->last_error, LAST_ERROR_MAX_LENGTH, "%s", str);
+    if (error_channel->method)
+    {
+      error_channel->method(error_channel->delegate, str);
+      return;
+    }
+  }
   if (_error_handler)
     _error_handler(str);
   else
@@ -39,3 +114,45 @@ ct_error(const char *str)
     exit(-1);
   }
 }
+
+CtErrorChannel
+ct_error_channel_new(void *delegate, CtErrorChannelMethod method)
+{
+  CtErrorChannel error_channel;
+
+  error_channel = ct_malloc(sizeof(CtErrorChannelStruct));
+  error_channel->delegate = delegate;
+  error_channel->method = method;
+  error_channel->count = 0;
+  error_channel->last_error[0] = 0;
+  return error_channel;
+}
+
+void
+ct_error_channel_free(CtErrorChannel error_channel)
+{
+  if (ct_error_current_channel() == error_channel)
+    ct_error_set_current_channel(0);
+  ct_free(error_channel);
+}
+
+CtErrorChannel
+ct_error_use_channel(CtErrorChannel error_channel)
+{
+  CtErrorChannel previous_channel = ct_error_current_channel();
+
+  ct_error_set_current_channel(error_channel);
+  return previous_channel;
+}
+
+int
+ct_error_channel_count(CtErrorChannel error_channel)
+{
+  return error_channel->count;
+}
+
+const char *
+ct_error_channel_last_error(CtErrorChannel error_channel)
+{
+  return error_channel->last_error;
+}
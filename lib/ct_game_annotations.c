@@ -0,0 +1,239 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_game_annotations.h"
+#include "ct_utilities.h"
+#include <string.h>
+
+enum
+{
+  INITIAL_PLIES_SIZE = 256,
+  /* keep absurd values from overflowing when they are scaled to centiseconds or centipawns */
+  MAX_CLOCK_SECONDS = 10000000,
+  MAX_PAWNS = 1000000
+};
+
+typedef struct CtGameAnnotationsStruct
+{
+  int *clocks;
+  int *evals;
+  int ply_count;
+  int plies_size;
+} CtGameAnnotationsStruct;
+
+static void ct_game_annotations_extend(CtGameAnnotations game_annotations, int ply);
+static bool ct_game_annotations_parse_clock(char *text, char *end, int *centiseconds);
+static bool ct_game_annotations_parse_eval(char *text, char *end, int *centipawns);
+static char *ct_game_annotations_parse_number(char *text, char *end, int *number, int *digits);
+static bool ct_game_annotations_is_closed(char *text, char *end);
+
+CtGameAnnotations
+ct_game_annotations_new(void)
+{
+  CtGameAnnotations game_annotations;
+
+  game_annotations = ct_malloc(sizeof(CtGameAnnotationsStruct));
+  game_annotations->clocks = ct_malloc(INITIAL_PLIES_SIZE * sizeof(int));
+  game_annotations->evals = ct_malloc(INITIAL_PLIES_SIZE * sizeof(int));
+  game_annotations->plies_size = INITIAL_PLIES_SIZE;
+  game_annotations->ply_count = 0;
+  return game_annotations;
+}
+
+void
+ct_game_annotations_free(CtGameAnnotations game_annotations)
+{
+  ct_free(game_annotations->clocks);
+  ct_free(game_annotations->evals);
+  ct_free(game_annotations);
+}
+
+void
+ct_game_annotations_reset(CtGameAnnotations game_annotations)
+{
+  game_annotations->ply_count = 0;
+}
+
+/* the comment is read where the scanner found it (it does not need to be null terminated), and only the commands
+   that can be turned into numbers are kept -- anything else in the comment is ignored */
+void
+ct_game_annotations_read_comment(CtGameAnnotations game_annotations, int ply, char *comment, int length)
+{
+  char *end = comment + length;
+  char *command = comment;
+  int value;
+
+  while ((command = memchr(command, '[', end - command)) != 0)
+  {
+    command++;
+    if (end - command > 4 && strncmp(command, "%clk", 4) == 0)
+    {
+      if (ct_game_annotations_parse_clock(command + 4, end, &value))
+      {
+        ct_game_annotations_extend(game_annotations, ply);
+        game_annotations->clocks[ply] = value;
+      }
+    }
+    else if (end - command > 5 && strncmp(command, "%eval", 5) == 0)
+    {
+      if (ct_game_annotations_parse_eval(command + 5, end, &value))
+      {
+        ct_game_annotations_extend(game_annotations, ply);
+        game_annotations->evals[ply] = value;
+      }
+    }
+  }
+}
+
+int
+ct_game_annotations_ply_count(CtGameAnnotations game_annotations)
+{
+  return game_annotations->ply_count;
+}
+
+int *
+ct_game_annotations_clocks(CtGameAnnotations game_annotations)
+{
+  return game_annotations->clocks;
+}
+
+int *
+ct_game_annotations_evals(CtGameAnnotations game_annotations)
+{
+  return game_annotations->evals;
+}
+
+/* plies between the last one annotated and this one are missing both annotations */
+static void
+ct_game_annotations_extend(CtGameAnnotations game_annotations, int ply)
+{
+  while (ply >= game_annotations->plies_size)
+  {
+    game_annotations->plies_size *= 2;
+    game_annotations->clocks = ct_realloc(game_annotations->clocks, game_annotations->plies_size * sizeof(int));
+    game_annotations->evals = ct_realloc(game_annotations->evals, game_annotations->plies_size * sizeof(int));
+  }
+  while (game_annotations->ply_count <= ply)
+  {
+    game_annotations->clocks[game_annotations->ply_count] = GAME_ANNOTATIONS_MISSING;
+    game_annotations->evals[game_annotations->ply_count] = GAME_ANNOTATIONS_MISSING;
+    game_annotations->ply_count++;
+  }
+}
+
+/* a clock is hours, minutes and seconds separated by colons (leading fields can be left out), with an optional
+   fraction of a second, e.g. [%clk 1:05:09.5] */
+static bool
+ct_game_annotations_parse_clock(char *text, char *end, int *centiseconds)
+{
+  int seconds = 0;
+  int field;
+  int digits;
+  int fields = 0;
+
+  while (text < end && *text == ' ')
+    text++;
+  do
+  {
+    if (fields++ > 0)
+      text++;                        /* skip the colon */
+    text = ct_game_annotations_parse_number(text, end, &field, &digits);
+    if (digits == 0 || fields > 3)
+      return false;
+    seconds = seconds * 60 + field;
+    if (seconds > MAX_CLOCK_SECONDS)
+      return false;
+  }
+  while (text < end && *text == ':');
+  *centiseconds = seconds * 100;
+  if (text < end && *text == '.')
+  {
+    text++;
+    if (text < end && *text >= '0' && *text <= '9')
+      *centiseconds += (*text++ - '0') * 10;
+    if (text < end && *text >= '0' && *text <= '9')
+      *centiseconds += *text++ - '0';
+    while (text < end && *text >= '0' && *text <= '9')
+      text++;
+  }
+  return ct_game_annotations_is_closed(text, end);
+}
+
+/* an evaluation is in pawns, e.g. [%eval -0.35], or a mate in a number of moves, e.g. [%eval #-3] for black to mate
+   in 3 -- anything after the number, such as the depth in [%eval 0.17,22], is ignored */
+static bool
+ct_game_annotations_parse_eval(char *text, char *end, int *centipawns)
+{
+  bool is_mate = false;
+  bool is_negative = false;
+  int pawns;
+  int digits;
+
+  while (text < end && *text == ' ')
+    text++;
+  if (text < end && *text == '#')
+  {
+    is_mate = true;
+    text++;
+  }
+  if (text < end && (*text == '-' || *text == '+'))
+    is_negative = *text++ == '-';
+  text = ct_game_annotations_parse_number(text, end, &pawns, &digits);
+  if (digits == 0 || pawns > MAX_PAWNS)
+    return false;
+  if (is_mate)
+    *centipawns = GAME_ANNOTATIONS_MATE - pawns;
+  else
+  {
+    *centipawns = pawns * 100;
+    if (text < end && *text == '.')
+    {
+      text++;
+      if (text < end && *text >= '0' && *text <= '9')
+        *centipawns += (*text++ - '0') * 10;
+      if (text < end && *text >= '0' && *text <= '9')
+        *centipawns += *text++ - '0';
+      if (text < end && *text >= '5' && *text <= '9')
+        (*centipawns)++;        /* rounds to the nearest centipawn */
+    }
+  }
+  if (is_negative)
+    *centipawns = -*centipawns;
+  return memchr(text, ']', end - text) != 0;
+}
+
+static char *
+ct_game_annotations_parse_number(char *text, char *end, int *number, int *digits)
+{
+  *number = 0;
+  *digits = 0;
+  while (text < end && *text >= '0' && *text <= '9' && *digits < 9)
+  {
+    *number = *number * 10 + *text++ - '0';
+    (*digits)++;
+  }
+  return text;
+}
+
+static bool
+ct_game_annotations_is_closed(char *text, char *end)
+{
+  while (text < end && *text == ' ')
+    text++;
+  return text < end && *text == ']';
+}
@@ -0,0 +1,194 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_game_filter.h"
+#include "ct_game_tags.h"
+#include "ct_utilities.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* An empty string (or an Elo of 0) means the criterion is not used. */
+
+typedef struct CtGameFilterStruct
+{
+  int minimum_elo;
+  int maximum_elo;
+  char earliest_date[GAME_TAGS_VALUE_MAX_LENGTH];
+  char latest_date[GAME_TAGS_VALUE_MAX_LENGTH];
+  char player[GAME_TAGS_VALUE_MAX_LENGTH];
+  char first_eco[GAME_TAGS_VALUE_MAX_LENGTH];
+  char last_eco[GAME_TAGS_VALUE_MAX_LENGTH];
+  void *delegate;
+  CtGameFilterMethod method;
+} CtGameFilterStruct;
+
+static void ct_game_filter_copy(char *destination, char *value);
+static bool ct_game_filter_accepts_elo(CtGameFilter game_filter, char *elo);
+static bool ct_game_filter_accepts_date(CtGameFilter game_filter, char *date);
+static int ct_game_filter_compare_dates(char *date, char *other_date);
+
+CtGameFilter
+ct_game_filter_new(void)
+{
+  CtGameFilter game_filter;
+
+  game_filter = ct_malloc(sizeof(CtGameFilterStruct));
+  ct_game_filter_reset(game_filter);
+  return game_filter;
+}
+
+void
+ct_game_filter_free(CtGameFilter game_filter)
+{
+  ct_free(game_filter);
+}
+
+void
+ct_game_filter_reset(CtGameFilter game_filter)
+{
+  game_filter->minimum_elo = 0;
+  game_filter->maximum_elo = 0;
+  game_filter->earliest_date[0] = 0;
+  game_filter->latest_date[0] = 0;
+  game_filter->player[0] = 0;
+  game_filter->first_eco[0] = 0;
+  game_filter->last_eco[0] = 0;
+  game_filter->delegate = 0;
+  game_filter->method = 0;
+}
+
+void
+ct_game_filter_set_elo_range(CtGameFilter game_filter, int minimum, int maximum)
+{
+  game_filter->minimum_elo = minimum;
+  game_filter->maximum_elo = maximum;
+}
+
+void
+ct_game_filter_set_date_range(CtGameFilter game_filter, char *earliest, char *latest)
+{
+  ct_game_filter_copy(game_filter->earliest_date, earliest);
+  ct_game_filter_copy(game_filter->latest_date, latest);
+}
+
+void
+ct_game_filter_set_player(CtGameFilter game_filter, char *player)
+{
+  ct_game_filter_copy(game_filter->player, player);
+}
+
+void
+ct_game_filter_set_eco_range(CtGameFilter game_filter, char *first, char *last)
+{
+  ct_game_filter_copy(game_filter->first_eco, first);
+  ct_game_filter_copy(game_filter->last_eco, last);
+}
+
+void
+ct_game_filter_set_predicate(CtGameFilter game_filter, void *delegate, CtGameFilterMethod method)
+{
+  game_filter->delegate = delegate;
+  game_filter->method = method;
+}
+
+static void
+ct_game_filter_copy(char *destination, char *value)
+{
+  if (value == 0)
+    value = "";
+  strncpy(destination, value, GAME_TAGS_VALUE_MAX_LENGTH - 1);
+  destination[GAME_TAGS_VALUE_MAX_LENGTH - 1] = 0;
+}
+
+/* the cheap string comparisons are made first, and the predicate (which could be anything) is only asked last */
+bool
+ct_game_filter_accepts(CtGameFilter game_filter, CtGameTags game_tags)
+{
+  if (game_filter == 0)
+    return true;
+  if (game_filter->player[0] != 0 && strcmp(ct_game_tags_get(game_tags, "White"), game_filter->player) != 0
+      && strcmp(ct_game_tags_get(game_tags, "Black"), game_filter->player) != 0)
+    return false;
+  if (game_filter->first_eco[0] != 0 || game_filter->last_eco[0] != 0)
+  {
+    char *eco = ct_game_tags_get(game_tags, "ECO");
+
+    if (strcmp(eco, "?") == 0)
+      return false;
+    if (game_filter->first_eco[0] != 0 && strcmp(eco, game_filter->first_eco) < 0)
+      return false;
+    if (game_filter->last_eco[0] != 0 && strcmp(eco, game_filter->last_eco) > 0)
+      return false;
+  }
+  if (!ct_game_filter_accepts_date(game_filter, ct_game_tags_get(game_tags, "Date")))
+    return false;
+  if (!ct_game_filter_accepts_elo(game_filter, ct_game_tags_get(game_tags, "WhiteElo"))
+      || !ct_game_filter_accepts_elo(game_filter, ct_game_tags_get(game_tags, "BlackElo")))
+    return false;
+  if (game_filter->method && !game_filter->method(game_filter->delegate, game_tags))
+    return false;
+  return true;
+}
+
+/* when an Elo range is set, both players need a known Elo within the range */
+static bool
+ct_game_filter_accepts_elo(CtGameFilter game_filter, char *elo)
+{
+  int rating;
+
+  if (game_filter->minimum_elo == 0 && game_filter->maximum_elo == 0)
+    return true;
+  rating = atoi(elo);
+  if (rating <= 0)
+    return false;
+  if (game_filter->minimum_elo != 0 && rating < game_filter->minimum_elo)
+    return false;
+  if (game_filter->maximum_elo != 0 && rating > game_filter->maximum_elo)
+    return false;
+  return true;
+}
+
+static bool
+ct_game_filter_accepts_date(CtGameFilter game_filter, char *date)
+{
+  if (game_filter->earliest_date[0] == 0 && game_filter->latest_date[0] == 0)
+    return true;
+  if (date[0] == '?')
+    return false;
+  if (game_filter->earliest_date[0] != 0 && ct_game_filter_compare_dates(date, game_filter->earliest_date) < 0)
+    return false;
+  if (game_filter->latest_date[0] != 0 && ct_game_filter_compare_dates(date, game_filter->latest_date) > 0)
+    return false;
+  return true;
+}
+
+/* PGN dates are written YYYY.MM.DD, with question marks for unknown digits -- those are compared as if they were 0, so
+   a game from an unknown day of a month falls at the start of that month */
+static int
+ct_game_filter_compare_dates(char *date, char *other_date)
+{
+  for (; *date != 0 && *other_date != 0; date++, other_date++)
+  {
+    char digit = *date == '?' ? '0' : *date;
+    char other_digit = *other_date == '?' ? '0' : *other_date;
+
+    if (digit != other_digit)
+      return digit - other_digit;
+  }
+  return 0;
+}
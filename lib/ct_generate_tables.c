@@ -0,0 +1,430 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* ct_generate_tables writes the constant tables used by the library as C source so that they are computed once
+   at build time instead of every time chess_toolkit_init is called.  It is run by lib/Makefile.am with the name
+   of one table group and prints a header of static const arrays to stdout:
+
+   ct_generate_tables rays            ct_rays_tables.h
+   ct_generate_tables bit_board       ct_bit_board_tables.h
+   ct_generate_tables move_maker      ct_move_maker_tables.h
+   ct_generate_tables position_hash   ct_position_hash_tables.h
+
+   This program is not linked with the library, so it only depends on the enums in ct_types.h.  It is compiled with
+   CC_FOR_BUILD for the machine doing the build, so it does not include config.h, which describes the host. */
+
+#include "ct_types.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum
+{
+  ROOK_MASK = 0x55,
+  BISHOP_MASK = 0xAA,
+  NUMBER_OF_PIECE_KEYS = NUMBER_OF_SQUARES * (PIECE_MAX_VALUE + 1),
+  NUMBER_OF_KEYS = NUMBER_OF_PIECE_KEYS + 2 + 16 + 9,
+  RANDOM_DEGREE = 63,
+  RANDOM_SEPARATION = 1
+};
+
+static const CtDirection adjacent_direction_array[] = {
+  D_N, D_NE, D_E, D_SE, D_S, D_SW, D_W, D_NW
+};
+
+static const CtDirection knight_direction_array[] = {
+  D_NNE, D_ENE, D_ESE, D_SSE, D_SSW, D_WSW, D_WNW, D_NNW
+};
+
+static unsigned char king_directions_available[NUMBER_OF_SQUARES];
+static unsigned char knight_directions_available[NUMBER_OF_SQUARES];
+static unsigned char rook_directions_available[NUMBER_OF_SQUARES];
+static unsigned char bishop_directions_available[NUMBER_OF_SQUARES];
+
+static CtBitBoard king_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard knight_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard white_pawn_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard black_pawn_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard queen_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard rook_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard bishop_attacks[NUMBER_OF_SQUARES];
+static CtBitBoard blockers[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES];
+static CtBitBoard lines[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES];
+
+static uint32_t random_table[RANDOM_DEGREE];
+static int random_front;
+static int random_rear;
+
+static void compute_directions_available(void);
+static void compute_pawn_attacks(CtBitBoard * destination, CtDirection queenside, CtDirection kingside,
+                                 CtRank except_on);
+static void compute_steper_attacks(CtBitBoard * destination, const unsigned char *directions_available,
+                                   const CtDirection * direction_array);
+static void compute_slider_attacks(CtBitBoard * destination, const unsigned char *directions_available);
+static void compute_lines(void);
+static CtBitBoard compute_ray(int from, int index);
+static void print_square_pairs(const char *name, CtBitBoard square_pairs[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES]);
+static void print_header(const char *group);
+static void print_directions(const char *name, const unsigned char *directions_available);
+static void print_bit_boards(const char *name, const CtBitBoard * bit_boards);
+static void print_rays(void);
+static void print_bit_board(void);
+static void print_move_maker(void);
+static void print_position_hash(void);
+static void random_seed(uint32_t seed);
+static int32_t random_next(void);
+
+static inline int
+square_make(int file, int rank)
+{
+  return rank * NUMBER_OF_FILES + file;
+}
+
+static inline CtBitBoard
+bit_board_make(int square)
+{
+  return ((CtBitBoard) 1) << square;
+}
+
+int
+main(int argc, char **argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s rays|bit_board|move_maker|position_hash\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  compute_directions_available();
+  if (strcmp(argv[1], "rays") == 0)
+    print_rays();
+  else if (strcmp(argv[1], "bit_board") == 0)
+    print_bit_board();
+  else if (strcmp(argv[1], "move_maker") == 0)
+    print_move_maker();
+  else if (strcmp(argv[1], "position_hash") == 0)
+    print_position_hash();
+  else
+  {
+    fprintf(stderr, "%s: unknown table group %s\n", argv[0], argv[1]);
+    return EXIT_FAILURE;
+  }
+  if (fflush(stdout) != 0 || ferror(stdout))
+    return EXIT_FAILURE;
+  return EXIT_SUCCESS;
+}
+
+/* bit n of a directions_available entry is set when a piece on that square can move one step in the nth
+   direction of adjacent_direction_array (or knight_direction_array) without leaving the board */
+static void
+compute_directions_available(void)
+{
+  int square, rank, file;
+
+  for (square = 0; square < NUMBER_OF_SQUARES; square++)
+  {
+    king_directions_available[square] = 0xFF;
+    knight_directions_available[square] = 0xFF;
+  }
+  for (rank = RANK_1; rank <= LAST_RANK; rank++)
+  {
+    king_directions_available[square_make(FILE_A, rank)] &= 0x1F;
+    king_directions_available[square_make(LAST_FILE, rank)] &= 0xF1;
+
+    knight_directions_available[square_make(FILE_A, rank)] &= 0x0F;
+    knight_directions_available[square_make(FILE_B, rank)] &= 0x9F;
+    knight_directions_available[square_make(LAST_FILE - 1, rank)] &= 0xF9;
+    knight_directions_available[square_make(LAST_FILE, rank)] &= 0xF0;
+  }
+  for (file = FILE_A; file <= LAST_FILE; file++)
+  {
+    king_directions_available[square_make(file, RANK_1)] &= 0xC7;
+    king_directions_available[square_make(file, LAST_RANK)] &= 0x7C;
+
+    knight_directions_available[square_make(file, RANK_1)] &= 0xC3;
+    knight_directions_available[square_make(file, RANK_2)] &= 0xE7;
+    knight_directions_available[square_make(file, LAST_RANK - 1)] &= 0x7E;
+    knight_directions_available[square_make(file, LAST_RANK)] &= 0x3C;
+  }
+  for (square = 0; square < NUMBER_OF_SQUARES; square++)
+  {
+    rook_directions_available[square] = king_directions_available[square] & ROOK_MASK;
+    bishop_directions_available[square] = king_directions_available[square] & BISHOP_MASK;
+  }
+}
+
+static void
+compute_pawn_attacks(CtBitBoard * destination, CtDirection queenside, CtDirection kingside, CtRank except_on)
+{
+  int from;
+
+  for (from = 0; from < NUMBER_OF_SQUARES; from++)
+  {
+    if (from / NUMBER_OF_FILES != except_on)
+    {
+      if (from % NUMBER_OF_FILES != FILE_A)
+        destination[from] |= bit_board_make(from + queenside);
+      if (from % NUMBER_OF_FILES < LAST_FILE)
+        destination[from] |= bit_board_make(from + kingside);
+    }
+  }
+}
+
+static void
+compute_steper_attacks(CtBitBoard * destination, const unsigned char *directions_available,
+                       const CtDirection * direction_array)
+{
+  int from, index;
+
+  for (from = 0; from < NUMBER_OF_SQUARES; from++)
+  {
+    for (index = 0; index < 8; index++)
+    {
+      if (directions_available[from] & (1 << index))
+        destination[from] |= bit_board_make(from + direction_array[index]);
+    }
+  }
+}
+
+/* blockers[from][to] holds the squares strictly between from and to on a rook or bishop line */
+static void
+compute_slider_attacks(CtBitBoard * destination, const unsigned char *directions_available)
+{
+  CtBitBoard next_blockers;
+  int from, to, index, bit;
+
+  for (from = 0; from < NUMBER_OF_SQUARES; from++)
+  {
+    for (index = 0; index < 8; index++)
+    {
+      bit = 1 << index;
+      if ((directions_available[from] & bit) == 0)
+        continue;
+      to = from;
+      next_blockers = 0;
+      do
+      {
+        to += adjacent_direction_array[index];
+        destination[from] |= bit_board_make(to);
+        blockers[from][to] |= next_blockers;
+        next_blockers |= bit_board_make(to);
+      } while (directions_available[to] & bit);
+    }
+  }
+}
+
+/* lines[from][to] holds every square of the rook or bishop line through from and to, from edge to edge and including
+   from and to themselves -- it is empty when the squares are not on a line */
+static void
+compute_lines(void)
+{
+  CtBitBoard ray, opposite_ray, line, targets;
+  int from, to, index;
+
+  for (from = 0; from < NUMBER_OF_SQUARES; from++)
+  {
+    for (index = 0; index < 4; index++)
+    {
+      ray = compute_ray(from, index);
+      opposite_ray = compute_ray(from, index + 4);
+      line = ray | opposite_ray | bit_board_make(from);
+      for (to = 0, targets = ray | opposite_ray; targets; to++, targets >>= 1)
+      {
+        if (targets & 1)
+          lines[from][to] = line;
+      }
+    }
+  }
+}
+
+static CtBitBoard
+compute_ray(int from, int index)
+{
+  CtBitBoard ray = 0;
+  int bit = 1 << index;
+  int to = from;
+
+  while (king_directions_available[to] & bit)
+  {
+    to += adjacent_direction_array[index];
+    ray |= bit_board_make(to);
+  }
+  return ray;
+}
+
+static void
+print_header(const char *group)
+{
+  printf("/* ct_%s_tables.h was generated by ct_generate_tables.  Do not edit. */\n\n", group);
+}
+
+static void
+print_directions(const char *name, const unsigned char *directions_available)
+{
+  int square;
+
+  printf("static const unsigned char %s[NUMBER_OF_SQUARES] = {", name);
+  for (square = 0; square < NUMBER_OF_SQUARES; square++)
+    printf("%s0x%02X%s", square % 8 ? " " : "\n  ", directions_available[square],
+           square + 1 < NUMBER_OF_SQUARES ? "," : "\n");
+  printf("};\n\n");
+}
+
+static void
+print_bit_boards(const char *name, const CtBitBoard * bit_boards)
+{
+  int square;
+
+  printf("static const CtBitBoard %s[NUMBER_OF_SQUARES] = {", name);
+  for (square = 0; square < NUMBER_OF_SQUARES; square++)
+    printf("%sUINT64_C(0x%016" PRIX64 ")%s", square % 4 ? " " : "\n  ", bit_boards[square],
+           square + 1 < NUMBER_OF_SQUARES ? "," : "\n");
+  printf("};\n\n");
+}
+
+static void
+print_rays(void)
+{
+  print_header("rays");
+  print_directions("king_directions_available", king_directions_available);
+  print_directions("knight_directions_available", knight_directions_available);
+  print_directions("rook_directions_available", rook_directions_available);
+  print_directions("bishop_directions_available", bishop_directions_available);
+}
+
+static void
+print_bit_board(void)
+{
+  int from;
+
+  compute_pawn_attacks(white_pawn_attacks, D_SW, D_SE, RANK_1);
+  compute_pawn_attacks(black_pawn_attacks, D_NW, D_NE, RANK_8);
+  compute_steper_attacks(king_attacks, king_directions_available, adjacent_direction_array);
+  compute_steper_attacks(knight_attacks, knight_directions_available, knight_direction_array);
+  compute_slider_attacks(rook_attacks, rook_directions_available);
+  compute_slider_attacks(bishop_attacks, bishop_directions_available);
+  for (from = 0; from < NUMBER_OF_SQUARES; from++)
+    queen_attacks[from] = rook_attacks[from] | bishop_attacks[from];
+  compute_lines();
+
+  print_header("bit_board");
+  print_bit_boards("king_attacks", king_attacks);
+  print_bit_boards("knight_attacks", knight_attacks);
+  print_bit_boards("white_pawn_attacks", white_pawn_attacks);
+  print_bit_boards("black_pawn_attacks", black_pawn_attacks);
+  print_bit_boards("queen_attacks", queen_attacks);
+  print_bit_boards("rook_attacks", rook_attacks);
+  print_bit_boards("bishop_attacks", bishop_attacks);
+  print_square_pairs("blockers", blockers);
+  printf("\n");
+  print_square_pairs("lines", lines);
+}
+
+static void
+print_square_pairs(const char *name, CtBitBoard square_pairs[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES])
+{
+  int from, to;
+
+  printf("static const CtBitBoard %s[NUMBER_OF_SQUARES][NUMBER_OF_SQUARES] = {\n", name);
+  for (from = 0; from < NUMBER_OF_SQUARES; from++)
+  {
+    printf("  {");
+    for (to = 0; to < NUMBER_OF_SQUARES; to++)
+      printf("%sUINT64_C(0x%016" PRIX64 ")%s", to % 4 ? " " : "\n    ", square_pairs[from][to],
+             to + 1 < NUMBER_OF_SQUARES ? "," : "\n");
+    printf("  }%s\n", from + 1 < NUMBER_OF_SQUARES ? "," : "");
+  }
+  printf("};\n");
+}
+
+static void
+print_move_maker(void)
+{
+  CtCastleRights castle_mask[NUMBER_OF_SQUARES];
+  int square;
+
+  for (square = A1; square < NUMBER_OF_SQUARES; square++)
+    castle_mask[square] = CASTLE_NONE;
+  castle_mask[A1] = CASTLE_Q;
+  castle_mask[E1] = CASTLE_KQ;
+  castle_mask[H1] = CASTLE_K;
+  castle_mask[A8] = CASTLE_q;
+  castle_mask[E8] = CASTLE_kq;
+  castle_mask[H8] = CASTLE_k;
+
+  print_header("move_maker");
+  printf("static const CtCastleRights castle_mask[NUMBER_OF_SQUARES] = {");
+  for (square = 0; square < NUMBER_OF_SQUARES; square++)
+    printf("%s%2d%s", square % 8 ? " " : "\n  ", castle_mask[square], square + 1 < NUMBER_OF_SQUARES ? "," : "\n");
+  printf("};\n");
+}
+
+/* The keys are the same sequence the library used to draw from random() at startup, so hashes stored by earlier
+   versions remain valid.  That was glibc's random() after initstate(1, state, 256), which is reproduced here so the
+   keys do not depend on the libc of the machine building the library. */
+static void
+print_position_hash(void)
+{
+  int key_index;
+  int64_t new_key;
+
+  print_header("position_hash");
+  printf("enum\n{\n  NUMBER_OF_PIECE_KEYS = %d,\n  NUMBER_OF_KEYS = %d\n};\n\n", NUMBER_OF_PIECE_KEYS, NUMBER_OF_KEYS);
+  printf("static const int64_t zobrist_keys[NUMBER_OF_KEYS] = {");
+  random_seed(1);
+  for (key_index = 0; key_index < NUMBER_OF_KEYS; key_index++)
+  {
+    new_key = random_next();        /* random_next returns a number between 0 and (2^31 - 1) */
+    new_key <<= 31;
+    new_key |= random_next();        /* new_key is now a 62-bit random number */
+    printf("%sINT64_C(0x%016" PRIX64 ")%s", key_index % 3 ? " " : "\n  ", (uint64_t) new_key,
+           key_index + 1 < NUMBER_OF_KEYS ? "," : "\n");
+  }
+  printf("};\n");
+}
+
+/* glibc seeds its additive feedback generator (of degree 63 for a 256 byte state, whatever the state held) from a
+   Park-Miller generator, and throws away the first 630 numbers */
+static void
+random_seed(uint32_t seed)
+{
+  int32_t word = seed;
+  int index;
+
+  random_table[0] = seed;
+  for (index = 1; index < RANDOM_DEGREE; index++)
+  {
+    word = 16807 * (word % 127773) - 2836 * (word / 127773);        /* 16807 * word % (2^31 - 1) without overflow */
+    if (word < 0)
+      word += 2147483647;
+    random_table[index] = word;
+  }
+  random_front = RANDOM_SEPARATION;
+  random_rear = 0;
+  for (index = 0; index < 10 * RANDOM_DEGREE; index++)
+    random_next();
+}
+
+static int32_t
+random_next(void)
+{
+  uint32_t value = random_table[random_front] += random_table[random_rear];
+
+  random_front = (random_front + 1) % RANDOM_DEGREE;
+  random_rear = (random_rear + 1) % RANDOM_DEGREE;
+  return value >> 1;                /* the least random bit is thrown away */
+}
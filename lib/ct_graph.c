@@ -25,8 +25,16 @@
 #include "ct_move_maker.h"
 #include "ct_move_stack.h"
 
+enum
+{
+  SNAPSHOTS_INITIAL_SIZE = 16,
+  LEGAL_MOVES_INITIAL_SIZE = 64
+};
+
 static void ct_graph_filter_pseudo_moves(void *delegate, CtMove move);
-static void ct_graph_replay_move(void *delegate, CtMove);
+static void ct_graph_cache_legal_move(void *delegate, CtMove move);
+static void ct_graph_take_snapshot(CtGraph graph);
+static void ct_graph_restore_snapshot(CtGraph graph, int index);
 
 CtGraph
 ct_graph_new(void)
@@ -39,14 +47,36 @@ ct_graph_new(void)
   graph->move_generator = ct_move_generator_new(graph->position, graph->filter_pseudo_moves);
   graph->move_maker = ct_move_maker_new(graph->position);
   graph->move_stack = ct_move_stack_new();
-  graph->replay_move_command = ct_move_command_new(graph, ct_graph_replay_move);
+  graph->snapshots = 0;
+  graph->snapshots_size = 0;
+  graph->scratch_position = ct_position_new();
+  graph->scratch_move_maker = ct_move_maker_new(graph->scratch_position);
+  graph->cache_legal_move = ct_move_command_new(graph, ct_graph_cache_legal_move);
+  graph->legal_moves_size = LEGAL_MOVES_INITIAL_SIZE;
+  graph->legal_moves = ct_malloc(graph->legal_moves_size * sizeof(CtMove));
+  graph->stage_move_generator = 0;
+  graph->filter_stage_moves = 0;
+  ct_graph_reset(graph);
   return graph;
 }
 
 void
 ct_graph_free(CtGraph graph)
 {
-  ct_move_command_free(graph->replay_move_command);
+  int index;
+
+  if (graph->stage_move_generator != 0)
+  {
+    ct_move_generator_free(graph->stage_move_generator);
+    ct_move_command_free(graph->filter_stage_moves);
+  }
+  for (index = 0; index < graph->snapshots_size; index++)
+    ct_position_free(graph->snapshots[index]);
+  ct_free(graph->snapshots);
+  ct_free(graph->legal_moves);
+  ct_move_command_free(graph->cache_legal_move);
+  ct_move_maker_free(graph->scratch_move_maker);
+  ct_position_free(graph->scratch_position);
   ct_move_stack_free(graph->move_stack);
   ct_move_maker_free(graph->move_maker);
   ct_move_generator_free(graph->move_generator);
@@ -61,22 +91,75 @@ ct_graph_reset(CtGraph graph)
   ct_position_reset(graph->position);
   ct_move_stack_reset(graph->move_stack);
   ct_move_maker_reset(graph->move_maker);
+  graph->ply = 0;
+  graph->undo_ply = 0;
+  graph->snapshot_count = 0;        /* the first snapshot is taken with the first move, after any setup */
+  graph->legal_moves_ply = -1;
 }
 
 int
 ct_graph_ply(CtGraph graph)
+{
+  return graph->ply;
+}
+
+int
+ct_graph_line_length(CtGraph graph)
 {
   return ct_move_stack_length(graph->move_stack);
 }
 
 void
 ct_graph_for_each_legal_move(CtGraph graph, CtMoveCommand move_command)
+{
+  CtMove *legal_moves = ct_graph_legal_moves(graph);
+  int index;
+
+  for (index = 0; index < graph->legal_move_count; index++)
+    ct_move_command_execute(move_command, legal_moves[index]);
+}
+
+/* the moves are generated at most once for each position reached */
+CtMove *
+ct_graph_legal_moves(CtGraph graph)
+{
+  if (graph->legal_moves_ply != graph->ply)
+  {
+    graph->legal_move_count = 0;
+    ct_graph_generate_legal_moves(graph, graph->cache_legal_move);
+    graph->legal_moves_ply = graph->ply;
+  }
+  return graph->legal_moves;
+}
+
+int
+ct_graph_legal_move_count(CtGraph graph)
+{
+  ct_graph_legal_moves(graph);
+  return graph->legal_move_count;
+}
+
+void
+ct_graph_generate_legal_moves(CtGraph graph, CtMoveCommand move_command)
 {
   graph->command_for_each_legal_move = move_command;
   ct_move_generator_pseudo_legal_piece_moves(graph->move_generator);
   ct_move_generator_castle_moves(graph->move_generator, graph->command_for_each_legal_move);
 }
 
+static void
+ct_graph_cache_legal_move(void *delegate, CtMove move)
+{
+  CtGraph graph = (CtGraph) delegate;
+
+  if (graph->legal_move_count == graph->legal_moves_size)
+  {
+    graph->legal_moves_size *= 2;
+    graph->legal_moves = ct_realloc(graph->legal_moves, graph->legal_moves_size * sizeof(CtMove));
+  }
+  graph->legal_moves[graph->legal_move_count++] = move;
+}
+
 static void
 ct_graph_filter_pseudo_moves(void *delegate, CtMove move)
 {
@@ -91,38 +174,107 @@ ct_graph_filter_pseudo_moves(void *delegate, CtMove move)
     ct_move_command_execute(graph->command_for_each_legal_move, move);
 }
 
+/* the moves are replayed from the start of the game up to the current ply */
 void
 ct_graph_for_each_move_made(CtGraph graph, CtMoveCommand move_command)
 {
-  CtMoveStack move_stack = graph->move_stack;
-  int move_stack_length = ct_move_stack_length(move_stack);
-  CtMoveMaker move_maker = graph->move_maker;
-
-  graph->command_for_each_move_made = move_command;
-  while (move_stack_length-- > 0)
-    ct_move_maker_unmake(move_maker);
-  ct_move_stack_for_each(graph->move_stack, graph->replay_move_command);
-}
-
-static void
-ct_graph_replay_move(void *delegate, CtMove move)
-{
-  CtGraph graph = (CtGraph) delegate;
+  int ply = graph->ply;
+  CtMove move;
 
-  ct_move_command_execute(graph->command_for_each_move_made, move);
-  ct_move_maker_make(graph->move_maker, move);
+  ct_graph_goto_ply(graph, 0);
+  while (graph->ply < ply)
+  {
+    move = ct_move_stack_get(graph->move_stack, graph->ply);
+    ct_move_command_execute(move_command, move);
+    ct_move_maker_make(graph->move_maker, move);
+    graph->ply++;
+  }
 }
 
+/* making a move replaces the rest of the line, if the graph was not at the end of it, along with its snapshots */
 void
 ct_graph_make_move(CtGraph graph, CtMove move)
 {
+  ct_move_stack_truncate(graph->move_stack, graph->ply);
+  if (graph->snapshot_count > graph->ply / GRAPH_SNAPSHOT_INTERVAL + 1)
+    graph->snapshot_count = graph->ply / GRAPH_SNAPSHOT_INTERVAL + 1;
+  graph->legal_moves_ply = -1;
+  if (graph->ply % GRAPH_SNAPSHOT_INTERVAL == 0)
+    ct_graph_take_snapshot(graph);
   ct_move_maker_make(graph->move_maker, move);
   ct_move_stack_push(graph->move_stack, move);
+  graph->ply++;
 }
 
 CtMove
 ct_graph_unmake_move(CtGraph graph)
 {
-  ct_move_maker_unmake(graph->move_maker);
+  ct_move_stack_truncate(graph->move_stack, graph->ply);
+  if (graph->ply == 0)
+    return NULL_MOVE;
+  graph->legal_moves_ply = -1;
+  if (graph->ply == graph->undo_ply)
+    ct_graph_goto_ply(graph, graph->ply - 1);
+  else
+  {
+    ct_move_maker_unmake(graph->move_maker);
+    graph->ply--;
+  }
   return ct_move_stack_pop(graph->move_stack);
 }
+
+/* goes back by unmaking moves when that is no more work than going forward from the nearest snapshot -- returns false
+   if ply is not on the line */
+bool
+ct_graph_goto_ply(CtGraph graph, int ply)
+{
+  int index;
+
+  if (ply < 0 || ply > ct_graph_line_length(graph))
+    return false;
+  if (ply == graph->ply)
+    return true;
+  index = ply / GRAPH_SNAPSHOT_INTERVAL;
+  if (index >= graph->snapshot_count)
+    index = graph->snapshot_count - 1;        /* no move has been made from the last ply of the line */
+  if (ply < graph->ply && ply >= graph->undo_ply && graph->ply - ply <= ply - index * GRAPH_SNAPSHOT_INTERVAL)
+  {
+    while (graph->ply > ply)
+    {
+      ct_move_maker_unmake(graph->move_maker);
+      graph->ply--;
+    }
+  }
+  else if (ply < graph->ply || index * GRAPH_SNAPSHOT_INTERVAL > graph->ply)
+    ct_graph_restore_snapshot(graph, index);
+  while (graph->ply < ply)
+    ct_move_maker_make(graph->move_maker, ct_move_stack_get(graph->move_stack, graph->ply++));
+  return true;
+}
+
+/* the snapshot for the ply of a new move replaces the old line's one, if there was one */
+static void
+ct_graph_take_snapshot(CtGraph graph)
+{
+  int index = graph->ply / GRAPH_SNAPSHOT_INTERVAL;
+
+  if (index == graph->snapshots_size)
+  {
+    graph->snapshots_size = graph->snapshots_size ? 2 * graph->snapshots_size : SNAPSHOTS_INITIAL_SIZE;
+    graph->snapshots = ct_realloc(graph->snapshots, graph->snapshots_size * sizeof(CtPosition));
+    while (index < graph->snapshots_size)
+      graph->snapshots[index++] = ct_position_new();
+    index = graph->ply / GRAPH_SNAPSHOT_INTERVAL;
+  }
+  ct_position_copy(graph->snapshots[index], graph->position);
+  graph->snapshot_count = index + 1;
+}
+
+static void
+ct_graph_restore_snapshot(CtGraph graph, int index)
+{
+  ct_position_copy(graph->position, graph->snapshots[index]);
+  ct_move_maker_reset(graph->move_maker);
+  graph->ply = index * GRAPH_SNAPSHOT_INTERVAL;
+  graph->undo_ply = graph->ply;
+}
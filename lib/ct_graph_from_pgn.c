@@ -18,40 +18,124 @@
 #include <config.h>
 #include "ct_graph.h"
 #include "ct_pgn_reader.h"
+#include "ct_pgn_reader_private.h"
+#include "ct_pgn_parser.h"
+#include "ct_pgn_input.h"
+#include "ct_pgn_index.h"
+#include "ct_pgn_error_log.h"
 #include "ct_game_tags.h"
+#include "ct_game_annotations.h"
+#include "ct_game_filter.h"
 #include "ct_command.h"
+#include "ct_move_command.h"
+#include "ct_move_tree.h"
 #include "ct_utilities.h"
 #include <string.h>
 #include <stdio.h>
 
+enum
+{
+  MOVETEXT_INITIAL_SIZE = 1024,
+  MOVES_INITIAL_SIZE = 128,
+  VARIATIONS_INITIAL_SIZE = 16
+};
+
+/* header hashes are 64 bit FNV-1a hashes of the tag keys and values */
+static const uint64_t HEADER_HASH_OFFSET_BASIS = 14695981039346656037ULL;
+static const uint64_t HEADER_HASH_PRIME = 1099511628211ULL;
+
+/* when reading lazily, each move is saved as an offset into the movetext, along with where it was found for error
+   messages */
+typedef struct CtPgnReaderMoveStruct
+{
+  int offset;
+  int line;
+  int column;
+} CtPgnReaderMoveStruct;
+
+/* a variation replaces the last move made before it, which is unmade until the variation ends -- the graph is only
+   ever at one position, so no position is copied for a variation */
+typedef struct CtPgnReaderVariationStruct
+{
+  CtMove move;                        /* the move the variation replaces */
+  int ply;                        /* the ply the variation starts from */
+  int move_tree_node;                /* the node of the move the variation replaces */
+} CtPgnReaderVariationStruct;
+
 typedef struct CtPgnReaderStruct
 {
   CtGraph graph;
   CtGameTags game_tags;
   void *pgn_scanner;
+  CtPgnInput pgn_input;
   char save_tag_key[GAME_TAGS_KEY_MAX_LENGTH];
   int error_line;                /* line 0 indicates no error, the first line of the text is line 1 */
   int error_column;
   char *error_message;
   CtCommand callback;
+  CtMoveCommand move_command;        /* executed as each move is made, before the game is complete */
+  CtGameFilter game_filter;        /* when there is a game filter, moves are only decoded for games it accepts */
+  char *movetext;
+  int movetext_length;
+  int movetext_size;
+  CtPgnReaderMoveStruct *moves;
+  int move_count;
+  int moves_size;
+  int variation_depth;                /* variations scanned but not yet ended */
+  int main_line_ply;                /* moves scanned outside of variations */
+  CtPgnReaderVariationStruct *variations;        /* variations entered in the graph but not yet left */
+  int variation_count;
+  int variations_size;
+  int move_tree_node;                /* the node of the last move made, when the input has a move tree */
+  CtPgnIndex pgn_index;                /* the index being built, or the index games are being read from */
+  bool is_building_index;
+  int index_game;
+  int stale_index_game;                /* -1 unless a game's tags did not match the index */
+  int64_t offset;                /* bytes scanned so far */
+  int64_t game_offset;
+  bool is_in_game;
+  uint64_t header_hash;
+  int game_number;                /* games ended so far, including games skipped because of errors */
+  int64_t game_end_offset;        /* where the last game ended */
+  CtPgnCheckpoint checkpoint;        /* the last checkpoint taken, when checkpoints are wanted */
+  int games_between_checkpoints;
+  CtCommand checkpoint_command;
+  yypstate *parser_state;        /* only used when games are pulled one at a time with ct_pgn_reader_next_game */
+  YYLTYPE location;
+  bool is_game_ready;
+  bool is_finished;
+  char pulled_error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
 } CtPgnReaderStruct;
 
 static CtGraph default_graph;
 static CtGameTags default_game_tags;
 
-static CtPgnReader ct_pgn_reader_new(CtGraph graph, CtGameTags game_tags, char *error_message);
+static CtPgnReader ct_pgn_reader_new(CtGraph graph, CtGameTags game_tags, CtCommand callback, char *error_message);
 static void ct_pgn_reader_free(CtPgnReader pgn_reader);
-static CtGraph ct_graph_from_pgn_string_or_file(CtGraph graph, CtGameTags game_tags, char *pgn_string, FILE * file, CtCommand command, char *error_message);
+static void ct_pgn_reader_use_game_filter(CtPgnReader pgn_reader, CtGameFilter game_filter);
+static void ct_pgn_reader_use_pgn_index(CtPgnReader pgn_reader, CtPgnIndex pgn_index, bool is_building_index, int first_game);
+static void ct_pgn_reader_use_checkpoint(CtPgnReader pgn_reader, CtPgnCheckpoint checkpoint, int games_between_checkpoints, CtCommand checkpoint_command);
+static CtGraph ct_pgn_reader_parse(CtPgnReader pgn_reader);
 static void ct_pgn_reader_reset(CtPgnReader pgn_reader);
 static void ct_pgn_reader_update_error_message(CtPgnReader pgn_reader);
+static void ct_pgn_reader_describe_error(CtPgnReader pgn_reader, char *error_message);
+static bool ct_pgn_reader_decode_move(CtPgnReader pgn_reader, char *move_notation, int line, int column);
+static void ct_pgn_reader_save_move(CtPgnReader pgn_reader, char *move_notation, int line, int column);
+static bool ct_pgn_reader_enter_variation(CtPgnReader pgn_reader, int line, int column);
+static bool ct_pgn_reader_leave_variation(CtPgnReader pgn_reader, int line, int column);
+static CtMoveTree ct_pgn_reader_move_tree(CtPgnReader pgn_reader);
+static bool ct_pgn_reader_make_saved_moves(CtPgnReader pgn_reader);
+static bool ct_pgn_reader_index_game(CtPgnReader pgn_reader);
+static void ct_pgn_reader_hash_header(CtPgnReader pgn_reader, char *text);
+static void ct_pgn_reader_end_game(CtPgnReader pgn_reader);
+static void ct_pgn_reader_take_checkpoint(CtPgnReader pgn_reader);
 
 void ct_pgn_reader_syntax_error(CtPgnReader pgn_reader, int line, int column);
 
 int yylex_init_extra(CtPgnReader pgn_reader, void *yyscanner);
 int yylex_destroy(void *yyscanner);
+int yylex(YYSTYPE * yylval_param, YYLTYPE * yylloc_param, void *yyscanner);
 void *yy_scan_string(const char *yy_str, void *yyscanner);
-void yyset_in(FILE * in_str, void *yyscanner);
-int yyparse(CtPgnReader pgn_reader);
 void ct_pgn_scanner_restart(void *yyscanner);
 
 void
@@ -62,14 +146,33 @@ ct_graph_from_pgn_init(void)
 }
 
 static CtPgnReader
-ct_pgn_reader_new(CtGraph graph, CtGameTags game_tags, char *error_message)
+ct_pgn_reader_new(CtGraph graph, CtGameTags game_tags, CtCommand callback, char *error_message)
 {
   CtPgnReader pgn_reader;
 
   pgn_reader = ct_malloc(sizeof(CtPgnReaderStruct));
-  pgn_reader->graph = graph;
-  pgn_reader->game_tags = game_tags;
+  pgn_reader->graph = graph ? graph : default_graph;
+  pgn_reader->game_tags = game_tags ? game_tags : default_game_tags;
   pgn_reader->error_message = error_message;
+  pgn_reader->callback = callback;
+  pgn_reader->move_command = 0;
+  pgn_reader->pgn_input = 0;
+  pgn_reader->game_filter = 0;
+  pgn_reader->movetext = 0;
+  pgn_reader->moves = 0;
+  pgn_reader->variations = ct_malloc(VARIATIONS_INITIAL_SIZE * sizeof(CtPgnReaderVariationStruct));
+  pgn_reader->variations_size = VARIATIONS_INITIAL_SIZE;
+  pgn_reader->pgn_index = 0;
+  pgn_reader->stale_index_game = -1;
+  pgn_reader->offset = 0;
+  pgn_reader->is_in_game = false;
+  pgn_reader->header_hash = HEADER_HASH_OFFSET_BASIS;
+  pgn_reader->game_number = 0;
+  pgn_reader->game_end_offset = 0;
+  pgn_reader->checkpoint = 0;
+  pgn_reader->parser_state = 0;
+  pgn_reader->is_game_ready = false;
+  pgn_reader->is_finished = false;
   yylex_init_extra(pgn_reader, &pgn_reader->pgn_scanner);
   ct_pgn_reader_reset(pgn_reader);
   return pgn_reader;
@@ -79,52 +182,278 @@ static void
 ct_pgn_reader_free(CtPgnReader pgn_reader)
 {
   yylex_destroy(pgn_reader->pgn_scanner);
+  if (pgn_reader->game_filter)
+  {
+    ct_free(pgn_reader->movetext);
+    ct_free(pgn_reader->moves);
+  }
+  ct_free(pgn_reader->variations);
   ct_free(pgn_reader);
 }
 
+static void
+ct_pgn_reader_use_game_filter(CtPgnReader pgn_reader, CtGameFilter game_filter)
+{
+  pgn_reader->game_filter = game_filter;
+  pgn_reader->movetext = ct_malloc(MOVETEXT_INITIAL_SIZE);
+  pgn_reader->movetext_size = MOVETEXT_INITIAL_SIZE;
+  pgn_reader->moves = ct_malloc(MOVES_INITIAL_SIZE * sizeof(CtPgnReaderMoveStruct));
+  pgn_reader->moves_size = MOVES_INITIAL_SIZE;
+}
+
+static void
+ct_pgn_reader_use_pgn_index(CtPgnReader pgn_reader, CtPgnIndex pgn_index, bool is_building_index, int first_game)
+{
+  pgn_reader->pgn_index = pgn_index;
+  pgn_reader->is_building_index = is_building_index;
+  pgn_reader->index_game = first_game;
+}
+
+/* reading starts at the checkpoint, and carries on counting bytes and games from there */
+static void
+ct_pgn_reader_use_checkpoint(CtPgnReader pgn_reader, CtPgnCheckpoint checkpoint, int games_between_checkpoints, CtCommand checkpoint_command)
+{
+  pgn_reader->checkpoint = checkpoint;
+  pgn_reader->games_between_checkpoints = games_between_checkpoints > 0 ? games_between_checkpoints : 1;
+  pgn_reader->checkpoint_command = checkpoint_command;
+  pgn_reader->offset = checkpoint->offset;
+  pgn_reader->game_end_offset = checkpoint->offset;
+  pgn_reader->game_number = checkpoint->game;
+}
+
+/* parses everything the scanner has been given and frees the reader -- it returns the graph, or 0 if there was an
+   error */
+static CtGraph
+ct_pgn_reader_parse(CtPgnReader pgn_reader)
+{
+  CtGraph graph = pgn_reader->graph;
+
+  yyparse(pgn_reader);
+  if (pgn_reader->checkpoint)        /* a final checkpoint after the last complete game, even if reading stopped early */
+    ct_pgn_reader_take_checkpoint(pgn_reader);
+  ct_pgn_reader_update_error_message(pgn_reader);
+  if (pgn_reader->error_line)
+    graph = 0;
+  ct_pgn_reader_free(pgn_reader);
+  return graph;
+}
+
 CtGraph
 ct_graph_from_pgn(CtGraph graph, CtGameTags game_tags, char *pgn_string, char *error_message)
 {
-  if (pgn_string)
-    return ct_graph_from_pgn_string_or_file(graph, game_tags, pgn_string, 0, 0, error_message);
-  return 0;
+  CtPgnReader pgn_reader;
+
+  if (pgn_string == 0)
+    return 0;
+  pgn_reader = ct_pgn_reader_new(graph, game_tags, 0, error_message);
+  yy_scan_string(pgn_string, pgn_reader->pgn_scanner);
+  return ct_pgn_reader_parse(pgn_reader);
 }
 
 void
 ct_graph_from_pgn_file(CtGraph graph, CtGameTags game_tags, FILE * file, CtCommand command, char *error_message)
 {
+  CtPgnInput pgn_input;
+
   if (file && command)
-    ct_graph_from_pgn_string_or_file(graph, game_tags, 0, file, command, error_message);
+  {
+    pgn_input = ct_pgn_input_new(file);
+    ct_graph_from_pgn_input(graph, game_tags, pgn_input, command, error_message);
+    ct_pgn_input_free(pgn_input);
+  }
 }
 
-static CtGraph
-ct_graph_from_pgn_string_or_file(CtGraph graph, CtGameTags game_tags, char *pgn_string, FILE * file, CtCommand command, char *error_message)
+/* reading from an input, a command processes each game -- the scanner reads through ct_pgn_reader_read */
+void
+ct_graph_from_pgn_input(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input, CtCommand command, char *error_message)
 {
   CtPgnReader pgn_reader;
-  bool is_from_string = pgn_string != 0;
 
-  if (graph == 0)
-    graph = default_graph;
-  if (game_tags == 0)
-    game_tags = default_game_tags;
-  pgn_reader = ct_pgn_reader_new(graph, game_tags, error_message);
-  if (is_from_string)
+  if (pgn_input && command)
   {
-    pgn_reader->callback = 0;
-    yy_scan_string(pgn_string, pgn_reader->pgn_scanner);
+    pgn_reader = ct_pgn_reader_new(graph, game_tags, command, error_message);
+    pgn_reader->pgn_input = pgn_input;
+    ct_pgn_reader_parse(pgn_reader);
   }
-  else
+}
+
+/* the input is skipped to the checkpoint, which is updated (and checkpoint_command executed) every
+   games_between_checkpoints games, and once more when reading stops */
+void
+ct_graph_from_pgn_input_resumable(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input, CtPgnCheckpoint checkpoint, int games_between_checkpoints, CtCommand checkpoint_command, CtCommand command, char *error_message)
+{
+  CtPgnReader pgn_reader;
+  int64_t skip_length;
+
+  if (pgn_input == 0 || checkpoint == 0 || command == 0)
+    return;
+  skip_length = checkpoint->offset - ct_pgn_input_bytes_read(pgn_input);
+  if (skip_length < 0 || !ct_pgn_input_skip(pgn_input, skip_length))
   {
-    /* from file, using a command to process each game */
-    pgn_reader->callback = command;
-    yyset_in(file, pgn_reader->pgn_scanner);
+    if (error_message)
+      snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH, "cannot resume reading at byte %lld",
+               (long long) checkpoint->offset);
+    return;
   }
-  yyparse(pgn_reader);
-  ct_pgn_reader_update_error_message(pgn_reader);
-  if (pgn_reader->error_line)
-    graph = 0;
+  pgn_reader = ct_pgn_reader_new(graph, game_tags, command, error_message);
+  pgn_reader->pgn_input = pgn_input;
+  ct_pgn_reader_use_checkpoint(pgn_reader, checkpoint, games_between_checkpoints, checkpoint_command);
+  ct_pgn_reader_parse(pgn_reader);
+}
+
+void
+ct_graph_from_pgn_input_filtered(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input, CtGameFilter game_filter, CtCommand command, char *error_message)
+{
+  CtPgnReader pgn_reader;
+
+  if (pgn_input && game_filter && command)
+  {
+    pgn_reader = ct_pgn_reader_new(graph, game_tags, command, error_message);
+    pgn_reader->pgn_input = pgn_input;
+    ct_pgn_reader_use_game_filter(pgn_reader, game_filter);
+    ct_pgn_reader_parse(pgn_reader);
+  }
+}
+
+/* the index is built with a filter and a command without a method, so the moves are saved but never decoded */
+CtPgnIndex
+ct_pgn_index_from_pgn_file(CtPgnIndex pgn_index, FILE * pgn_file, char *error_message)
+{
+  CtCommandStruct skip_game = ct_command_make(0, 0);
+  CtGameFilter game_filter;
+  CtGraph graph;
+  CtGameTags game_tags;
+  CtPgnInput pgn_input;
+  CtPgnReader pgn_reader;
+  CtGraph result;
+
+  ct_pgn_index_reset(pgn_index);
+  pgn_input = ct_pgn_input_new(pgn_file);
+  if (strcmp(ct_pgn_input_format(pgn_input), "pgn") != 0)
+  {
+    if (error_message)
+      snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH, "%s files cannot be indexed",
+               ct_pgn_input_format(pgn_input));
+    ct_pgn_input_free(pgn_input);
+    return 0;
+  }
+  game_filter = ct_game_filter_new();
+  graph = ct_graph_new();
+  game_tags = ct_game_tags_new();
+  pgn_reader = ct_pgn_reader_new(graph, game_tags, &skip_game, error_message);
+  pgn_reader->pgn_input = pgn_input;
+  ct_pgn_reader_use_game_filter(pgn_reader, game_filter);
+  ct_pgn_reader_use_pgn_index(pgn_reader, pgn_index, true, 0);
+  result = ct_pgn_reader_parse(pgn_reader);
+  ct_game_tags_free(game_tags);
+  ct_graph_free(graph);
+  ct_game_filter_free(game_filter);
+  ct_pgn_input_free(pgn_input);
+  return result ? pgn_index : 0;
+}
+
+/* the games from first_game through first_game + game_count - 1 are next to each other in the file, so they are read
+   into memory with one seek -- line numbers in error messages count from the start of first_game */
+void
+ct_graph_from_pgn_index(CtGraph graph, CtGameTags game_tags, FILE * file, CtPgnIndex pgn_index, int first_game, int game_count, CtCommand command, char *error_message)
+{
+  int last_game = first_game + game_count - 1;
+  int64_t offset, length;
+  char *pgn_text;
+  CtPgnReader pgn_reader;
+
+  if (file == 0 || pgn_index == 0 || command == 0 || game_count <= 0)
+    return;
+  if (first_game < 0 || last_game >= ct_pgn_index_game_count(pgn_index))
+  {
+    if (error_message)
+      snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH, "game %d is not in the index",
+               first_game < 0 ? first_game : last_game);
+    return;
+  }
+  offset = ct_pgn_index_offset(pgn_index, first_game);
+  length = ct_pgn_index_offset(pgn_index, last_game) + ct_pgn_index_length(pgn_index, last_game) - offset;
+  pgn_text = ct_malloc(length + 1);
+  if (fseeko(file, offset, SEEK_SET) != 0 || fread(pgn_text, 1, length, file) != (size_t) length)
+  {
+    if (error_message)
+      snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH, "cannot read game %d from the file",
+               first_game);
+    ct_free(pgn_text);
+    return;
+  }
+  pgn_reader = ct_pgn_reader_new(graph, game_tags, command, error_message);
+  pgn_text[length] = 0;
+  yy_scan_string(pgn_text, pgn_reader->pgn_scanner);
+  ct_free(pgn_text);
+  ct_pgn_reader_use_pgn_index(pgn_reader, pgn_index, false, first_game);
+  ct_pgn_reader_parse(pgn_reader);
+}
+
+/* the reader is driven one token at a time through the push interface of the parser, so that it can stop after each
+   game -- only the scanner's buffer and the input's blocks are held between games */
+CtPgnReader
+ct_pgn_reader_open(CtGraph graph, CtGameTags game_tags, CtPgnInput pgn_input)
+{
+  static const YYLTYPE initial_location = { 1, 1, 1, 1 };
+  CtPgnReader pgn_reader;
+
+  if (pgn_input == 0)
+    return 0;
+  pgn_reader = ct_pgn_reader_new(graph, game_tags, 0, 0);
+  pgn_reader->pgn_input = pgn_input;
+  pgn_reader->error_message = pgn_reader->pulled_error_message;
+  pgn_reader->error_message[0] = 0;
+  pgn_reader->parser_state = yypstate_new();
+  pgn_reader->location = initial_location;
+  return pgn_reader;
+}
+
+bool
+ct_pgn_reader_next_game(CtPgnReader pgn_reader)
+{
+  YYSTYPE value;
+  int token;
+
+  if (pgn_reader->is_game_ready)
+  {
+    pgn_reader->is_game_ready = false;
+    ct_pgn_reader_reset(pgn_reader);
+  }
+  while (!pgn_reader->is_finished)
+  {
+    token = yylex(&value, &pgn_reader->location, pgn_reader->pgn_scanner);
+    if (yypush_parse(pgn_reader->parser_state, token, &value, &pgn_reader->location, pgn_reader) != YYPUSH_MORE)
+    {
+      pgn_reader->is_finished = true;
+      pgn_reader->is_game_ready = false;
+      ct_pgn_reader_update_error_message(pgn_reader);
+    }
+    else if (pgn_reader->is_game_ready)
+      return true;
+  }
+  return false;
+}
+
+/* when the input is followed, moves are handed out as soon as they are appended to the file, while
+   ct_pgn_reader_next_game is still waiting for the rest of the game */
+void
+ct_pgn_reader_use_move_command(CtPgnReader pgn_reader, CtMoveCommand move_command)
+{
+  pgn_reader->move_command = move_command;
+}
+
+char *
+ct_pgn_reader_error_message(CtPgnReader pgn_reader)
+{
+  return pgn_reader->error_message;
+}
+
+void
+ct_pgn_reader_close(CtPgnReader pgn_reader)
+{
+  yypstate_delete(pgn_reader->parser_state);
   ct_pgn_reader_free(pgn_reader);
-  return graph;
 }
 
 static void
@@ -135,7 +464,17 @@ ct_pgn_reader_reset(CtPgnReader pgn_reader)
   ct_graph_reset(pgn_reader->graph);
   ct_game_tags_reset(pgn_reader->game_tags);
   pgn_reader->save_tag_key[0] = 0;
+  pgn_reader->movetext_length = 0;
+  pgn_reader->move_count = 0;
+  pgn_reader->variation_depth = 0;
+  pgn_reader->main_line_ply = 0;
+  pgn_reader->variation_count = 0;
+  pgn_reader->move_tree_node = MOVE_TREE_ROOT;
   pgn_reader->error_line = 0;
+  if (pgn_reader->pgn_input && ct_pgn_input_game_annotations(pgn_reader->pgn_input))
+    ct_game_annotations_reset(ct_pgn_input_game_annotations(pgn_reader->pgn_input));
+  if (ct_pgn_reader_move_tree(pgn_reader))
+    ct_move_tree_reset(ct_pgn_reader_move_tree(pgn_reader));
   if (error_message)
     error_message[0] = 0;
   /* error_column does not need to be changed, since syntax_error changes line and column together */
@@ -145,12 +484,26 @@ ct_pgn_reader_reset(CtPgnReader pgn_reader)
 static void
 ct_pgn_reader_update_error_message(CtPgnReader pgn_reader)
 {
-  if (pgn_reader->error_message == 0)
-    return;
-  if (pgn_reader->error_line == 0)
-    pgn_reader->error_message[0] = 0;
+  if (pgn_reader->error_message)
+    ct_pgn_reader_describe_error(pgn_reader, pgn_reader->error_message);
+}
+
+static void
+ct_pgn_reader_describe_error(CtPgnReader pgn_reader, char *error_message)
+{
+  CtPgnInput pgn_input = pgn_reader->pgn_input;
+
+  if (pgn_input && ct_pgn_input_has_error(pgn_input))        /* corrupt data usually causes a syntax error as well */
+    snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH,
+             "%s data is corrupt after byte %lld",
+             ct_pgn_input_format(pgn_input), (long long) ct_pgn_input_bytes_read(pgn_input));
+  else if (pgn_reader->stale_index_game >= 0)
+    snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH,
+             "the index does not match game %d", pgn_reader->stale_index_game);
+  else if (pgn_reader->error_line == 0)
+    error_message[0] = 0;
   else
-    snprintf(pgn_reader->error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH,
+    snprintf(error_message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH,
              "syntax error on line %d column %d",
              pgn_reader->error_line, pgn_reader->error_column);
 }
@@ -161,17 +514,58 @@ ct_pgn_reader_scanner(CtPgnReader pgn_reader)
   return pgn_reader->pgn_scanner;
 }
 
+int
+ct_pgn_reader_read(CtPgnReader pgn_reader, char *destination, int max_length)
+{
+  if (pgn_reader->pgn_input == 0)
+    return 0;
+  return ct_pgn_input_read(pgn_reader->pgn_input, destination, max_length);
+}
+
+/* a game starts with its first token that is not whitespace or a comment */
 void
+ct_pgn_reader_count(CtPgnReader pgn_reader, char *text, int length)
+{
+  if (!pgn_reader->is_in_game && strchr(" \t\n\r;{", *text) == 0)
+  {
+    pgn_reader->is_in_game = true;
+    pgn_reader->game_offset = pgn_reader->offset;
+  }
+  pgn_reader->offset += length;
+}
+
+bool
 ct_pgn_reader_set_game_termination(CtPgnReader pgn_reader, char *result)
 {
   CtCommand callback = pgn_reader->callback;
+  bool is_wanted = true;
 
+  if (pgn_reader->error_line)        /* the parser is skipping the rest of a game it could not parse */
+    return false;
+  if (pgn_reader->variation_depth > 0)        /* a game cannot end inside a variation */
+    return false;
   ct_game_tags_set(pgn_reader->game_tags, "Result", result);
+  if (pgn_reader->game_filter)
+  {
+    /* the tags are complete, so the filter can decide whether the saved moves are worth decoding -- they never are
+       for a command without a method */
+    is_wanted = (callback == 0 || callback->method) && ct_game_filter_accepts(pgn_reader->game_filter,
+                                                                              pgn_reader->game_tags);
+    if (is_wanted && !ct_pgn_reader_make_saved_moves(pgn_reader))
+      return false;
+  }
+  if (pgn_reader->pgn_index && !ct_pgn_reader_index_game(pgn_reader))
+    return false;
   if (callback)
   {
-    ct_command_execute(callback);
+    if (is_wanted)
+      ct_command_execute(callback);
     ct_pgn_reader_reset(pgn_reader);
   }
+  else if (pgn_reader->parser_state)        /* the game is reset when the next game is pulled */
+    pgn_reader->is_game_ready = true;
+  ct_pgn_reader_end_game(pgn_reader);
+  return true;
 }
 
 void
@@ -200,21 +594,230 @@ ct_pgn_reader_set_tag_value(CtPgnReader pgn_reader, char *quoted_string)
     *copy_to++ = *quoted_string++;
   }
   *copy_to = 0;
+  if (pgn_reader->pgn_index)
+  {
+    ct_pgn_reader_hash_header(pgn_reader, pgn_reader->save_tag_key);
+    ct_pgn_reader_hash_header(pgn_reader, unescaped_tag_value);
+  }
   ct_game_tags_set(pgn_reader->game_tags, pgn_reader->save_tag_key, unescaped_tag_value);
   pgn_reader->save_tag_key[0] = 0;
   /* no error checking required -- invalid keys or Result are ignored, long values are chopped short */
 }
 
-CtMove
+bool
 ct_pgn_reader_make_move(CtPgnReader pgn_reader, char *move_notation, int line, int column)
+{
+  if (pgn_reader->error_line)        /* the parser is skipping the rest of a game it could not parse */
+    return false;
+  if (pgn_reader->variation_depth == 0)
+    pgn_reader->main_line_ply++;
+  if (pgn_reader->game_filter)
+  {
+    ct_pgn_reader_save_move(pgn_reader, move_notation, line, column);
+    return true;
+  }
+  return ct_pgn_reader_decode_move(pgn_reader, move_notation, line, column);
+}
+
+/* a comment belongs to the ply of the move before it (moves read lazily have not been made yet, so the ply is counted
+   as they are scanned) -- the annotations are only kept for the moves of the game, not the moves of variations */
+void
+ct_pgn_reader_read_comment(CtPgnReader pgn_reader, char *text, int length)
+{
+  CtGameAnnotations game_annotations;
+
+  if (pgn_reader->pgn_input == 0 || pgn_reader->error_line || pgn_reader->variation_depth > 0)
+    return;
+  game_annotations = ct_pgn_input_game_annotations(pgn_reader->pgn_input);
+  if (game_annotations == 0)
+    return;
+  ct_game_annotations_read_comment(game_annotations, pgn_reader->main_line_ply, text, length);
+}
+
+static bool
+ct_pgn_reader_decode_move(CtPgnReader pgn_reader, char *move_notation, int line, int column)
 {
   CtMove move = ct_graph_move_from_san(pgn_reader->graph, move_notation);
+  CtMoveTree move_tree = ct_pgn_reader_move_tree(pgn_reader);
 
+  if (pgn_reader->error_line)        /* a saved move after the one that could not be decoded */
+    return false;
   if (move)
+  {
     ct_graph_make_move(pgn_reader->graph, move);
+    if (move_tree)
+      pgn_reader->move_tree_node = ct_move_tree_add(move_tree, pgn_reader->move_tree_node, move);
+    if (pgn_reader->move_command && pgn_reader->variation_count == 0)
+      ct_move_command_execute(pgn_reader->move_command, move);
+  }
   else
     ct_pgn_reader_syntax_error(pgn_reader, line, column);
-  return move;
+  return move != NULL_MOVE;
+}
+
+bool
+ct_pgn_reader_start_variation(CtPgnReader pgn_reader, int line, int column)
+{
+  pgn_reader->variation_depth++;
+  if (pgn_reader->game_filter)
+  {
+    ct_pgn_reader_save_move(pgn_reader, "(", line, column);
+    return true;
+  }
+  return ct_pgn_reader_enter_variation(pgn_reader, line, column);
+}
+
+bool
+ct_pgn_reader_end_variation(CtPgnReader pgn_reader, int line, int column)
+{
+  if (pgn_reader->variation_depth == 0)
+  {
+    ct_pgn_reader_syntax_error(pgn_reader, line, column);
+    return false;
+  }
+  pgn_reader->variation_depth--;
+  if (pgn_reader->game_filter)
+  {
+    ct_pgn_reader_save_move(pgn_reader, ")", line, column);
+    return true;
+  }
+  return ct_pgn_reader_leave_variation(pgn_reader, line, column);
+}
+
+/* a variation needs a move to replace, so it cannot come first in the game or first in another variation */
+static bool
+ct_pgn_reader_enter_variation(CtPgnReader pgn_reader, int line, int column)
+{
+  CtPgnReaderVariationStruct *variation;
+  int line_start = pgn_reader->variation_count ? pgn_reader->variations[pgn_reader->variation_count - 1].ply : 0;
+  CtMoveTree move_tree = ct_pgn_reader_move_tree(pgn_reader);
+
+  if (pgn_reader->error_line || ct_graph_ply(pgn_reader->graph) <= line_start)
+  {
+    ct_pgn_reader_syntax_error(pgn_reader, line, column);
+    return false;
+  }
+  if (pgn_reader->variation_count == pgn_reader->variations_size)
+  {
+    pgn_reader->variations_size *= 2;
+    pgn_reader->variations =
+      ct_realloc(pgn_reader->variations, pgn_reader->variations_size * sizeof(CtPgnReaderVariationStruct));
+  }
+  variation = &pgn_reader->variations[pgn_reader->variation_count++];
+  variation->move = ct_graph_unmake_move(pgn_reader->graph);
+  variation->ply = ct_graph_ply(pgn_reader->graph);
+  variation->move_tree_node = pgn_reader->move_tree_node;
+  if (move_tree)
+    pgn_reader->move_tree_node = ct_move_tree_parent(move_tree, pgn_reader->move_tree_node);
+  return true;
+}
+
+/* the moves of the variation are unmade, and the move it replaced is made again */
+static bool
+ct_pgn_reader_leave_variation(CtPgnReader pgn_reader, int line, int column)
+{
+  CtPgnReaderVariationStruct *variation;
+
+  if (pgn_reader->error_line || pgn_reader->variation_count == 0)
+  {
+    ct_pgn_reader_syntax_error(pgn_reader, line, column);
+    return false;
+  }
+  variation = &pgn_reader->variations[--pgn_reader->variation_count];
+  while (ct_graph_ply(pgn_reader->graph) > variation->ply)
+    ct_graph_unmake_move(pgn_reader->graph);
+  ct_graph_make_move(pgn_reader->graph, variation->move);
+  pgn_reader->move_tree_node = variation->move_tree_node;
+  return true;
+}
+
+static CtMoveTree
+ct_pgn_reader_move_tree(CtPgnReader pgn_reader)
+{
+  return pgn_reader->pgn_input ? ct_pgn_input_move_tree(pgn_reader->pgn_input) : 0;
+}
+
+static void
+ct_pgn_reader_save_move(CtPgnReader pgn_reader, char *move_notation, int line, int column)
+{
+  int length = strlen(move_notation) + 1;
+  CtPgnReaderMoveStruct *move;
+
+  while (pgn_reader->movetext_length + length > pgn_reader->movetext_size)
+  {
+    pgn_reader->movetext_size *= 2;
+    pgn_reader->movetext = ct_realloc(pgn_reader->movetext, pgn_reader->movetext_size);
+  }
+  if (pgn_reader->move_count == pgn_reader->moves_size)
+  {
+    pgn_reader->moves_size *= 2;
+    pgn_reader->moves = ct_realloc(pgn_reader->moves, pgn_reader->moves_size * sizeof(CtPgnReaderMoveStruct));
+  }
+  move = &pgn_reader->moves[pgn_reader->move_count++];
+  move->offset = pgn_reader->movetext_length;
+  move->line = line;
+  move->column = column;
+  memcpy(pgn_reader->movetext + pgn_reader->movetext_length, move_notation, length);
+  pgn_reader->movetext_length += length;
+}
+
+static bool
+ct_pgn_reader_make_saved_moves(CtPgnReader pgn_reader)
+{
+  int index;
+
+  for (index = 0; index < pgn_reader->move_count; index++)
+  {
+    CtPgnReaderMoveStruct *saved_move = &pgn_reader->moves[index];
+    char *move_notation = pgn_reader->movetext + saved_move->offset;
+    bool is_valid;
+
+    /* the start and end of each variation are saved along with the moves */
+    if (*move_notation == '(')
+      is_valid = ct_pgn_reader_enter_variation(pgn_reader, saved_move->line, saved_move->column);
+    else if (*move_notation == ')')
+      is_valid = ct_pgn_reader_leave_variation(pgn_reader, saved_move->line, saved_move->column);
+    else
+      is_valid = ct_pgn_reader_decode_move(pgn_reader, move_notation, saved_move->line, saved_move->column);
+    if (!is_valid)
+      return false;
+  }
+  return true;
+}
+
+/* the scanner has just read the game termination, so the game ends at the current offset */
+static bool
+ct_pgn_reader_index_game(CtPgnReader pgn_reader)
+{
+  CtPgnIndex pgn_index = pgn_reader->pgn_index;
+  int game = pgn_reader->index_game++;
+  uint64_t header_hash = pgn_reader->header_hash;
+
+  pgn_reader->is_in_game = false;
+  pgn_reader->header_hash = HEADER_HASH_OFFSET_BASIS;
+  if (pgn_reader->is_building_index)
+    ct_pgn_index_add(pgn_index, pgn_reader->game_offset, pgn_reader->offset - pgn_reader->game_offset, header_hash);
+  else if (header_hash != ct_pgn_index_header_hash(pgn_index, game))
+  {
+    pgn_reader->stale_index_game = game;
+    return false;
+  }
+  return true;
+}
+
+/* the null terminator is hashed too, so that moving characters from a key to its value changes the hash */
+static void
+ct_pgn_reader_hash_header(CtPgnReader pgn_reader, char *text)
+{
+  uint64_t header_hash = pgn_reader->header_hash;
+
+  do
+  {
+    header_hash ^= (unsigned char) *text;
+    header_hash *= HEADER_HASH_PRIME;
+  }
+  while (*text++ != 0);
+  pgn_reader->header_hash = header_hash;
 }
 
 void
@@ -226,3 +829,51 @@ ct_pgn_reader_syntax_error(CtPgnReader pgn_reader, int line, int column)
     pgn_reader->error_column = column;
   }
 }
+
+/* the parser has skipped to the end of a game it could not parse -- with an error log that allows it, the error is
+   logged and reading carries on with the next game, but nothing after corrupt data can be trusted */
+bool
+ct_pgn_reader_recover(CtPgnReader pgn_reader)
+{
+  CtPgnInput pgn_input = pgn_reader->pgn_input;
+  CtPgnErrorLog pgn_error_log = pgn_input ? ct_pgn_input_error_log(pgn_input) : 0;
+  char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+
+  if (pgn_error_log == 0 || ct_pgn_error_log_policy(pgn_error_log) == PGN_ERROR_ABORT)
+    return false;
+  if (ct_pgn_input_has_error(pgn_input) || pgn_reader->stale_index_game >= 0)
+    return false;
+  ct_pgn_reader_describe_error(pgn_reader, error_message);
+  ct_pgn_error_log_add(pgn_error_log, pgn_reader->game_number, error_message);
+  pgn_reader->is_in_game = false;
+  pgn_reader->header_hash = HEADER_HASH_OFFSET_BASIS;
+  ct_pgn_reader_reset(pgn_reader);
+  pgn_reader->is_game_ready = false;        /* in case the error was found at the game termination */
+  ct_pgn_reader_end_game(pgn_reader);
+  return true;
+}
+
+/* a game has been read (or skipped), so it is safe to resume reading after it */
+static void
+ct_pgn_reader_end_game(CtPgnReader pgn_reader)
+{
+  CtPgnCheckpoint checkpoint = pgn_reader->checkpoint;
+
+  pgn_reader->game_number++;
+  pgn_reader->game_end_offset = pgn_reader->offset;
+  if (checkpoint && pgn_reader->game_number - checkpoint->game >= pgn_reader->games_between_checkpoints)
+    ct_pgn_reader_take_checkpoint(pgn_reader);
+}
+
+static void
+ct_pgn_reader_take_checkpoint(CtPgnReader pgn_reader)
+{
+  CtPgnCheckpoint checkpoint = pgn_reader->checkpoint;
+
+  if (checkpoint->game == pgn_reader->game_number)
+    return;
+  checkpoint->offset = pgn_reader->game_end_offset;
+  checkpoint->game = pgn_reader->game_number;
+  if (pgn_reader->checkpoint_command)
+    ct_command_execute(pgn_reader->checkpoint_command);
+}
@@ -0,0 +1,120 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_graph.h"
+#include "ct_graph_private.h"
+#include "ct_move_maker.h"
+#include "ct_bit_board.h"
+#include "ct_position.h"
+#include "ct_position_private.h"
+#include "ct_square.h"
+#include "ct_piece.h"
+#include "ct_move.h"
+#include <stdlib.h>                /* abs */
+
+static bool ct_graph_is_pawn_move(CtPosition position, CtPiece pawn, CtSquare from, CtSquare to);
+static bool ct_graph_is_en_passant_possible(CtPosition position, CtPiece pawn, CtSquare to);
+
+/* A move is only legal if it is the same move ct_graph_for_each_legal_move would give, including its move type.  The
+   move is checked against the piece that would make it, and then made to see that it does not leave the king in
+   check, so no other moves are generated. */
+bool
+ct_graph_is_legal_move(CtGraph graph, CtMove move)
+{
+  CtPosition position = graph->position;
+  CtPieceColor color = position->is_white_to_move ? WHITE_PIECE : BLACK_PIECE;
+  CtSquare from = ct_move_from(move);
+  CtSquare to = ct_move_to(move);
+  CtPiece piece = position->pieces[from];
+  CtPiece to_piece = position->pieces[to];
+  CtPiece promotes_to;
+  CtRank last_rank = color == WHITE_PIECE ? RANK_8 : RANK_1;
+  CtSquare king_square = color == WHITE_PIECE ? E1 : E8;
+  bool is_pseudo_legal, is_legal;
+
+  if (from == to || piece == EMPTY || ct_piece_color(piece) != color)
+    return false;
+  if (to_piece != EMPTY && ct_piece_color(to_piece) == color)
+    return false;
+  switch (ct_move_type(move))
+  {
+  case NORMAL_MOVE:
+    if (ct_piece_is_pawn(piece))
+      is_pseudo_legal = ct_square_rank(to) != last_rank && ct_graph_is_pawn_move(position, piece, from, to)
+        && (abs(to - from) != 2 * D_N || !ct_graph_is_en_passant_possible(position, piece, to));
+    else
+      is_pseudo_legal = ct_bit_board_array_is_attacking_from(position->bit_board_array, piece, from, to);
+    break;
+  case CASTLE_KINGSIDE:
+    return move == ct_move_make_castle_kingside(king_square) && (ct_position_can_castle(position) & CASTLE_K) != 0;
+  case CASTLE_QUEENSIDE:
+    return move == ct_move_make_castle_queenside(king_square) && (ct_position_can_castle(position) & CASTLE_Q) != 0;
+  case EN_PASSANT_POSSIBLE:
+    is_pseudo_legal = ct_piece_is_pawn(piece) && abs(to - from) == 2 * D_N
+      && ct_graph_is_pawn_move(position, piece, from, to) && ct_graph_is_en_passant_possible(position, piece, to);
+    break;
+  case EN_PASSANT_CAPTURE:
+    is_pseudo_legal = ct_piece_is_pawn(piece) && to_piece == EMPTY
+      && ct_square_file(to) == position->en_passant
+      && ct_square_rank(to) == (color == WHITE_PIECE ? RANK_6 : RANK_3)
+      && ct_bit_board_array_is_attacking_from(position->bit_board_array, piece, from, to);
+    break;
+  case PROMOTION:
+    /* a move type without the promotion bit promotes to EMPTY, and only a knight, bishop, rook or queen will do */
+    promotes_to = ct_move_promotes_to(move);
+    is_pseudo_legal = ct_piece_is_pawn(piece) && ct_square_rank(to) == last_rank
+      && promotes_to != EMPTY && !ct_piece_is_pawn(promotes_to) && ct_piece_to_white(promotes_to) != WHITE_KING
+      && ct_piece_color(promotes_to) == color && ct_graph_is_pawn_move(position, piece, from, to);
+    break;
+  default:
+    return false;
+  }
+  if (!is_pseudo_legal)
+    return false;
+  ct_move_maker_make(graph->move_maker, move);
+  is_legal = ct_position_is_legal(position);
+  ct_move_maker_unmake(graph->move_maker);
+  return is_legal;
+}
+
+/* steps forward one or two squares onto empty squares, or captures diagonally */
+static bool
+ct_graph_is_pawn_move(CtPosition position, CtPiece pawn, CtSquare from, CtSquare to)
+{
+  CtDirection forward = pawn == WHITE_PAWN ? D_N : D_S;
+  CtRank starting_rank = pawn == WHITE_PAWN ? RANK_2 : RANK_7;
+
+  if (to == from + forward)
+    return position->pieces[to] == EMPTY;
+  if (to == from + 2 * forward)
+    return ct_square_rank(from) == starting_rank && position->pieces[from + forward] == EMPTY
+      && position->pieces[to] == EMPTY;
+  return position->pieces[to] != EMPTY
+    && ct_bit_board_array_is_attacking_from(position->bit_board_array, pawn, from, to);
+}
+
+/* a pawn moving two squares is an EN_PASSANT_POSSIBLE move when an enemy pawn lands beside it */
+static bool
+ct_graph_is_en_passant_possible(CtPosition position, CtPiece pawn, CtSquare to)
+{
+  CtPiece enemy_pawn = pawn == WHITE_PAWN ? BLACK_PAWN : WHITE_PAWN;
+  CtFile file = ct_square_file(to);
+
+  return (file != FILE_A && position->pieces[to + D_W] == enemy_pawn)
+    || (file != FILE_H && position->pieces[to + D_E] == enemy_pawn);
+}
@@ -0,0 +1,121 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <config.h>
+#include "ct_graph.h"
+#include "ct_graph_private.h"
+#include "ct_bit_board.h"
+#include "ct_move.h"
+#include "ct_move_command.h"
+#include "ct_move_generator.h"
+#include "ct_move_maker.h"
+#include "ct_position.h"
+#include "ct_position_private.h"
+
+static void ct_graph_filter_stage_moves(void *delegate, CtMove move);
+static bool ct_graph_is_in_stage(CtGraph graph, CtMove move);
+static bool ct_graph_is_capture(CtPosition position, CtMove move);
+
+/* Only the pseudo legal moves that belong to the stage are made to test their legality, which is where most of the
+   time of generating moves goes.  In check, the only moves tried besides the king's are those that capture the
+   checking piece or step between it and the king, and in double check only the king's moves are tried.  Out of check
+   there are no evasions.  A quiet move is only tried as a quiet check once ct_position_gives_check has found it
+   checks. */
+int
+ct_graph_moves_by_stage(CtGraph graph, CtMoveStage stage, CtMove *moves)
+{
+  CtPosition position = graph->position;
+  CtPiece king = position->is_white_to_move ? WHITE_KING : BLACK_KING;
+  CtBitBoard enemies = position->bit_board_array[position->is_white_to_move ? BLACK_PIECES : WHITE_PIECES];
+  CtBitBoard checkers;
+  CtSquare checker_square;
+
+  if (graph->stage_move_generator == 0)
+  {
+    graph->filter_stage_moves = ct_move_command_new(graph, ct_graph_filter_stage_moves);
+    graph->stage_move_generator = ct_move_generator_new(position, graph->filter_stage_moves);
+  }
+  graph->stage = stage;
+  graph->stage_moves = moves;
+  graph->stage_move_count = 0;
+  graph->king_square = ct_bit_board_find_first_square(position->bit_board_array[king]);
+  if (stage == EVASION_STAGE)
+  {
+    if (graph->king_square < 0)
+      return 0;
+    checkers = ct_position_attackers_to(position, graph->king_square) & enemies;
+    if (checkers == BITB_EMPTY)
+      return 0;
+    if (checkers & (checkers - 1))
+      graph->evasion_targets = BITB_EMPTY;
+    else
+    {
+      checker_square = ct_bit_board_find_first_square(checkers);
+      graph->evasion_targets = checkers | ct_bit_board_between(graph->king_square, checker_square);
+    }
+  }
+  ct_move_generator_pseudo_legal_piece_moves(graph->stage_move_generator);
+  if (stage == QUIET_STAGE || stage == QUIET_CHECK_STAGE)
+    ct_move_generator_castle_moves(graph->stage_move_generator, graph->filter_stage_moves);
+  return graph->stage_move_count;
+}
+
+static void
+ct_graph_filter_stage_moves(void *delegate, CtMove move)
+{
+  CtGraph graph = (CtGraph) delegate;
+  CtMoveMaker move_maker = graph->move_maker;
+  bool is_wanted;
+
+  if (!ct_graph_is_in_stage(graph, move))
+    return;
+  if (graph->stage == QUIET_CHECK_STAGE && !ct_position_gives_check(graph->position, move))
+    return;
+  ct_move_maker_make(move_maker, move);
+  is_wanted = ct_position_is_legal(graph->position);
+  ct_move_maker_unmake(move_maker);
+  if (is_wanted)
+    graph->stage_moves[graph->stage_move_count++] = move;
+}
+
+static bool
+ct_graph_is_in_stage(CtGraph graph, CtMove move)
+{
+  switch (graph->stage)
+  {
+  case CAPTURE_STAGE:
+    return ct_graph_is_capture(graph->position, move);
+  case QUIET_STAGE:
+  case QUIET_CHECK_STAGE:
+    return !ct_graph_is_capture(graph->position, move);
+  case EVASION_STAGE:
+    /* a pawn captured en passant is beside the square the capture moves to, so it is left to the legality test */
+    if (ct_move_from(move) == graph->king_square)
+      return true;
+    if (ct_move_type(move) == EN_PASSANT_CAPTURE)
+      return graph->evasion_targets != BITB_EMPTY;
+    return (graph->evasion_targets & ct_bit_board_make(ct_move_to(move))) != 0;
+  }
+  return false;
+}
+
+static bool
+ct_graph_is_capture(CtPosition position, CtMove move)
+{
+  CtMoveType move_type = ct_move_type(move);
+
+  return move_type == PROMOTION || move_type == EN_PASSANT_CAPTURE || position->pieces[ct_move_to(move)] != EMPTY;
+}
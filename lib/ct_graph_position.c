@@ -19,10 +19,13 @@
 #include "ct_graph.h"
 #include "ct_graph_private.h"
 #include "ct_position.h"
+#include "ct_move_maker.h"
+#include "ct_move_stack.h"
 #include <string.h>
 #include <stdio.h>
 
 static CtPosition default_graph_to_position;
+static CtPosition default_graph_position_at;
 static CtGraph default_graph_from_position;
 static char default_graph_to_fen[CT_FEN_MAX_LENGTH];
 static CtGraph default_graph_from_fen;
@@ -32,6 +35,7 @@ void
 ct_graph_position_init(void)
 {
   default_graph_to_position = ct_position_new();
+  default_graph_position_at = ct_position_new();
   default_graph_from_position = ct_graph_new();
   default_graph_from_fen = ct_graph_new();
 }
@@ -45,6 +49,32 @@ ct_graph_to_position(CtGraph graph, CtPosition position)
   return position;
 }
 
+/* the position is found with the scratch position, so the graph is left where it is */
+CtPosition
+ct_graph_position_at(CtGraph graph, int ply, CtPosition position)
+{
+  int index;
+
+  if (ply < 0 || ply > ct_graph_line_length(graph))
+    return 0;
+  if (position == 0)
+    position = default_graph_position_at;
+  if (ply == graph->ply)
+  {
+    ct_position_copy(position, graph->position);
+    return position;
+  }
+  index = ply / GRAPH_SNAPSHOT_INTERVAL;
+  if (index >= graph->snapshot_count)
+    index = graph->snapshot_count - 1;
+  ct_position_copy(graph->scratch_position, graph->snapshots[index]);
+  ct_move_maker_reset(graph->scratch_move_maker);
+  for (index *= GRAPH_SNAPSHOT_INTERVAL; index < ply; index++)
+    ct_move_maker_make(graph->scratch_move_maker, ct_move_stack_get(graph->move_stack, index));
+  ct_position_copy(position, graph->scratch_position);
+  return position;
+}
+
 CtGraph
 ct_graph_from_position(CtGraph graph, CtPosition position)
 {
@@ -19,7 +19,7 @@
 #include "ct_move_generator.h"
 #include "ct_utilities.h"
 #include "ct_piece.h"
-#include "ct_piece_command.h"
+#include "ct_bit_board.h"
 #include "ct_move_command.h"
 #include "ct_position.h"
 #include "ct_move.h"
@@ -46,7 +46,9 @@ typedef struct CtMoveGeneratorStruct
 
 static CtPieceMovers ct_piece_mgs_new(CtPosition position, CtMoveCommand pseudo_legal_move_command, CtPieceColor piece_color);
 static void ct_piece_mgs_free(CtPieceMovers piece_mgs);
-static void ct_move_generator_pseudo_legal_piece_moves_execute(void *delegate, CtPiece piece, CtSquare square);
+static void ct_move_generator_white_piece_moves(CtMoveGenerator move_generator);
+static void ct_move_generator_black_piece_moves(CtMoveGenerator move_generator);
+static void ct_move_generator_pseudo_legal_piece_moves_execute(CtPieceMovers piece_mgs, CtPiece piece, CtSquare square);
 
 CtMoveGenerator
 ct_move_generator_new(CtPosition position, CtMoveCommand pseudo_legal_move_command)
@@ -98,25 +100,43 @@ ct_piece_mgs_free(CtPieceMovers piece_mgs)
 void
 ct_move_generator_pseudo_legal_piece_moves(CtMoveGenerator move_generator)
 {
-  CtPosition position = move_generator->position;
-  bool is_wtm = ct_position_is_white_to_move(position);
-  CtPieceMovers piece_mgs = is_wtm ? move_generator->white_piece_mgs : move_generator->black_piece_mgs;
-  CtPieceCommandStruct piece_command_struct = ct_piece_command_make(piece_mgs, ct_move_generator_pseudo_legal_piece_moves_execute);
-
-  ct_position_for_each_active_piece(position, &piece_command_struct);
+  if (ct_position_is_white_to_move(move_generator->position))
+    ct_move_generator_white_piece_moves(move_generator);
+  else
+    ct_move_generator_black_piece_moves(move_generator);
 }
 
+/* All of the pawns are moved together, and then the other pieces one at a time.  The generator is expanded once for
+   each color, so the color to move is only tested once for each position. */
+#define CT_MOVE_GENERATOR_PIECE_MOVES(color, COLOR)                                                                   \
+  static void                                                                                                         \
+  ct_move_generator_##color##_piece_moves(CtMoveGenerator move_generator)                                             \
+  {                                                                                                                   \
+    CtPosition position = move_generator->position;                                                                   \
+    CtPieceMovers piece_mgs = move_generator->color##_piece_mgs;                                                      \
+    CtBitBoard pieces = ct_position_get_bit_board(position, COLOR##_PIECES);                                          \
+    CtSquare square;                                                                                                  \
+                                                                                                                      \
+    ct_##color##_pawn_moves(piece_mgs->pawn, position);                                                               \
+    pieces &= ~ct_position_get_bit_board(position, COLOR##_PAWN);                                                     \
+    while (pieces)                                                                                                    \
+    {                                                                                                                 \
+      square = ct_bit_board_find_first_square(pieces);                                                                \
+      pieces &= pieces - 1;                                                                                           \
+      ct_move_generator_pseudo_legal_piece_moves_execute(piece_mgs, ct_position_get_piece(position, square), square); \
+    }                                                                                                                 \
+  }
+
+CT_MOVE_GENERATOR_PIECE_MOVES(white, WHITE)
+CT_MOVE_GENERATOR_PIECE_MOVES(black, BLACK)
+
 static void
-ct_move_generator_pseudo_legal_piece_moves_execute(void *delegate, CtPiece piece, CtSquare square)
+ct_move_generator_pseudo_legal_piece_moves_execute(CtPieceMovers piece_mgs, CtPiece piece, CtSquare square)
 {
-  CtPieceMovers piece_mgs = (CtPieceMovers) delegate;
-
   if (piece & SLIDER_BIT)
     ct_slider_move(piece_mgs->sliders[piece & SLIDER_MASK], piece_mgs->position, square);
-  else if (piece & STEPER_BIT)
-    ct_steper_move(piece_mgs->stepers[piece & STEPER_MASK], piece_mgs->position, square);
   else
-    ct_pawn_move(piece_mgs->pawn, piece_mgs->position, square);
+    ct_steper_move(piece_mgs->stepers[piece & STEPER_MASK], piece_mgs->position, square);
 }
 
 void
@@ -29,22 +29,7 @@ typedef struct CtMoveMakerStruct
   CtUndoPosition undo_position;
 } CtMoveMakerStruct;
 
-static CtCastleRights castle_mask[64];
-
-void
-ct_move_maker_init(void)
-{
-  CtSquare square;
-
-  for (square = A1; square < NUMBER_OF_SQUARES; square++)
-    castle_mask[square] = CASTLE_NONE;
-  castle_mask[A1] = CASTLE_Q;
-  castle_mask[E1] = CASTLE_KQ;
-  castle_mask[H1] = CASTLE_K;
-  castle_mask[A8] = CASTLE_q;
-  castle_mask[E8] = CASTLE_kq;
-  castle_mask[H8] = CASTLE_k;
-}
+#include "ct_move_maker_tables.h"
 
 CtMoveMaker
 ct_move_maker_new(CtPosition position)
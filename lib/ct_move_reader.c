@@ -25,6 +25,7 @@
 #include "ct_position.h"
 #include "ct_piece.h"
 #include <string.h>
+#include <stdlib.h>                /* abs */
 
 enum
 {
@@ -32,6 +33,11 @@ enum
   COMPARE_MOVE_FROM_RANK = 0x10, COMPARE_MOVE_PROMOTES_TO = 0x20
 };
 
+enum
+{
+  SAN_TOKEN_MAX_LENGTH = 32        /* room for a move with a few annotation marks after it */
+};
+
 typedef struct CtMoveReaderStruct *CtMoveReader;
 typedef struct CtMoveReaderStruct
 {
@@ -50,6 +56,7 @@ typedef struct CtMoveReaderStruct
 
 static void ct_move_reader_init(CtMoveReader move_reader, CtGraph graph);
 static void ct_move_reader_consider_move(void *delegate, CtMove move);
+static bool ct_move_reader_is_square(char *notation);
 
 CtMove
 ct_graph_move_from_san(CtGraph graph, char *notation)
@@ -179,6 +186,102 @@ ct_graph_move_from_san(CtGraph graph, char *notation)
   return move_reader->result;
 }
 
+/* the moves are separated by white space, and each one is made before the next is read -- returns the number of moves
+   read, or -1 (with the moves already made unmade again) if one of them is not a legal move or there are more than
+   max_moves */
+int
+ct_graph_line_from_san(CtGraph graph, char *notation, CtMove *moves, int max_moves)
+{
+  char move_notation[SAN_TOKEN_MAX_LENGTH + 1];
+  int move_count = 0;
+  size_t length;
+  CtMove move;
+
+  for (;;)
+  {
+    notation += strspn(notation, " \t\r\n");
+    if (*notation == 0)
+      return move_count;
+    length = strcspn(notation, " \t\r\n");
+    if (length > SAN_TOKEN_MAX_LENGTH || move_count == max_moves)
+      break;
+    memcpy(move_notation, notation, length);
+    move_notation[length] = 0;
+    notation += length;
+    move = ct_graph_move_from_san(graph, move_notation);
+    if (move == NULL_MOVE || move == AMBIGUOUS_MOVE)
+      break;
+    ct_graph_make_move(graph, move);
+    moves[move_count++] = move;
+  }
+  while (move_count-- > 0)
+    ct_graph_unmake_move(graph);
+  return -1;
+}
+
+/* the notation only gives the squares, so the move type comes from the piece that moves -- the move is checked with
+   ct_graph_is_legal_move instead of generating every legal move */
+CtMove
+ct_graph_move_from_uci(CtGraph graph, char *notation)
+{
+  CtPosition position = graph->position;
+  CtSquare from, to;
+  CtPiece piece;
+  bool is_white;
+  CtMove move;
+
+  if (!ct_move_reader_is_square(notation) || !ct_move_reader_is_square(notation + 2))
+    return NULL_MOVE;
+  from = ct_square_make(ct_file_from_char(notation[0]), ct_rank_from_char(notation[1]));
+  to = ct_square_make(ct_file_from_char(notation[2]), ct_rank_from_char(notation[3]));
+  piece = ct_position_get_piece(position, from);
+  is_white = ct_position_is_white_to_move(position);
+  if (notation[4] != 0)
+  {
+    if (notation[5] != 0)
+      return NULL_MOVE;
+    switch (notation[4])
+    {
+    case 'q':
+      move = is_white ? ct_move_make_promotion_Q(from, to) : ct_move_make_promotion_q(from, to);
+      break;
+    case 'r':
+      move = is_white ? ct_move_make_promotion_R(from, to) : ct_move_make_promotion_r(from, to);
+      break;
+    case 'b':
+      move = is_white ? ct_move_make_promotion_B(from, to) : ct_move_make_promotion_b(from, to);
+      break;
+    case 'n':
+      move = is_white ? ct_move_make_promotion_N(from, to) : ct_move_make_promotion_n(from, to);
+      break;
+    default:
+      return NULL_MOVE;
+    }
+  }
+  else if ((piece == WHITE_KING || piece == BLACK_KING) && to == from + 2 * D_E)
+    move = ct_move_make_castle_kingside(from);
+  else if ((piece == WHITE_KING || piece == BLACK_KING) && to == from + 2 * D_W)
+    move = ct_move_make_castle_queenside(from);
+  else if (ct_piece_is_pawn(piece) && abs(to - from) == 2 * D_N)
+  {
+    move = ct_move_make_en_passant_possible(from, to);
+    if (!ct_graph_is_legal_move(graph, move))
+      move = ct_move_make(from, to);
+  }
+  else if (ct_piece_is_pawn(piece) && ct_square_file(from) != ct_square_file(to)
+           && ct_position_get_piece(position, to) == EMPTY)
+    move = ct_move_make_en_passant_capture(from, to);
+  else
+    move = ct_move_make(from, to);
+  return ct_graph_is_legal_move(graph, move) ? move : NULL_MOVE;
+}
+
+static bool
+ct_move_reader_is_square(char *notation)
+{
+  return notation[0] >= 'a' && notation[0] <= 'h' && notation[1] >= '1' && notation[1] <= '8';
+}
+
 static void
 ct_move_reader_init(CtMoveReader move_reader, CtGraph graph)
 {
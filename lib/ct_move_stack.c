@@ -105,6 +105,22 @@ ct_move_stack_length(CtMoveStack move_stack)
   return move_stack->move_sp - move_stack->move_stack;
 }
 
+CtMove
+ct_move_stack_get(CtMoveStack move_stack, unsigned int index)
+{
+  if (index >= ct_move_stack_length(move_stack))
+    return NULL_MOVE;
+  return move_stack->move_stack[index];
+}
+
+/* pops moves until there are no more than length left */
+void
+ct_move_stack_truncate(CtMoveStack move_stack, unsigned int length)
+{
+  if (length < ct_move_stack_length(move_stack))
+    move_stack->move_sp = move_stack->move_stack + length;
+}
+
 CtMoveCommand
 ct_move_stack_push_command(CtMoveStack move_stack)
 {
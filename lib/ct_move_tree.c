@@ -0,0 +1,181 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_move_tree.h"
+#include "ct_move_command.h"
+#include "ct_graph.h"
+#include "ct_utilities.h"
+
+enum
+{
+  INITIAL_NODES_SIZE = 256
+};
+
+/* the move is stored with the links, so that a node is only as big as its move and three node numbers */
+typedef struct CtMoveTreeNodeStruct
+{
+  CtMove move;
+  int32_t parent;
+  int32_t first_child;
+  int32_t next_sibling;
+} CtMoveTreeNodeStruct;
+
+typedef struct CtMoveTreeStruct
+{
+  CtMoveTreeNodeStruct *nodes;
+  int node_count;
+  int nodes_size;
+  int visited_node;
+} CtMoveTreeStruct;
+
+CtMoveTree
+ct_move_tree_new(void)
+{
+  CtMoveTree move_tree;
+
+  move_tree = ct_malloc(sizeof(CtMoveTreeStruct));
+  move_tree->nodes = ct_malloc(INITIAL_NODES_SIZE * sizeof(CtMoveTreeNodeStruct));
+  move_tree->nodes_size = INITIAL_NODES_SIZE;
+  ct_move_tree_reset(move_tree);
+  return move_tree;
+}
+
+void
+ct_move_tree_free(CtMoveTree move_tree)
+{
+  ct_free(move_tree->nodes);
+  ct_free(move_tree);
+}
+
+/* the memory for the nodes is kept, so reading game after game into the same tree does not allocate */
+void
+ct_move_tree_reset(CtMoveTree move_tree)
+{
+  CtMoveTreeNodeStruct *root = &move_tree->nodes[MOVE_TREE_ROOT];
+
+  root->move = NULL_MOVE;
+  root->parent = MOVE_TREE_NONE;
+  root->first_child = MOVE_TREE_NONE;
+  root->next_sibling = MOVE_TREE_NONE;
+  move_tree->node_count = 1;
+  move_tree->visited_node = MOVE_TREE_NONE;
+}
+
+/* returns the node for the move after parent, which is only added if parent does not already have it -- the new node
+   goes after the existing children, so the first move added after a node stays its main line */
+int
+ct_move_tree_add(CtMoveTree move_tree, int parent, CtMove move)
+{
+  CtMoveTreeNodeStruct *node;
+  int32_t *link = &move_tree->nodes[parent].first_child;
+
+  while (*link != MOVE_TREE_NONE)
+  {
+    if (move_tree->nodes[*link].move == move)
+      return *link;
+    link = &move_tree->nodes[*link].next_sibling;
+  }
+  if (move_tree->node_count == move_tree->nodes_size)
+  {
+    int32_t link_offset = (char *) link - (char *) move_tree->nodes;
+
+    move_tree->nodes_size *= 2;
+    move_tree->nodes = ct_realloc(move_tree->nodes, move_tree->nodes_size * sizeof(CtMoveTreeNodeStruct));
+    link = (int32_t *) ((char *) move_tree->nodes + link_offset);
+  }
+  *link = move_tree->node_count;
+  node = &move_tree->nodes[move_tree->node_count];
+  node->move = move;
+  node->parent = parent;
+  node->first_child = MOVE_TREE_NONE;
+  node->next_sibling = MOVE_TREE_NONE;
+  return move_tree->node_count++;
+}
+
+int
+ct_move_tree_node_count(CtMoveTree move_tree)
+{
+  return move_tree->node_count;
+}
+
+CtMove
+ct_move_tree_move(CtMoveTree move_tree, int node)
+{
+  return move_tree->nodes[node].move;
+}
+
+int
+ct_move_tree_parent(CtMoveTree move_tree, int node)
+{
+  return move_tree->nodes[node].parent;
+}
+
+int
+ct_move_tree_first_child(CtMoveTree move_tree, int node)
+{
+  return move_tree->nodes[node].first_child;
+}
+
+int
+ct_move_tree_next_sibling(CtMoveTree move_tree, int node)
+{
+  return move_tree->nodes[node].next_sibling;
+}
+
+/* visits the nodes depth first, main line before variations, making each move on the way down and unmaking it on the
+   way back up -- only the graph's own move stack is used, so deep trees do not need any more memory */
+void
+ct_move_tree_for_each_move(CtMoveTree move_tree, CtGraph graph, CtMoveCommand move_command)
+{
+  CtMoveTreeNodeStruct *nodes = move_tree->nodes;
+  int node = nodes[MOVE_TREE_ROOT].first_child;
+
+  while (node != MOVE_TREE_NONE)
+  {
+    ct_graph_make_move(graph, nodes[node].move);
+    move_tree->visited_node = node;
+    ct_move_command_execute(move_command, nodes[node].move);
+    nodes = move_tree->nodes;        /* in case the command added to the tree */
+    if (nodes[node].first_child != MOVE_TREE_NONE)
+    {
+      node = nodes[node].first_child;
+      continue;
+    }
+    /* back up until there is a variation that has not been visited */
+    do
+    {
+      ct_graph_unmake_move(graph);
+      if (nodes[node].next_sibling != MOVE_TREE_NONE)
+      {
+        node = nodes[node].next_sibling;
+        break;
+      }
+      node = nodes[node].parent;
+    }
+    while (node != MOVE_TREE_ROOT);
+    if (node == MOVE_TREE_ROOT)
+      node = MOVE_TREE_NONE;
+  }
+  move_tree->visited_node = MOVE_TREE_NONE;
+}
+
+int
+ct_move_tree_visited_node(CtMoveTree move_tree)
+{
+  return move_tree->visited_node;
+}
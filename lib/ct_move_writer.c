@@ -18,6 +18,7 @@
 #include <config.h>
 #include "ct_graph.h"
 #include "ct_graph_private.h"
+#include "ct_move_maker.h"
 #include "ct_move.h"
 #include "ct_position.h"
 #include "ct_move_command.h"
@@ -52,10 +53,13 @@ typedef struct CtMoveWriterStruct
   bool ambiguous_file;
   bool is_check;
   bool is_checkmate;
+  bool adds_check;                /* false when the caller adds the check or checkmate after making the move */
 } CtMoveWriterStruct;
 
 static char default_destination_graph[CT_SAN_MAX_LENGTH];
+static char default_destination_without_check[CT_SAN_MAX_LENGTH];
 static char default_destination_move[CT_MOVE_TO_S_MAX_LENGTH];
+static char default_destination_uci[CT_UCI_MAX_LENGTH];
 
 static void ct_move_writer_init(CtMoveWriter move_writer, CtGraph graph, char *destination);
 static void ct_move_writer_disect_move(CtMoveWriter move_writer, CtMove move);
@@ -64,18 +68,69 @@ static void ct_move_writer_check_for_checkmate(void *delegate, CtMove other_move
 static void ct_move_writer_describe_without_graph(CtMoveWriter move_writer);
 static void ct_move_writer_describe_with_graph(CtMoveWriter move_writer);
 static void ct_move_writer_add_check_or_checkmate(CtMoveWriter move_writer);
+static char *ct_move_writer_write(CtGraph graph, CtMove move, char *destination, bool adds_check);
 
 char *
 ct_graph_move_to_san(CtGraph graph, CtMove move, char *destination)
+{
+  if (destination == 0)
+    destination = default_destination_graph;
+  return ct_move_writer_write(graph, move, destination, true);
+}
+
+/* the check or checkmate is left off, to be added by ct_graph_add_check_to_san once the move has been made -- the
+   legal moves of the new position then serve for both that and the next move's ambiguity */
+char *
+ct_graph_move_to_san_without_check(CtGraph graph, CtMove move, char *destination)
+{
+  if (destination == 0)
+    destination = default_destination_without_check;
+  return ct_move_writer_write(graph, move, destination, false);
+}
+
+char *
+ct_graph_add_check_to_san(CtGraph graph, char *notation)
+{
+  if (ct_position_is_check(graph->position))
+    strcat(notation, ct_graph_legal_move_count(graph) == 0 ? "#" : "+");
+  return notation;
+}
+
+/* each move is written and then made, so every ply's legal moves are generated once -- a line can be too long for a
+   shared destination, so one is required */
+char *
+ct_graph_line_to_san(CtGraph graph, CtMove *moves, int move_count, char *destination)
+{
+  char *output = destination;
+  int index;
+
+  if (destination == 0)
+  {
+    ct_error("ct_graph_line_to_san: a destination is required");
+    return 0;
+  }
+  *output = 0;
+  for (index = 0; index < move_count; index++)
+  {
+    if (index > 0)
+      *output++ = ' ';
+    ct_graph_move_to_san_without_check(graph, moves[index], output);
+    ct_graph_make_move(graph, moves[index]);
+    output = strchr(ct_graph_add_check_to_san(graph, output), 0);
+  }
+  return destination;
+}
+
+static char *
+ct_move_writer_write(CtGraph graph, CtMove move, char *destination, bool adds_check)
 {
   CtMoveWriterStruct move_writer_struct;
   CtMoveWriter move_writer = &move_writer_struct;
   char *result;
   bool has_graph;
 
-  if (destination == 0)
-    destination = default_destination_graph;
   ct_move_writer_init(move_writer, graph, destination);
+  move_writer->adds_check = adds_check;
   has_graph = move_writer->graph != 0;
   ct_move_writer_disect_move(move_writer, move);
   result = move_writer->output;
@@ -96,7 +151,8 @@ ct_graph_move_to_san(CtGraph graph, CtMove move, char *destination)
   }
   if (has_graph)
   {
-    ct_move_writer_add_check_or_checkmate(move_writer);
+    if (move_writer->adds_check)
+      ct_move_writer_add_check_or_checkmate(move_writer);
     if (move_writer->output - result >= CT_SAN_MAX_LENGTH)
       ct_error("ct_graph_move_to_san: CT_SAN_MAX_LENGTH is not big enough");
   }
@@ -116,6 +172,29 @@ ct_move_to_s(CtMove move, char *destination)
   return ct_graph_move_to_san(0, move, destination);
 }
 
+/* the graph is not needed to write coordinates, castling is written as the king's move and a null move as 0000 */
+char *
+ct_graph_move_to_uci(CtGraph graph, CtMove move, char *destination)
+{
+  CtSquare from = ct_move_from(move);
+  CtSquare to = ct_move_to(move);
+  char *ct;
+
+  if (destination == 0)
+    destination = default_destination_uci;
+  if (move == NULL_MOVE)
+    return strcpy(destination, "0000");
+  ct = destination;
+  *ct++ = ct_file_to_char(ct_square_file(from));
+  *ct++ = ct_rank_to_char(ct_square_rank(from));
+  *ct++ = ct_file_to_char(ct_square_file(to));
+  *ct++ = ct_rank_to_char(ct_square_rank(to));
+  if (ct_move_type(move) == PROMOTION)
+    *ct++ = tolower(ct_piece_to_char(ct_move_promotes_to(move)));
+  *ct = 0;
+  return destination;
+}
+
 static void
 ct_move_writer_init(CtMoveWriter move_writer, CtGraph graph, char *destination)
 {
@@ -157,17 +236,20 @@ ct_move_writer_disect_move(CtMoveWriter move_writer, CtMove move)
     move_writer->ambiguous_rank = false;
     move_writer->ambiguous_file = false;
     ct_graph_for_each_legal_move(graph, &move_writer->check_for_ambiguity);
+    if (!move_writer->adds_check)
+      return;
 
-    ct_graph_make_move(move_writer->graph, move);
+    /* the move is only tried, so it is made without disturbing the graph's line */
+    ct_move_maker_make(graph->move_maker, move);
     move_writer->is_check = ct_position_is_check(move_writer->position);
     if (move_writer->is_check)
     {
       move_writer->is_checkmate = true;        /* any legal move will change this to false */
-      ct_graph_for_each_legal_move(graph, &move_writer->check_for_checkmate);
+      ct_graph_generate_legal_moves(graph, &move_writer->check_for_checkmate);
     }
     else
       move_writer->is_checkmate = false;
-    ct_graph_unmake_move(move_writer->graph);
+    ct_move_maker_unmake(graph->move_maker);
   }
 }
 
@@ -19,28 +19,23 @@
 #include "ct_pawn.h"
 #include "ct_utilities.h"
 #include "ct_square.h"
-#include "ct_piece.h"
 #include "ct_position.h"
 #include "ct_move_command.h"
 #include "ct_move.h"
-#include <stdlib.h>                /* abs */
+#include "ct_bit_board.h"
 
+/* Moves are found for a set of pawns at once by shifting their bit board.  Offsets are added to a square, so a
+   positive offset shifts the bit board left. */
 typedef struct CtPawnStruct
 {
   CtMoveCommand move_command;
   CtPieceColor piece_color;
-  int forward_offset;
-  int forward_two_offset;
-  int diagonal_queenside_offset;
-  int diagonal_kingside_offset;
-  CtPiece enemy_pawn;
-  int starting_rank;
-  int second_to_last_rank;
-  int capture_en_passant_from_rank;
-  int capture_en_passant_to_rank;
 } CtPawnStruct;
 
-static void ct_pawn_move_promotion(CtPawn pawn, CtSquare from, CtSquare to);
+static void ct_pawn_generate_white(CtPawn pawn, CtPosition position, CtBitBoard pawns);
+static void ct_pawn_generate_black(CtPawn pawn, CtPosition position, CtBitBoard pawns);
+static CtBitBoard ct_pawn_shift(CtBitBoard bit_board, int offset);
+static void ct_pawn_moves_to(CtPawn pawn, CtBitBoard targets, int offset, CtMove (*move_make) (CtSquare, CtSquare));
 
 CtPawn
 ct_pawn_new(CtMoveCommand move_command, CtPieceColor piece_color)
@@ -50,30 +45,6 @@ ct_pawn_new(CtMoveCommand move_command, CtPieceColor piece_color)
   pawn = ct_malloc(sizeof(CtPawnStruct));
   pawn->move_command = move_command;
   pawn->piece_color = piece_color;
-  if (piece_color == WHITE_PIECE)
-  {
-    pawn->forward_offset = D_N;
-    pawn->forward_two_offset = 2 * D_N;
-    pawn->diagonal_queenside_offset = D_NW;
-    pawn->diagonal_kingside_offset = D_NE;
-    pawn->enemy_pawn = BLACK_PAWN;
-    pawn->starting_rank = RANK_2;
-    pawn->second_to_last_rank = RANK_7;
-    pawn->capture_en_passant_from_rank = RANK_5;
-    pawn->capture_en_passant_to_rank = RANK_6;
-  }
-  else
-  {
-    pawn->forward_offset = D_S;
-    pawn->forward_two_offset = 2 * D_S;
-    pawn->diagonal_queenside_offset = D_SW;
-    pawn->diagonal_kingside_offset = D_SE;
-    pawn->enemy_pawn = WHITE_PAWN;
-    pawn->starting_rank = RANK_7;
-    pawn->second_to_last_rank = RANK_2;
-    pawn->capture_en_passant_from_rank = RANK_4;
-    pawn->capture_en_passant_to_rank = RANK_3;
-  }
   return pawn;
 }
 
@@ -83,119 +54,111 @@ ct_pawn_free(CtPawn pawn)
   ct_free(pawn);
 }
 
-
 void
 ct_pawn_move(CtPawn pawn, CtPosition position, CtSquare from)
 {
-  CtMoveCommand move_command = pawn->move_command;
-  CtFile from_file = ct_square_file(from);
-  CtRank from_rank = ct_square_rank(from);
-  CtFile en_passant_file;
-  CtSquare to_forward, to_forward_two, to_queenside, to_kingside, en_passant_square;
-  CtPiece to_piece;
-  bool able_to_move_forward = false;
-  bool able_to_move_forward_two = false;
-  bool able_to_capture_queenside = false;
-  bool able_to_capture_kingside = false;
-  bool en_passant_possible = false;
-  bool can_capture_en_passant = false;
-  CtMove move;
-
-  to_forward = from + pawn->forward_offset;
-  to_piece = ct_position_get_piece(position, to_forward);
-  if (to_piece == EMPTY)
-    able_to_move_forward = true;
+  if (pawn->piece_color == WHITE_PIECE)
+    ct_pawn_generate_white(pawn, position, ct_bit_board_make(from));
+  else
+    ct_pawn_generate_black(pawn, position, ct_bit_board_make(from));
+}
 
-  if (from_file != FILE_A)
-  {
-    to_queenside = from + pawn->diagonal_queenside_offset;
-    to_piece = ct_position_get_piece(position, to_queenside);
-    if (to_piece != EMPTY && ct_piece_color(to_piece) != pawn->piece_color)
-      able_to_capture_queenside = true;
-  }
+void
+ct_pawn_moves(CtPawn pawn, CtPosition position)
+{
+  if (pawn->piece_color == WHITE_PIECE)
+    ct_white_pawn_moves(pawn, position);
+  else
+    ct_black_pawn_moves(pawn, position);
+}
 
-  if (from_file != LAST_FILE)
-  {
-    to_kingside = from + pawn->diagonal_kingside_offset;
-    to_piece = ct_position_get_piece(position, to_kingside);
-    if (to_piece != EMPTY && ct_piece_color(to_piece) != pawn->piece_color)
-      able_to_capture_kingside = true;
-  }
+/* for callers that already know the color of the pawn */
+void
+ct_white_pawn_moves(CtPawn pawn, CtPosition position)
+{
+  ct_pawn_generate_white(pawn, position, ct_position_get_bit_board(position, WHITE_PAWN));
+}
 
-  if (able_to_move_forward && from_rank == pawn->starting_rank)
-  {
-    to_forward_two = from + pawn->forward_two_offset;
-    to_piece = ct_position_get_piece(position, to_forward_two);
-    if (to_piece == EMPTY)
-      able_to_move_forward_two = true;
-  }
+void
+ct_black_pawn_moves(CtPawn pawn, CtPosition position)
+{
+  ct_pawn_generate_black(pawn, position, ct_position_get_bit_board(position, BLACK_PAWN));
+}
 
-  if (able_to_move_forward_two)
-  {
-    if (from_file != FILE_A)
-      en_passant_possible = ct_position_get_piece(position, to_forward_two + D_W) == pawn->enemy_pawn;
-    if (!en_passant_possible && from_file != LAST_FILE)
-      en_passant_possible = ct_position_get_piece(position, to_forward_two + D_E) == pawn->enemy_pawn;
+/* The generator is written once and expanded for each color, so the directions and ranks are constants.  The moves of
+   a single pawn come out in the same order as they always have: forward one and two squares, the captures toward the
+   queenside and the kingside, and then en passant.  Pawns that reach AFTER_ONE_STEP_RANK on their first step may take
+   a second one. */
+#define CT_PAWN_GENERATE(color, ENEMY, FORWARD, QUEENSIDE, KINGSIDE, AFTER_ONE_STEP_RANK, LAST_RANK, EN_PASSANT_RANK, \
+                         Q, R, B, N)                                                                                  \
+  static void                                                                                                         \
+  ct_pawn_promotions_to_##color(CtPawn pawn, CtBitBoard targets, int offset)                                          \
+  {                                                                                                                   \
+    CtMoveCommand move_command = pawn->move_command;                                                                  \
+    CtSquare from, to;                                                                                                \
+                                                                                                                      \
+    while (targets)                                                                                                   \
+    {                                                                                                                 \
+      to = ct_bit_board_find_first_square(targets);                                                                   \
+      targets &= targets - 1;                                                                                         \
+      from = to - offset;                                                                                             \
+      ct_move_command_execute(move_command, ct_move_make_promotion_##Q(from, to));                                    \
+      ct_move_command_execute(move_command, ct_move_make_promotion_##R(from, to));                                    \
+      ct_move_command_execute(move_command, ct_move_make_promotion_##B(from, to));                                    \
+      ct_move_command_execute(move_command, ct_move_make_promotion_##N(from, to));                                    \
+    }                                                                                                                 \
+  }                                                                                                                   \
+                                                                                                                      \
+  static void                                                                                                         \
+  ct_pawn_generate_##color(CtPawn pawn, CtPosition position, CtBitBoard pawns)                                        \
+  {                                                                                                                   \
+    CtBitBoard empty = ct_position_get_bit_board(position, EMPTY);                                                    \
+    CtBitBoard enemies = ct_position_get_bit_board(position, ENEMY##_PIECES);                                         \
+    CtBitBoard enemy_pawns = ct_position_get_bit_board(position, ENEMY##_PAWN);                                       \
+    CtBitBoard last_rank = BITB_RANK_1 << (LAST_RANK * NUMBER_OF_FILES);                                              \
+    CtFile en_passant_file = ct_position_get_en_passant(position);                                                    \
+    CtBitBoard one_step, two_steps, beside_enemy_pawns, to_queenside, to_kingside, en_passant;                        \
+                                                                                                                      \
+    one_step = ct_pawn_shift(pawns, FORWARD) & empty;                                                                 \
+    two_steps = ct_pawn_shift(one_step & (BITB_RANK_1 << (AFTER_ONE_STEP_RANK * NUMBER_OF_FILES)), FORWARD) & empty;  \
+    beside_enemy_pawns = ((enemy_pawns & ~BITB_FILE_H) << 1) | ((enemy_pawns & ~BITB_FILE_A) >> 1);                   \
+    to_queenside = ct_pawn_shift(pawns & ~BITB_FILE_A, QUEENSIDE);                                                    \
+    to_kingside = ct_pawn_shift(pawns & ~BITB_FILE_H, KINGSIDE);                                                      \
+                                                                                                                      \
+    ct_pawn_promotions_to_##color(pawn, one_step & last_rank, FORWARD);                                               \
+    ct_pawn_moves_to(pawn, one_step & ~last_rank, FORWARD, ct_move_make);                                             \
+    ct_pawn_moves_to(pawn, two_steps & ~beside_enemy_pawns, 2 * FORWARD, ct_move_make);                               \
+    ct_pawn_moves_to(pawn, two_steps & beside_enemy_pawns, 2 * FORWARD, ct_move_make_en_passant_possible);            \
+    ct_pawn_promotions_to_##color(pawn, to_queenside & enemies & last_rank, QUEENSIDE);                               \
+    ct_pawn_moves_to(pawn, to_queenside & enemies & ~last_rank, QUEENSIDE, ct_move_make);                             \
+    ct_pawn_promotions_to_##color(pawn, to_kingside & enemies & last_rank, KINGSIDE);                                 \
+    ct_pawn_moves_to(pawn, to_kingside & enemies & ~last_rank, KINGSIDE, ct_move_make);                               \
+    if (en_passant_file != NO_EN_PASSANT)                                                                             \
+    {                                                                                                                 \
+      en_passant = ct_bit_board_make(ct_square_make(en_passant_file, EN_PASSANT_RANK));                               \
+      ct_pawn_moves_to(pawn, to_queenside & en_passant, QUEENSIDE, ct_move_make_en_passant_capture);                  \
+      ct_pawn_moves_to(pawn, to_kingside & en_passant, KINGSIDE, ct_move_make_en_passant_capture);                    \
+    }                                                                                                                 \
   }
 
-  if (from_rank == pawn->capture_en_passant_from_rank)
-  {
-    en_passant_file = ct_position_get_en_passant(position);
-    if (en_passant_file != NO_EN_PASSANT && abs(en_passant_file - from_file) == 1)
-      can_capture_en_passant = true;
-  }
+CT_PAWN_GENERATE(white, BLACK, D_N, D_NW, D_NE, RANK_3, RANK_8, RANK_6, Q, R, B, N)
+CT_PAWN_GENERATE(black, WHITE, D_S, D_SW, D_SE, RANK_6, RANK_1, RANK_3, q, r, b, n)
 
-  if (from_rank == pawn->second_to_last_rank)
-  {
-    if (able_to_move_forward)
-      ct_pawn_move_promotion(pawn, from, to_forward);
-    if (able_to_capture_queenside)
-      ct_pawn_move_promotion(pawn, from, to_queenside);
-    if (able_to_capture_kingside)
-      ct_pawn_move_promotion(pawn, from, to_kingside);
-  }
-  else
-  {
-    if (able_to_move_forward)
-      ct_move_command_execute(move_command, ct_move_make(from, to_forward));
-    if (able_to_move_forward_two)
-    {
-      if (en_passant_possible)
-        move = ct_move_make_en_passant_possible(from, to_forward_two);
-      else
-        move = ct_move_make(from, to_forward_two);
-      ct_move_command_execute(move_command, move);
-    }
-    if (able_to_capture_queenside)
-      ct_move_command_execute(move_command, ct_move_make(from, to_queenside));
-    if (able_to_capture_kingside)
-      ct_move_command_execute(move_command, ct_move_make(from, to_kingside));
-    if (can_capture_en_passant)
-    {
-      en_passant_square = ct_square_make(en_passant_file, pawn->capture_en_passant_to_rank);
-      move = ct_move_make_en_passant_capture(from, en_passant_square);
-      ct_move_command_execute(move_command, move);
-    }
-  }
+static CtBitBoard
+ct_pawn_shift(CtBitBoard bit_board, int offset)
+{
+  return offset > 0 ? bit_board << offset : bit_board >> -offset;
 }
 
 static void
-ct_pawn_move_promotion(CtPawn pawn, CtSquare from, CtSquare to)
+ct_pawn_moves_to(CtPawn pawn, CtBitBoard targets, int offset, CtMove (*move_make) (CtSquare, CtSquare))
 {
-  CtMoveCommand move_command = pawn->move_command;
+  CtSquare to;
 
-  if (pawn->piece_color == WHITE_PIECE)
-  {
-    ct_move_command_execute(move_command, ct_move_make_promotion_Q(from, to));
-    ct_move_command_execute(move_command, ct_move_make_promotion_R(from, to));
-    ct_move_command_execute(move_command, ct_move_make_promotion_B(from, to));
-    ct_move_command_execute(move_command, ct_move_make_promotion_N(from, to));
-  }
-  else
+  while (targets)
   {
-    ct_move_command_execute(move_command, ct_move_make_promotion_q(from, to));
-    ct_move_command_execute(move_command, ct_move_make_promotion_r(from, to));
-    ct_move_command_execute(move_command, ct_move_make_promotion_b(from, to));
-    ct_move_command_execute(move_command, ct_move_make_promotion_n(from, to));
+    to = ct_bit_board_find_first_square(targets);
+    targets &= targets - 1;
+    ct_move_command_execute(pawn->move_command, move_make(to - offset, to));
   }
 }
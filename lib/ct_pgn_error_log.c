@@ -0,0 +1,116 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_pgn_error_log.h"
+#include "ct_graph.h"
+#include "ct_utilities.h"
+#include <stdio.h>
+
+enum
+{
+  INITIAL_ENTRIES_SIZE = 16
+};
+
+typedef struct CtPgnErrorLogEntryStruct
+{
+  int game;
+  char message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+} CtPgnErrorLogEntryStruct;
+
+typedef struct CtPgnErrorLogStruct
+{
+  CtPgnErrorPolicy policy;
+  CtPgnErrorLogEntryStruct *entries;        /* only used with PGN_ERROR_COLLECT */
+  int error_count;
+  int entries_size;
+} CtPgnErrorLogStruct;
+
+CtPgnErrorLog
+ct_pgn_error_log_new(CtPgnErrorPolicy policy)
+{
+  CtPgnErrorLog pgn_error_log;
+
+  pgn_error_log = ct_malloc(sizeof(CtPgnErrorLogStruct));
+  pgn_error_log->policy = policy;
+  pgn_error_log->entries = 0;
+  pgn_error_log->entries_size = 0;
+  if (policy == PGN_ERROR_COLLECT)
+  {
+    pgn_error_log->entries = ct_malloc(INITIAL_ENTRIES_SIZE * sizeof(CtPgnErrorLogEntryStruct));
+    pgn_error_log->entries_size = INITIAL_ENTRIES_SIZE;
+  }
+  pgn_error_log->error_count = 0;
+  return pgn_error_log;
+}
+
+void
+ct_pgn_error_log_free(CtPgnErrorLog pgn_error_log)
+{
+  ct_free(pgn_error_log->entries);
+  ct_free(pgn_error_log);
+}
+
+void
+ct_pgn_error_log_reset(CtPgnErrorLog pgn_error_log)
+{
+  pgn_error_log->error_count = 0;
+}
+
+void
+ct_pgn_error_log_add(CtPgnErrorLog pgn_error_log, int game, char *message)
+{
+  CtPgnErrorLogEntryStruct *entry;
+
+  if (pgn_error_log->policy == PGN_ERROR_COLLECT)
+  {
+    if (pgn_error_log->error_count == pgn_error_log->entries_size)
+    {
+      pgn_error_log->entries_size *= 2;
+      pgn_error_log->entries =
+        ct_realloc(pgn_error_log->entries, pgn_error_log->entries_size * sizeof(CtPgnErrorLogEntryStruct));
+    }
+    entry = &pgn_error_log->entries[pgn_error_log->error_count];
+    entry->game = game;
+    snprintf(entry->message, CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH, "%s", message);
+  }
+  pgn_error_log->error_count++;
+}
+
+CtPgnErrorPolicy
+ct_pgn_error_log_policy(CtPgnErrorLog pgn_error_log)
+{
+  return pgn_error_log->policy;
+}
+
+int
+ct_pgn_error_log_count(CtPgnErrorLog pgn_error_log)
+{
+  return pgn_error_log->error_count;
+}
+
+int
+ct_pgn_error_log_game(CtPgnErrorLog pgn_error_log, int index)
+{
+  return pgn_error_log->entries[index].game;
+}
+
+char *
+ct_pgn_error_log_message(CtPgnErrorLog pgn_error_log, int index)
+{
+  return pgn_error_log->entries[index].message;
+}
@@ -0,0 +1,189 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_pgn_index.h"
+#include "ct_utilities.h"
+#include <string.h>
+
+/* The sidecar file is a magic number and a version, followed by the number of games and then the offset, length and
+   header hash of each game.  Every number is written as 8 little endian bytes, so the file does not depend on the
+   machine that wrote it. */
+
+static const char magic[] = "CTPGNIDX";
+
+enum
+{
+  MAGIC_LENGTH = 8,
+  FILE_FORMAT_VERSION = 1,
+  INITIAL_ENTRIES_SIZE = 1024
+};
+
+typedef struct CtPgnIndexEntryStruct
+{
+  int64_t offset;
+  int64_t length;
+  uint64_t header_hash;
+} CtPgnIndexEntryStruct;
+
+typedef struct CtPgnIndexStruct
+{
+  CtPgnIndexEntryStruct *entries;
+  int game_count;
+  int entries_size;
+} CtPgnIndexStruct;
+
+static bool ct_pgn_index_write_number(FILE * file, uint64_t number);
+static bool ct_pgn_index_read_number(FILE * file, uint64_t * number);
+
+CtPgnIndex
+ct_pgn_index_new(void)
+{
+  CtPgnIndex pgn_index;
+
+  pgn_index = ct_malloc(sizeof(CtPgnIndexStruct));
+  pgn_index->entries = ct_malloc(INITIAL_ENTRIES_SIZE * sizeof(CtPgnIndexEntryStruct));
+  pgn_index->entries_size = INITIAL_ENTRIES_SIZE;
+  pgn_index->game_count = 0;
+  return pgn_index;
+}
+
+void
+ct_pgn_index_free(CtPgnIndex pgn_index)
+{
+  ct_free(pgn_index->entries);
+  ct_free(pgn_index);
+}
+
+void
+ct_pgn_index_reset(CtPgnIndex pgn_index)
+{
+  pgn_index->game_count = 0;
+}
+
+void
+ct_pgn_index_add(CtPgnIndex pgn_index, int64_t offset, int64_t length, uint64_t header_hash)
+{
+  CtPgnIndexEntryStruct *entry;
+
+  if (pgn_index->game_count == pgn_index->entries_size)
+  {
+    pgn_index->entries_size *= 2;
+    pgn_index->entries = ct_realloc(pgn_index->entries, pgn_index->entries_size * sizeof(CtPgnIndexEntryStruct));
+  }
+  entry = &pgn_index->entries[pgn_index->game_count++];
+  entry->offset = offset;
+  entry->length = length;
+  entry->header_hash = header_hash;
+}
+
+int
+ct_pgn_index_game_count(CtPgnIndex pgn_index)
+{
+  return pgn_index->game_count;
+}
+
+int64_t
+ct_pgn_index_offset(CtPgnIndex pgn_index, int game)
+{
+  return pgn_index->entries[game].offset;
+}
+
+int64_t
+ct_pgn_index_length(CtPgnIndex pgn_index, int game)
+{
+  return pgn_index->entries[game].length;
+}
+
+uint64_t
+ct_pgn_index_header_hash(CtPgnIndex pgn_index, int game)
+{
+  return pgn_index->entries[game].header_hash;
+}
+
+bool
+ct_pgn_index_to_file(CtPgnIndex pgn_index, FILE * file)
+{
+  int game;
+  bool is_written;
+
+  is_written = fwrite(magic, 1, MAGIC_LENGTH, file) == MAGIC_LENGTH
+    && ct_pgn_index_write_number(file, FILE_FORMAT_VERSION)
+    && ct_pgn_index_write_number(file, pgn_index->game_count);
+  for (game = 0; game < pgn_index->game_count && is_written; game++)
+  {
+    CtPgnIndexEntryStruct *entry = &pgn_index->entries[game];
+
+    is_written = ct_pgn_index_write_number(file, entry->offset)
+      && ct_pgn_index_write_number(file, entry->length)
+      && ct_pgn_index_write_number(file, entry->header_hash);
+  }
+  return is_written;
+}
+
+/* if the file is not a PGN index sidecar (or is cut short), the index is left empty and 0 is returned */
+CtPgnIndex
+ct_pgn_index_from_file(CtPgnIndex pgn_index, FILE * file)
+{
+  char file_magic[MAGIC_LENGTH];
+  uint64_t version, game_count, offset, length, header_hash;
+  uint64_t game;
+
+  ct_pgn_index_reset(pgn_index);
+  if (fread(file_magic, 1, MAGIC_LENGTH, file) != MAGIC_LENGTH || memcmp(file_magic, magic, MAGIC_LENGTH) != 0)
+    return 0;
+  if (!ct_pgn_index_read_number(file, &version) || version != FILE_FORMAT_VERSION)
+    return 0;
+  if (!ct_pgn_index_read_number(file, &game_count))
+    return 0;
+  for (game = 0; game < game_count; game++)
+  {
+    if (!ct_pgn_index_read_number(file, &offset) || !ct_pgn_index_read_number(file, &length)
+        || !ct_pgn_index_read_number(file, &header_hash))
+    {
+      ct_pgn_index_reset(pgn_index);
+      return 0;
+    }
+    ct_pgn_index_add(pgn_index, offset, length, header_hash);
+  }
+  return pgn_index;
+}
+
+static bool
+ct_pgn_index_write_number(FILE * file, uint64_t number)
+{
+  unsigned char bytes[8];
+  int index;
+
+  for (index = 0; index < 8; index++)
+    bytes[index] = (number >> (8 * index)) & 0xFF;
+  return fwrite(bytes, 1, 8, file) == 8;
+}
+
+static bool
+ct_pgn_index_read_number(FILE * file, uint64_t * number)
+{
+  unsigned char bytes[8];
+  int index;
+
+  if (fread(bytes, 1, 8, file) != 8)
+    return false;
+  *number = 0;
+  for (index = 0; index < 8; index++)
+    *number |= (uint64_t) bytes[index] << (8 * index);
+  return true;
+}
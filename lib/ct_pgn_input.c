@@ -0,0 +1,749 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_pgn_input.h"
+#include "ct_error.h"
+#include "ct_utilities.h"
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_POLL_H
+#include <poll.h>
+#endif
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+#ifdef HAVE_LIBPTHREAD
+#include <pthread.h>
+#endif
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef HAVE_LIBBZ2
+#include <bzlib.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+enum
+{
+  MAGIC_MAX_LENGTH = 4,
+  COMPRESSED_BLOCK_SIZE = 65536,
+  DECOMPRESSED_BLOCK_SIZE = 262144,
+  NUMBER_OF_BLOCKS = 2,
+  SKIP_BUFFER_SIZE = 8192,
+  FOLLOW_POLL_MILLISECONDS = 100,        /* how often a followed file is checked when it cannot be watched */
+  FOLLOW_WATCH_MILLISECONDS = 1000        /* events can be missed on some file systems, so watching also times out */
+};
+
+typedef enum CtPgnInputFormat
+{
+  FORMAT_PGN, FORMAT_GZIP, FORMAT_BZIP2, FORMAT_ZSTD
+} CtPgnInputFormat;
+
+typedef struct CtPgnInputBlockStruct
+{
+  char *data;
+  int length;
+  bool is_full;
+  bool has_error;                /* the decoder found corrupt data while filling the block */
+} CtPgnInputBlockStruct;
+
+typedef struct CtPgnInputStruct
+{
+  FILE *file;
+  CtPgnInputFormat format;
+  char *compressed;                /* holds the bytes used to detect the format until the file is read further */
+  int compressed_length;
+  bool has_error;                /* only the reader's thread uses has_error -- it is taken from each block it holds */
+  bool is_corrupt;                /* only the decoder uses is_corrupt, and hands it to the reader with each block */
+  bool is_finished;
+  CtPgnErrorLog pgn_error_log;        /* decides what the reader does with games it cannot parse */
+  CtGameAnnotations game_annotations;        /* filled in from the comments of each game, when it is wanted */
+  CtMoveTree move_tree;                /* filled in with each game and its variations, when it is wanted */
+  int64_t bytes_read;
+  struct timespec start_time;
+  struct timespec finish_time;
+  bool is_following;
+  int follow_milliseconds;        /* how long a followed file may stay the same size before the input ends */
+  int watch_descriptor;                /* an inotify descriptor watching the followed file, or -1 if it is polled */
+  /* the decompression thread fills one block while the reader copies out of the other */
+  CtPgnInputBlockStruct blocks[NUMBER_OF_BLOCKS];
+  int read_block;
+  int read_position;
+  bool is_holding_block;
+#ifdef HAVE_LIBPTHREAD
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t block_changed;
+  bool is_stopping;
+#endif
+#ifdef HAVE_LIBZ
+  z_stream gzip_stream;
+#endif
+#ifdef HAVE_LIBBZ2
+  bz_stream bzip2_stream;
+#endif
+#ifdef HAVE_LIBZSTD
+  ZSTD_DStream *zstd_stream;
+  ZSTD_inBuffer zstd_input;
+  size_t zstd_frame_remaining;        /* 0 once a frame has been completely decompressed */
+#endif
+} CtPgnInputStruct;
+
+static char *format_names[] = {"pgn", "gzip", "bzip2", "zstd"};
+
+static CtPgnInputFormat ct_pgn_input_detect_format(CtPgnInput pgn_input);
+static void ct_pgn_input_start_decoder(CtPgnInput pgn_input);
+static void ct_pgn_input_stop_decoder(CtPgnInput pgn_input);
+static int ct_pgn_input_read_file(CtPgnInput pgn_input, char *destination, int max_length);
+static int ct_pgn_input_read_compressed(CtPgnInput pgn_input);
+static bool ct_pgn_input_wait_for_growth(CtPgnInput pgn_input);
+static void ct_pgn_input_wait_for_change(CtPgnInput pgn_input, int milliseconds);
+static int ct_pgn_input_read_decompressed(CtPgnInput pgn_input, char *destination, int max_length);
+static int ct_pgn_input_decompress(CtPgnInput pgn_input, char *destination, int max_length);
+#ifdef HAVE_LIBZ
+static int ct_pgn_input_decompress_gzip(CtPgnInput pgn_input, char *destination, int max_length);
+#endif
+#ifdef HAVE_LIBBZ2
+static int ct_pgn_input_decompress_bzip2(CtPgnInput pgn_input, char *destination, int max_length);
+#endif
+#ifdef HAVE_LIBZSTD
+static int ct_pgn_input_decompress_zstd(CtPgnInput pgn_input, char *destination, int max_length);
+#endif
+#ifdef HAVE_LIBPTHREAD
+static void *ct_pgn_input_decompression_thread(void *data);
+#endif
+static double ct_pgn_input_seconds_between(struct timespec *start_time, struct timespec *finish_time);
+
+CtPgnInput
+ct_pgn_input_new(FILE * file)
+{
+  CtPgnInput pgn_input;
+
+  if (file == 0)
+    return 0;
+  pgn_input = ct_malloc(sizeof(CtPgnInputStruct));
+  pgn_input->file = file;
+  pgn_input->compressed = ct_malloc(COMPRESSED_BLOCK_SIZE);
+  pgn_input->compressed_length = fread(pgn_input->compressed, 1, MAGIC_MAX_LENGTH, file);
+  pgn_input->has_error = false;
+  pgn_input->is_corrupt = false;
+  pgn_input->is_finished = false;
+  pgn_input->pgn_error_log = 0;
+  pgn_input->game_annotations = 0;
+  pgn_input->move_tree = 0;
+  pgn_input->bytes_read = 0;
+  pgn_input->is_following = false;
+  pgn_input->watch_descriptor = -1;
+  clock_gettime(CLOCK_MONOTONIC, &pgn_input->start_time);
+  pgn_input->format = ct_pgn_input_detect_format(pgn_input);
+  if (pgn_input->format != FORMAT_PGN)
+    ct_pgn_input_start_decoder(pgn_input);
+  return pgn_input;
+}
+
+void
+ct_pgn_input_free(CtPgnInput pgn_input)
+{
+  if (pgn_input->format != FORMAT_PGN)
+    ct_pgn_input_stop_decoder(pgn_input);
+#ifdef HAVE_SYS_INOTIFY_H
+  if (pgn_input->watch_descriptor >= 0)
+    close(pgn_input->watch_descriptor);
+#endif
+  ct_free(pgn_input->compressed);
+  ct_free(pgn_input);
+}
+
+/* formats are only recognized if the toolkit was built with the library to decompress them -- anything else is read
+   as plain text, which is what would have happened before compressed input was supported */
+static CtPgnInputFormat
+ct_pgn_input_detect_format(CtPgnInput pgn_input)
+{
+  unsigned char *magic = (unsigned char *) pgn_input->compressed;
+  int length = pgn_input->compressed_length;
+
+#ifdef HAVE_LIBZ
+  if (length >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+    return FORMAT_GZIP;
+#endif
+#ifdef HAVE_LIBBZ2
+  if (length >= 3 && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h')
+    return FORMAT_BZIP2;
+#endif
+#ifdef HAVE_LIBZSTD
+  if (length >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD)
+    return FORMAT_ZSTD;
+#endif
+  return FORMAT_PGN;
+}
+
+static void
+ct_pgn_input_start_decoder(CtPgnInput pgn_input)
+{
+  int index;
+
+  switch (pgn_input->format)
+  {
+#ifdef HAVE_LIBZ
+  case FORMAT_GZIP:
+    memset(&pgn_input->gzip_stream, 0, sizeof(z_stream));
+    pgn_input->gzip_stream.next_in = (Bytef *) pgn_input->compressed;
+    pgn_input->gzip_stream.avail_in = pgn_input->compressed_length;
+    if (inflateInit2(&pgn_input->gzip_stream, 15 + 16) != Z_OK)        /* 15 + 16 selects a gzip header */
+      ct_error("ct_pgn_input: inflateInit2 failed");
+    break;
+#endif
+#ifdef HAVE_LIBBZ2
+  case FORMAT_BZIP2:
+    memset(&pgn_input->bzip2_stream, 0, sizeof(bz_stream));
+    pgn_input->bzip2_stream.next_in = pgn_input->compressed;
+    pgn_input->bzip2_stream.avail_in = pgn_input->compressed_length;
+    if (BZ2_bzDecompressInit(&pgn_input->bzip2_stream, 0, 0) != BZ_OK)
+      ct_error("ct_pgn_input: BZ2_bzDecompressInit failed");
+    break;
+#endif
+#ifdef HAVE_LIBZSTD
+  case FORMAT_ZSTD:
+    pgn_input->zstd_stream = ZSTD_createDStream();
+    if (pgn_input->zstd_stream == 0 || ZSTD_isError(ZSTD_initDStream(pgn_input->zstd_stream)))
+      ct_error("ct_pgn_input: ZSTD_initDStream failed");
+    pgn_input->zstd_input.src = pgn_input->compressed;
+    pgn_input->zstd_input.size = pgn_input->compressed_length;
+    pgn_input->zstd_input.pos = 0;
+    pgn_input->zstd_frame_remaining = 0;
+    break;
+#endif
+  default:
+    break;
+  }
+  for (index = 0; index < NUMBER_OF_BLOCKS; index++)
+  {
+    pgn_input->blocks[index].data = ct_malloc(DECOMPRESSED_BLOCK_SIZE);
+    pgn_input->blocks[index].length = 0;
+    pgn_input->blocks[index].is_full = false;
+    pgn_input->blocks[index].has_error = false;
+  }
+  pgn_input->read_block = 0;
+  pgn_input->read_position = 0;
+  pgn_input->is_holding_block = false;
+#ifdef HAVE_LIBPTHREAD
+  pgn_input->is_stopping = false;
+  pthread_mutex_init(&pgn_input->mutex, 0);
+  pthread_cond_init(&pgn_input->block_changed, 0);
+  if (pthread_create(&pgn_input->thread, 0, ct_pgn_input_decompression_thread, pgn_input) != 0)
+    ct_error("ct_pgn_input: pthread_create failed");
+#endif
+}
+
+static void
+ct_pgn_input_stop_decoder(CtPgnInput pgn_input)
+{
+  int index;
+
+#ifdef HAVE_LIBPTHREAD
+  pthread_mutex_lock(&pgn_input->mutex);
+  pgn_input->is_stopping = true;
+  pthread_cond_broadcast(&pgn_input->block_changed);
+  pthread_mutex_unlock(&pgn_input->mutex);
+  pthread_join(pgn_input->thread, 0);
+  pthread_cond_destroy(&pgn_input->block_changed);
+  pthread_mutex_destroy(&pgn_input->mutex);
+#endif
+  switch (pgn_input->format)
+  {
+#ifdef HAVE_LIBZ
+  case FORMAT_GZIP:
+    inflateEnd(&pgn_input->gzip_stream);
+    break;
+#endif
+#ifdef HAVE_LIBBZ2
+  case FORMAT_BZIP2:
+    BZ2_bzDecompressEnd(&pgn_input->bzip2_stream);
+    break;
+#endif
+#ifdef HAVE_LIBZSTD
+  case FORMAT_ZSTD:
+    ZSTD_freeDStream(pgn_input->zstd_stream);
+    break;
+#endif
+  default:
+    break;
+  }
+  for (index = 0; index < NUMBER_OF_BLOCKS; index++)
+    ct_free(pgn_input->blocks[index].data);
+}
+
+int
+ct_pgn_input_read(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  int length;
+
+  if (pgn_input->is_finished)
+    return 0;
+  if (pgn_input->format == FORMAT_PGN)
+    length = ct_pgn_input_read_file(pgn_input, destination, max_length);
+  else
+    length = ct_pgn_input_read_decompressed(pgn_input, destination, max_length);
+  if (length == 0)
+  {
+    pgn_input->is_finished = true;
+    clock_gettime(CLOCK_MONOTONIC, &pgn_input->finish_time);
+  }
+  pgn_input->bytes_read += length;
+  return length;
+}
+
+/* a followed file is read as it is written -- reading waits at the end of the file until more is appended, and the
+   input only ends once the file has stayed the same size for idle_milliseconds (or never, if that is negative).
+   Compressed files cannot be followed. */
+bool
+ct_pgn_input_follow(CtPgnInput pgn_input, int idle_milliseconds)
+{
+#if defined(HAVE_SYS_INOTIFY_H) && defined(HAVE_POLL_H)
+  char path[64];
+#endif
+
+  if (pgn_input->format != FORMAT_PGN)
+    return false;
+  pgn_input->is_following = true;
+  pgn_input->follow_milliseconds = idle_milliseconds;
+#if defined(HAVE_SYS_INOTIFY_H) && defined(HAVE_POLL_H)
+  if (pgn_input->watch_descriptor < 0)
+  {
+    /* the file may have been opened without a name (or renamed since), so it is watched through its descriptor */
+    sprintf(path, "/proc/self/fd/%d", fileno(pgn_input->file));
+    pgn_input->watch_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (pgn_input->watch_descriptor >= 0 && inotify_add_watch(pgn_input->watch_descriptor, path, IN_MODIFY) < 0)
+    {
+      close(pgn_input->watch_descriptor);
+      pgn_input->watch_descriptor = -1;
+    }
+  }
+#endif
+  return true;
+}
+
+/* uncompressed files are skipped with a seek (once the bytes used to detect the format are used up), but compressed
+   files, and files that cannot seek, have to be read to find their way -- returns false if the input ends first */
+bool
+ct_pgn_input_skip(CtPgnInput pgn_input, int64_t length)
+{
+  char buffer[SKIP_BUFFER_SIZE];
+  int read_length;
+
+  while (length > 0 && pgn_input->format == FORMAT_PGN && pgn_input->compressed_length > 0)
+  {
+    read_length = ct_pgn_input_read(pgn_input, buffer, length < SKIP_BUFFER_SIZE ? length : SKIP_BUFFER_SIZE);
+    length -= read_length;
+  }
+  if (length > 0 && pgn_input->format == FORMAT_PGN && fseeko(pgn_input->file, length - 1, SEEK_CUR) == 0)
+  {
+    /* seeking past the end of a file succeeds, so the last byte skipped is read to be sure it is there */
+    if (getc(pgn_input->file) == EOF)
+      return false;
+    pgn_input->bytes_read += length;
+    return true;
+  }
+  while (length > 0)
+  {
+    read_length = ct_pgn_input_read(pgn_input, buffer, length < SKIP_BUFFER_SIZE ? length : SKIP_BUFFER_SIZE);
+    if (read_length == 0)
+      return false;
+    length -= read_length;
+  }
+  return true;
+}
+
+/* the bytes used to detect the format are returned before anything else is read from the file */
+static int
+ct_pgn_input_read_file(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  int length = pgn_input->compressed_length;
+
+  if (length == 0)
+  {
+    length = fread(destination, 1, max_length, pgn_input->file);
+    while (length == 0 && pgn_input->is_following && ct_pgn_input_wait_for_growth(pgn_input))
+    {
+      clearerr(pgn_input->file);
+      length = fread(destination, 1, max_length, pgn_input->file);
+    }
+    return length;
+  }
+  if (length > max_length)
+    length = max_length;
+  memcpy(destination, pgn_input->compressed, length);
+  memmove(pgn_input->compressed, pgn_input->compressed + length, pgn_input->compressed_length - length);
+  pgn_input->compressed_length -= length;
+  return length;
+}
+
+/* returns false if the followed file stays the same size for too long, or is truncated (which would leave the reader
+   part way through something else) */
+static bool
+ct_pgn_input_wait_for_growth(CtPgnInput pgn_input)
+{
+  struct stat file_status;
+  struct timespec start_time;
+  struct timespec now;
+  off_t position = ftello(pgn_input->file);
+  int waited = 0;
+  int milliseconds;
+
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+  while (pgn_input->follow_milliseconds < 0 || waited < pgn_input->follow_milliseconds)
+  {
+    if (fstat(fileno(pgn_input->file), &file_status) != 0 || file_status.st_size < position)
+      return false;
+    if (file_status.st_size > position)
+      return true;
+    milliseconds = pgn_input->watch_descriptor >= 0 ? FOLLOW_WATCH_MILLISECONDS : FOLLOW_POLL_MILLISECONDS;
+    if (pgn_input->follow_milliseconds >= 0 && milliseconds > pgn_input->follow_milliseconds - waited)
+      milliseconds = pgn_input->follow_milliseconds - waited;
+    ct_pgn_input_wait_for_change(pgn_input, milliseconds);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    waited = ct_pgn_input_seconds_between(&start_time, &now) * 1000;
+  }
+  return false;
+}
+
+/* returns as soon as the file is modified if it is being watched, otherwise once the time is up */
+static void
+ct_pgn_input_wait_for_change(CtPgnInput pgn_input, int milliseconds)
+{
+  struct timespec interval;
+
+#if defined(HAVE_SYS_INOTIFY_H) && defined(HAVE_POLL_H)
+  if (pgn_input->watch_descriptor >= 0)
+  {
+    struct pollfd watch = { pgn_input->watch_descriptor, POLLIN, 0 };
+    char events[4096];
+
+    if (poll(&watch, 1, milliseconds) > 0)
+      while (read(pgn_input->watch_descriptor, events, sizeof(events)) > 0)
+        ;
+    return;
+  }
+#endif
+  interval.tv_sec = milliseconds / 1000;
+  interval.tv_nsec = (milliseconds % 1000) * 1000000L;
+  nanosleep(&interval, 0);
+}
+
+static int
+ct_pgn_input_read_compressed(CtPgnInput pgn_input)
+{
+  pgn_input->compressed_length = fread(pgn_input->compressed, 1, COMPRESSED_BLOCK_SIZE, pgn_input->file);
+  return pgn_input->compressed_length;
+}
+
+/* copies from the block the reader is holding, handing it back to be refilled once it has been used up */
+static int
+ct_pgn_input_read_decompressed(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  CtPgnInputBlockStruct *block = &pgn_input->blocks[pgn_input->read_block];
+  int length;
+
+  if (pgn_input->is_holding_block && pgn_input->read_position == block->length)
+  {
+#ifdef HAVE_LIBPTHREAD
+    pthread_mutex_lock(&pgn_input->mutex);
+    block->is_full = false;
+    pthread_cond_broadcast(&pgn_input->block_changed);
+    pthread_mutex_unlock(&pgn_input->mutex);
+#else
+    block->is_full = false;
+#endif
+    pgn_input->read_block = (pgn_input->read_block + 1) % NUMBER_OF_BLOCKS;
+    pgn_input->is_holding_block = false;
+    block = &pgn_input->blocks[pgn_input->read_block];
+  }
+  if (!pgn_input->is_holding_block)
+  {
+#ifdef HAVE_LIBPTHREAD
+    pthread_mutex_lock(&pgn_input->mutex);
+    while (!block->is_full)
+      pthread_cond_wait(&pgn_input->block_changed, &pgn_input->mutex);
+    pthread_mutex_unlock(&pgn_input->mutex);
+#else
+    block->length = ct_pgn_input_decompress(pgn_input, block->data, DECOMPRESSED_BLOCK_SIZE);
+    block->has_error = pgn_input->is_corrupt;
+    block->is_full = true;
+#endif
+    pgn_input->has_error = block->has_error;
+    pgn_input->is_holding_block = true;
+    pgn_input->read_position = 0;
+  }
+  length = block->length - pgn_input->read_position;
+  if (length > max_length)
+    length = max_length;
+  memcpy(destination, block->data + pgn_input->read_position, length);
+  pgn_input->read_position += length;
+  return length;
+}
+
+#ifdef HAVE_LIBPTHREAD
+/* fills the blocks in turn, waiting whenever the next block is still in use by the reader -- an empty block marks the
+   end of the input */
+static void *
+ct_pgn_input_decompression_thread(void *data)
+{
+  CtPgnInput pgn_input = (CtPgnInput) data;
+  int index = 0;
+  int length;
+
+  do
+  {
+    CtPgnInputBlockStruct *block = &pgn_input->blocks[index];
+    bool is_stopping;
+
+    pthread_mutex_lock(&pgn_input->mutex);
+    while (block->is_full && !pgn_input->is_stopping)
+      pthread_cond_wait(&pgn_input->block_changed, &pgn_input->mutex);
+    is_stopping = pgn_input->is_stopping;
+    pthread_mutex_unlock(&pgn_input->mutex);
+    if (is_stopping)
+      break;
+    length = ct_pgn_input_decompress(pgn_input, block->data, DECOMPRESSED_BLOCK_SIZE);
+    pthread_mutex_lock(&pgn_input->mutex);
+    block->length = length;
+    block->has_error = pgn_input->is_corrupt;
+    block->is_full = true;
+    pthread_cond_broadcast(&pgn_input->block_changed);
+    pthread_mutex_unlock(&pgn_input->mutex);
+    index = (index + 1) % NUMBER_OF_BLOCKS;
+  }
+  while (length > 0);
+  return 0;
+}
+#endif
+
+/* decompresses until the destination is full or the file ends -- corrupt data ends the input early and sets
+   is_corrupt */
+static int
+ct_pgn_input_decompress(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  switch (pgn_input->format)
+  {
+#ifdef HAVE_LIBZ
+  case FORMAT_GZIP:
+    return ct_pgn_input_decompress_gzip(pgn_input, destination, max_length);
+#endif
+#ifdef HAVE_LIBBZ2
+  case FORMAT_BZIP2:
+    return ct_pgn_input_decompress_bzip2(pgn_input, destination, max_length);
+#endif
+#ifdef HAVE_LIBZSTD
+  case FORMAT_ZSTD:
+    return ct_pgn_input_decompress_zstd(pgn_input, destination, max_length);
+#endif
+  default:
+    return 0;
+  }
+}
+
+#ifdef HAVE_LIBZ
+static int
+ct_pgn_input_decompress_gzip(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  z_stream *stream = &pgn_input->gzip_stream;
+  int status;
+
+  stream->next_out = (Bytef *) destination;
+  stream->avail_out = max_length;
+  while (stream->avail_out > 0 && !pgn_input->is_corrupt)
+  {
+    if (stream->avail_in == 0)
+    {
+      if (ct_pgn_input_read_compressed(pgn_input) == 0)
+      {
+        pgn_input->is_corrupt = stream->total_in > 0;        /* the file ended part way through a gzip member */
+        break;
+      }
+      stream->next_in = (Bytef *) pgn_input->compressed;
+      stream->avail_in = pgn_input->compressed_length;
+    }
+    status = inflate(stream, Z_NO_FLUSH);
+    if (status == Z_STREAM_END)
+      inflateReset(stream);        /* concatenated gzip members are read as one stream */
+    else if (status != Z_OK)
+      pgn_input->is_corrupt = true;
+  }
+  return max_length - stream->avail_out;
+}
+#endif
+
+#ifdef HAVE_LIBBZ2
+static int
+ct_pgn_input_decompress_bzip2(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  bz_stream *stream = &pgn_input->bzip2_stream;
+  int status;
+
+  stream->next_out = destination;
+  stream->avail_out = max_length;
+  while (stream->avail_out > 0 && !pgn_input->is_corrupt)
+  {
+    if (stream->avail_in == 0)
+    {
+      if (ct_pgn_input_read_compressed(pgn_input) == 0)
+      {
+        pgn_input->is_corrupt = stream->total_in_lo32 > 0 || stream->total_in_hi32 > 0;
+        break;
+      }
+      stream->next_in = pgn_input->compressed;
+      stream->avail_in = pgn_input->compressed_length;
+    }
+    status = BZ2_bzDecompress(stream);
+    if (status == BZ_STREAM_END)
+    {
+      /* concatenated bzip2 streams (as written by parallel compressors) are read as one stream */
+      char *next_in = stream->next_in;
+      unsigned int avail_in = stream->avail_in;
+      char *next_out = stream->next_out;
+      unsigned int avail_out = stream->avail_out;
+
+      BZ2_bzDecompressEnd(stream);
+      memset(stream, 0, sizeof(bz_stream));
+      if (BZ2_bzDecompressInit(stream, 0, 0) != BZ_OK)
+        ct_error("ct_pgn_input: BZ2_bzDecompressInit failed");
+      stream->next_in = next_in;
+      stream->avail_in = avail_in;
+      stream->next_out = next_out;
+      stream->avail_out = avail_out;
+    }
+    else if (status != BZ_OK)
+      pgn_input->is_corrupt = true;
+  }
+  return max_length - stream->avail_out;
+}
+#endif
+
+#ifdef HAVE_LIBZSTD
+static int
+ct_pgn_input_decompress_zstd(CtPgnInput pgn_input, char *destination, int max_length)
+{
+  ZSTD_inBuffer *input = &pgn_input->zstd_input;
+  ZSTD_outBuffer output = { destination, max_length, 0 };
+
+  while (output.pos < output.size && !pgn_input->is_corrupt)
+  {
+    if (input->pos == input->size)
+    {
+      if (ct_pgn_input_read_compressed(pgn_input) == 0)
+      {
+        pgn_input->is_corrupt = pgn_input->zstd_frame_remaining != 0;
+        break;
+      }
+      input->src = pgn_input->compressed;
+      input->size = pgn_input->compressed_length;
+      input->pos = 0;
+    }
+    pgn_input->zstd_frame_remaining = ZSTD_decompressStream(pgn_input->zstd_stream, &output, input);
+    if (ZSTD_isError(pgn_input->zstd_frame_remaining))
+      pgn_input->is_corrupt = true;
+  }
+  return output.pos;
+}
+#endif
+
+void
+ct_pgn_input_use_error_log(CtPgnInput pgn_input, CtPgnErrorLog pgn_error_log)
+{
+  pgn_input->pgn_error_log = pgn_error_log;
+}
+
+CtPgnErrorLog
+ct_pgn_input_error_log(CtPgnInput pgn_input)
+{
+  return pgn_input->pgn_error_log;
+}
+
+void
+ct_pgn_input_use_game_annotations(CtPgnInput pgn_input, CtGameAnnotations game_annotations)
+{
+  pgn_input->game_annotations = game_annotations;
+}
+
+CtGameAnnotations
+ct_pgn_input_game_annotations(CtPgnInput pgn_input)
+{
+  return pgn_input->game_annotations;
+}
+
+void
+ct_pgn_input_use_move_tree(CtPgnInput pgn_input, CtMoveTree move_tree)
+{
+  pgn_input->move_tree = move_tree;
+}
+
+CtMoveTree
+ct_pgn_input_move_tree(CtPgnInput pgn_input)
+{
+  return pgn_input->move_tree;
+}
+
+char *
+ct_pgn_input_format(CtPgnInput pgn_input)
+{
+  return format_names[pgn_input->format];
+}
+
+bool
+ct_pgn_input_has_error(CtPgnInput pgn_input)
+{
+  return pgn_input->has_error;
+}
+
+int64_t
+ct_pgn_input_bytes_read(CtPgnInput pgn_input)
+{
+  return pgn_input->bytes_read;
+}
+
+/* throughput is measured in uncompressed bytes, from when the input was created until the end of the input (or now, if
+   the input has not been read to the end) */
+double
+ct_pgn_input_megabytes_per_second(CtPgnInput pgn_input)
+{
+  struct timespec now;
+  struct timespec *finish_time = &pgn_input->finish_time;
+  double seconds;
+
+  if (!pgn_input->is_finished)
+  {
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    finish_time = &now;
+  }
+  seconds = ct_pgn_input_seconds_between(&pgn_input->start_time, finish_time);
+  if (seconds <= 0)
+    return 0;
+  return pgn_input->bytes_read / 1000000.0 / seconds;
+}
+
+static double
+ct_pgn_input_seconds_between(struct timespec *start_time, struct timespec *finish_time)
+{
+  return (finish_time->tv_sec - start_time->tv_sec) + (finish_time->tv_nsec - start_time->tv_nsec) / 1000000000.0;
+}
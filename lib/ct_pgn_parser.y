@@ -16,11 +16,12 @@
  */
 
 %{
-  #include "ct_pgn_reader.h"
+  #include "ct_pgn_reader_private.h"
   #include <stdio.h>
 %}
 
 %define api.pure
+%define api.push-pull both
 %lex-param {void * scanner}
 %parse-param {CtPgnReader pgn_reader}
 %{
@@ -44,6 +45,7 @@
 %token <str>  MOVE_NOTATION
 %token <str>  GAME_TERMINATION
 %token <str>  INVALID_MOVE
+%token <str>  INVALID_GAME_TERMINATION
 %token <cval> UNEXPECTED_CHARACTER
 %token END 0 "end of file"
 
@@ -60,6 +62,18 @@ complete_games:
 
 complete_game:
   tag_pair_section movetext_section
+| error invalid_game_termination
+    {
+      /* the reader's error policy decides whether to skip the game or stop */
+      if (!ct_pgn_reader_recover(pgn_reader))
+        YYABORT;
+      yyerrok;
+    }
+;
+
+invalid_game_termination:
+  GAME_TERMINATION
+| INVALID_GAME_TERMINATION
 ;
 
 partial_game:
@@ -87,6 +101,12 @@ movetext_section:
 movetext_section_moves:
   MOVE_NOTATION
 | movetext_section_moves MOVE_NOTATION
+| movetext_section_moves recursive_variation
+;
+
+/* a variation replaces the move before it, so it cannot be the first thing in a game or in another variation */
+recursive_variation:
+  '(' movetext_section_moves ')'
 ;
 
 %%
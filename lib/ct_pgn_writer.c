@@ -0,0 +1,400 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include "ct_pgn_writer.h"
+#include "ct_pgn_writer_private.h"
+#include "ct_utilities.h"
+#include "ct_error.h"
+#include "ct_game_tags.h"
+#include "ct_graph.h"
+#include "ct_graph_private.h"
+#include "ct_move_command.h"
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+enum
+{
+  MAX_LINE_LENGTH = 79,
+  INITIAL_STRING_BUFFER_SIZE = 1024,
+  BLOCK_SIZE = 65536,                /* bytes collected before writing to a file, fd or gzip stream */
+  MOVE_NUMBER_MAX_LENGTH = 12        /* big enough for a 10 digit number and a period */
+};
+
+typedef enum CtPgnWriterSink
+{
+  SINK_STRING, SINK_FILE, SINK_FD, SINK_GZIP
+} CtPgnWriterSink;
+
+typedef struct CtPgnWriterStruct
+{
+  CtPgnWriterSink sink;
+  FILE *file;
+  int fd;
+#ifdef HAVE_LIBZ
+  gzFile gz_file;
+#endif
+  char *buffer;
+  char *end_of_buffer;
+  char *end_of_string;
+  bool has_written_game;
+  /* the following are only valid while a game is being written */
+  CtGameTags game_tags;
+  CtGraph graph;
+  int line_length;
+  unsigned int ply;
+  CtMoveCommandStruct add_move_struct;
+  char move_notation[CT_SAN_MAX_LENGTH];        /* the last move, waiting for its check or checkmate */
+} CtPgnWriterStruct;
+
+static char *mandatory_keys[] = {"Event", "Site", "Date", "Round", "White", "Black", "Result", 0};
+static char *optional_keys[] = {"WhiteElo", "BlackElo", "ECO", 0};
+
+static CtPgnWriter ct_pgn_writer_new_sink(CtPgnWriterSink sink, int buffer_size);
+static void ct_pgn_writer_generate_tag_pair_section(CtPgnWriter pgn_writer);
+static void ct_pgn_writer_generate_movetext_section(CtPgnWriter pgn_writer);
+static void ct_pgn_writer_add_tag(CtPgnWriter pgn_writer, char *key, char *value);
+static void ct_pgn_writer_add_escaped(CtPgnWriter pgn_writer, char *string);
+static void ct_pgn_writer_add_move(void *delegate, CtMove move);
+static void ct_pgn_writer_add_last_move(CtPgnWriter pgn_writer);
+static void ct_pgn_writer_add_movetext(CtPgnWriter pgn_writer, char *token);
+static void ct_pgn_writer_add(CtPgnWriter pgn_writer, char *addition, int length);
+static void ct_pgn_writer_make_room(CtPgnWriter pgn_writer, int length);
+static void ct_pgn_writer_write_block(CtPgnWriter pgn_writer);
+
+CtPgnWriter
+ct_pgn_writer_new(FILE * file)
+{
+  CtPgnWriter pgn_writer;
+
+  if (file == 0)
+    return 0;
+  pgn_writer = ct_pgn_writer_new_sink(SINK_FILE, BLOCK_SIZE);
+  pgn_writer->file = file;
+  return pgn_writer;
+}
+
+CtPgnWriter
+ct_pgn_writer_new_fd(int fd)
+{
+  CtPgnWriter pgn_writer;
+
+  if (fd < 0)
+    return 0;
+  pgn_writer = ct_pgn_writer_new_sink(SINK_FD, BLOCK_SIZE);
+  pgn_writer->fd = fd;
+  return pgn_writer;
+}
+
+CtPgnWriter
+ct_pgn_writer_new_gzip_fd(int fd)
+{
+#ifdef HAVE_LIBZ
+  CtPgnWriter pgn_writer;
+  int gz_fd;
+  gzFile gz_file;
+
+  if (fd < 0)
+    return 0;
+  /* gzclose closes its file descriptor, but the caller still owns fd, so zlib is given a duplicate */
+  gz_fd = dup(fd);
+  if (gz_fd < 0)
+    return 0;
+  gz_file = gzdopen(gz_fd, "wb");
+  if (gz_file == 0)
+  {
+    close(gz_fd);
+    return 0;
+  }
+  gzbuffer(gz_file, BLOCK_SIZE);
+  pgn_writer = ct_pgn_writer_new_sink(SINK_GZIP, BLOCK_SIZE);
+  pgn_writer->gz_file = gz_file;
+  return pgn_writer;
+#else
+  return 0;
+#endif
+}
+
+CtPgnWriter
+ct_pgn_writer_new_string(void)
+{
+  return ct_pgn_writer_new_sink(SINK_STRING, INITIAL_STRING_BUFFER_SIZE);
+}
+
+static CtPgnWriter
+ct_pgn_writer_new_sink(CtPgnWriterSink sink, int buffer_size)
+{
+  CtPgnWriter pgn_writer;
+
+  pgn_writer = ct_malloc(sizeof(CtPgnWriterStruct));
+  pgn_writer->sink = sink;
+  pgn_writer->file = 0;
+  pgn_writer->fd = -1;
+#ifdef HAVE_LIBZ
+  pgn_writer->gz_file = 0;
+#endif
+  pgn_writer->buffer = ct_malloc(buffer_size);
+  pgn_writer->end_of_buffer = pgn_writer->buffer + buffer_size;
+  pgn_writer->end_of_string = pgn_writer->buffer;
+  *pgn_writer->buffer = 0;
+  pgn_writer->has_written_game = false;
+  pgn_writer->add_move_struct = ct_move_command_make(pgn_writer, ct_pgn_writer_add_move);
+  return pgn_writer;
+}
+
+void
+ct_pgn_writer_free(CtPgnWriter pgn_writer)
+{
+  ct_pgn_writer_write_block(pgn_writer);
+#ifdef HAVE_LIBZ
+  if (pgn_writer->sink == SINK_GZIP && gzclose(pgn_writer->gz_file) != Z_OK)
+    ct_error("ct_pgn_writer: gzclose failed");
+#endif
+  ct_free(pgn_writer->buffer);
+  ct_free(pgn_writer);
+}
+
+char *
+ct_pgn_writer_free_to_new_string(CtPgnWriter pgn_writer)
+{
+  char *result = pgn_writer->buffer;
+
+  ct_free(pgn_writer);
+  return result;
+}
+
+void
+ct_pgn_writer_write(CtPgnWriter pgn_writer, CtGraph graph, CtGameTags game_tags)
+{
+  pgn_writer->graph = graph;
+  pgn_writer->game_tags = game_tags;
+  if (pgn_writer->has_written_game)
+    ct_pgn_writer_add(pgn_writer, "\n", 1);        /* games in a stream are separated by an empty line */
+  if (game_tags)
+  {
+    ct_pgn_writer_generate_tag_pair_section(pgn_writer);
+    if (graph)
+      ct_pgn_writer_add(pgn_writer, "\n", 1);
+  }
+  if (graph)
+    ct_pgn_writer_generate_movetext_section(pgn_writer);
+  pgn_writer->has_written_game = true;
+}
+
+void
+ct_pgn_writer_flush(CtPgnWriter pgn_writer)
+{
+  ct_pgn_writer_write_block(pgn_writer);
+  if (pgn_writer->sink == SINK_FILE && fflush(pgn_writer->file) != 0)
+    ct_error("ct_pgn_writer: fflush failed");
+#ifdef HAVE_LIBZ
+  if (pgn_writer->sink == SINK_GZIP && gzflush(pgn_writer->gz_file, Z_SYNC_FLUSH) != Z_OK)
+    ct_error("ct_pgn_writer: gzflush failed");
+#endif
+}
+
+static void
+ct_pgn_writer_generate_tag_pair_section(CtPgnWriter pgn_writer)
+{
+  char **key_ptr;
+  CtGameTags game_tags = pgn_writer->game_tags;
+
+  for (key_ptr = mandatory_keys; *key_ptr != 0; key_ptr++)
+    ct_pgn_writer_add_tag(pgn_writer, *key_ptr, ct_game_tags_get(game_tags, *key_ptr));
+  for (key_ptr = optional_keys; *key_ptr != 0; key_ptr++)
+  {
+    char *tag_value = ct_game_tags_get(game_tags, *key_ptr);
+
+    if (strcmp(tag_value, "?") != 0)
+      ct_pgn_writer_add_tag(pgn_writer, *key_ptr, tag_value);
+  }
+}
+
+static void
+ct_pgn_writer_generate_movetext_section(CtPgnWriter pgn_writer)
+{
+  CtGameTags game_tags = pgn_writer->game_tags;
+
+  pgn_writer->line_length = 0;
+  pgn_writer->ply = 0;
+  *pgn_writer->move_notation = 0;
+  ct_graph_for_each_move_made(pgn_writer->graph, &pgn_writer->add_move_struct);
+  ct_pgn_writer_add_last_move(pgn_writer);
+  ct_pgn_writer_add_movetext(pgn_writer, game_tags ? ct_game_tags_get(game_tags, "Result") : "*");
+  ct_pgn_writer_add(pgn_writer, "\n", 1);
+}
+
+static void
+ct_pgn_writer_add_tag(CtPgnWriter pgn_writer, char *key, char *value)
+{
+  ct_pgn_writer_add(pgn_writer, "[", 1);
+  ct_pgn_writer_add(pgn_writer, key, strlen(key));
+  ct_pgn_writer_add(pgn_writer, " \"", 2);
+  ct_pgn_writer_add_escaped(pgn_writer, value);
+  ct_pgn_writer_add(pgn_writer, "\"]\n", 3);
+}
+
+static void
+ct_pgn_writer_add_escaped(CtPgnWriter pgn_writer, char *string)
+{
+  char *copy_to;
+
+  /* if every character needed to be escaped with a \, the result would be twice as long */
+  ct_pgn_writer_make_room(pgn_writer, 2 * strlen(string));
+  copy_to = pgn_writer->end_of_string;
+  for (; *string != 0; string++)
+  {
+    if (*string == '\\' || *string == '"')
+      *copy_to++ = '\\';
+    *copy_to++ = *string;
+  }
+  *copy_to = 0;
+  pgn_writer->end_of_string = copy_to;
+}
+
+/* the graph is at the position before move, which is the position after the last move -- so the last move's check or
+   checkmate comes from the same legal moves that are used to write this one */
+static void
+ct_pgn_writer_add_move(void *delegate, CtMove move)
+{
+  CtPgnWriter pgn_writer = (CtPgnWriter) delegate;
+  int ply = pgn_writer->ply++;
+
+  ct_pgn_writer_add_last_move(pgn_writer);
+  if (ply % 2 == 0)
+  {
+    char move_number_text[MOVE_NUMBER_MAX_LENGTH + 1];
+
+    snprintf(move_number_text, sizeof(move_number_text), "%d.", ply / 2 + 1);
+    ct_pgn_writer_add_movetext(pgn_writer, move_number_text);
+  }
+  ct_graph_move_to_san_without_check(pgn_writer->graph, move, pgn_writer->move_notation);
+}
+
+static void
+ct_pgn_writer_add_last_move(CtPgnWriter pgn_writer)
+{
+  if (*pgn_writer->move_notation == 0)
+    return;
+  ct_graph_add_check_to_san(pgn_writer->graph, pgn_writer->move_notation);
+  ct_pgn_writer_add_movetext(pgn_writer, pgn_writer->move_notation);
+  *pgn_writer->move_notation = 0;
+}
+
+/* movetext tokens are separated by a space, or by a newline if the token would not fit on the current line */
+static void
+ct_pgn_writer_add_movetext(CtPgnWriter pgn_writer, char *token)
+{
+  int length = strlen(token);
+
+  if (pgn_writer->line_length > 0)
+  {
+    if (pgn_writer->line_length + 1 + length > MAX_LINE_LENGTH)
+    {
+      ct_pgn_writer_add(pgn_writer, "\n", 1);
+      pgn_writer->line_length = 0;
+    }
+    else
+    {
+      ct_pgn_writer_add(pgn_writer, " ", 1);
+      pgn_writer->line_length++;
+    }
+  }
+  ct_pgn_writer_add(pgn_writer, token, length);
+  pgn_writer->line_length += length;
+}
+
+static void
+ct_pgn_writer_add(CtPgnWriter pgn_writer, char *addition, int length)
+{
+  ct_pgn_writer_make_room(pgn_writer, length);
+  memcpy(pgn_writer->end_of_string, addition, length);
+  pgn_writer->end_of_string += length;
+  *pgn_writer->end_of_string = 0;
+}
+
+/* makes sure length characters plus a null terminator fit in the buffer, by writing out the buffer or (for strings)
+   by growing it */
+static void
+ct_pgn_writer_make_room(CtPgnWriter pgn_writer, int length)
+{
+  if (pgn_writer->end_of_string + length + 1 <= pgn_writer->end_of_buffer)
+    return;
+  if (pgn_writer->sink != SINK_STRING)
+  {
+    ct_pgn_writer_write_block(pgn_writer);
+    if (pgn_writer->end_of_string + length + 1 <= pgn_writer->end_of_buffer)
+      return;
+  }
+  while (pgn_writer->end_of_string + length + 1 > pgn_writer->end_of_buffer)
+  {
+    int new_size = 2 * (pgn_writer->end_of_buffer - pgn_writer->buffer);
+    char *new_buffer = ct_realloc(pgn_writer->buffer, new_size);
+
+    pgn_writer->end_of_string += new_buffer - pgn_writer->buffer;
+    pgn_writer->buffer = new_buffer;
+    pgn_writer->end_of_buffer = new_buffer + new_size;
+  }
+}
+
+static void
+ct_pgn_writer_write_block(CtPgnWriter pgn_writer)
+{
+  char *block = pgn_writer->buffer;
+  int length = pgn_writer->end_of_string - block;
+  ssize_t bytes_written;
+
+  if (pgn_writer->sink == SINK_STRING || length == 0)
+    return;
+  switch (pgn_writer->sink)
+  {
+  case SINK_FILE:
+    if (fwrite(block, 1, length, pgn_writer->file) != (size_t) length)
+      ct_error("ct_pgn_writer: fwrite failed");
+    break;
+  case SINK_FD:
+    while (length > 0)
+    {
+      bytes_written = write(pgn_writer->fd, block, length);
+      if (bytes_written < 0 && errno == EINTR)
+        continue;
+      if (bytes_written <= 0)
+      {
+        ct_error("ct_pgn_writer: write failed");
+        break;
+      }
+      block += bytes_written;
+      length -= bytes_written;
+    }
+    break;
+  case SINK_GZIP:
+#ifdef HAVE_LIBZ
+    if (gzwrite(pgn_writer->gz_file, block, length) != length)
+      ct_error("ct_pgn_writer: gzwrite failed");
+#endif
+    break;
+  default:
+    break;
+  }
+  pgn_writer->end_of_string = pgn_writer->buffer;
+  *pgn_writer->end_of_string = 0;
+}
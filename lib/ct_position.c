@@ -28,6 +28,8 @@
 static CtPosition clear_position = 0;
 static CtPosition initial_position = 0;
 
+static void ct_position_for_each_piece_in(CtPosition position, CtBitBoard pieces, CtPieceCommand piece_command);
+
 void
 ct_position_init(void)
 {
@@ -101,6 +103,8 @@ ct_position_get_piece(CtPosition position, CtSquare square)
   return position->pieces[square];
 }
 
+/* the bit boards for all of a color's pieces (WHITE_PIECES and BLACK_PIECES) are kept up to date along with the piece's
+   own bit board */
 void
 ct_position_set_piece(CtPosition position, CtSquare square, CtPiece value)
 {
@@ -111,31 +115,39 @@ ct_position_set_piece(CtPosition position, CtSquare square, CtPiece value)
 
   *old_bb &= ~square_bb;
   *new_bb |= square_bb;
+  if (old_value != EMPTY)
+    position->bit_board_array[ct_piece_color(old_value) | WHITE_PIECES] &= ~square_bb;
+  if (value != EMPTY)
+    position->bit_board_array[ct_piece_color(value) | WHITE_PIECES] |= square_bb;
   position->pieces[square] = value;
 }
 
 void
 ct_position_for_each_piece(CtPosition position, CtPieceCommand piece_command)
 {
-  CtPiece *piece = position->pieces;
-  CtSquare square;
-
-  for (square = 0; square < NUMBER_OF_SQUARES; square++, piece++)
-    if (*piece != EMPTY)
-      ct_piece_command_execute(piece_command, *piece, square);
+  ct_position_for_each_piece_in(position, ~position->bit_board_array[EMPTY], piece_command);
 }
 
 void
 ct_position_for_each_active_piece(CtPosition position, CtPieceCommand piece_command)
 {
-  bool is_wtm = position->is_white_to_move;
-  CtPieceColor piece_color = is_wtm ? WHITE_PIECE : BLACK_PIECE;
-  CtPiece *piece = position->pieces;
+  CtBitBoard pieces = position->bit_board_array[position->is_white_to_move ? WHITE_PIECES : BLACK_PIECES];
+
+  ct_position_for_each_piece_in(position, pieces, piece_command);
+}
+
+/* visits only the occupied squares, from A1 up to H8 */
+static void
+ct_position_for_each_piece_in(CtPosition position, CtBitBoard pieces, CtPieceCommand piece_command)
+{
   CtSquare square;
 
-  for (square = 0; square < NUMBER_OF_SQUARES; square++, piece++)
-    if (*piece != EMPTY && ct_piece_color(*piece) == piece_color)
-      ct_piece_command_execute(piece_command, *piece, square);
+  while (pieces)
+  {
+    square = ct_bit_board_find_first_square(pieces);
+    pieces &= pieces - 1;
+    ct_piece_command_execute(piece_command, position->pieces[square], square);
+  }
 }
 
 CtBitBoard
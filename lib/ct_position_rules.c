@@ -19,31 +19,18 @@
 #include "ct_position.h"
 #include "ct_position_private.h"
 #include "ct_bit_board.h"
+#include "ct_move.h"
+#include "ct_piece.h"
+#include "ct_square.h"
 #include "ct_utilities.h"
 
-typedef struct CanCastleHelperStruct *CanCastleHelper;
-typedef struct CanCastleHelperStruct
-{
-  CtCastleRights castle_kingside_bit;
-  CtCastleRights castle_queenside_bit;
-  CtSquare king_square;
-  bool (*is_attacking) (CtBitBoardArray bit_board_array, CtSquare square);
-  bool (*is_attacking_between) (CtPosition position, CtSquare from, CtSquare to);
-} CanCastleHelperStruct;
-
 static bool ct_position_is_white_king_attacked(CtPosition position);
 static bool ct_position_is_black_king_attacked(CtPosition position);
+static CtCastleRights ct_position_can_white_castle(CtPosition position);
+static CtCastleRights ct_position_can_black_castle(CtPosition position);
 static bool ct_position_is_white_attacking_between(CtPosition position, CtSquare from, CtSquare to);
 static bool ct_position_is_black_attacking_between(CtPosition position, CtSquare from, CtSquare to);
 
-static CanCastleHelperStruct white_castle_helper[] = {{
-    CASTLE_K, CASTLE_Q, E1, ct_bit_board_array_is_black_attacking, ct_position_is_black_attacking_between
-}};
-
-static CanCastleHelperStruct black_castle_helper[] = {{
-    CASTLE_k, CASTLE_q, E8, ct_bit_board_array_is_white_attacking, ct_position_is_white_attacking_between
-}};
-
 bool
 ct_position_is_legal(CtPosition position)
 {
@@ -68,85 +55,155 @@ ct_position_is_check(CtPosition position)
   return result;
 }
 
-static bool
-ct_position_is_white_king_attacked(CtPosition position)
+CtCastleRights
+ct_position_can_castle(CtPosition position)
+{
+  if (position->castle == CASTLE_NONE)
+    return CASTLE_NONE;
+  if (position->is_white_to_move)
+    return ct_position_can_white_castle(position);
+  return ct_position_can_black_castle(position);
+}
+
+/* the pieces of both colors attacking square */
+CtBitBoard
+ct_position_attackers_to(CtPosition position, CtSquare square)
 {
-  bool result = false;
   CtBitBoardArray bit_board_array = position->bit_board_array;
-  CtSquare square = ct_bit_board_find_first_square(bit_board_array[WHITE_KING]);
 
-  if (square >= 0)
-    result = ct_bit_board_array_is_black_attacking(bit_board_array, square);
-  return result;
+  return ct_bit_board_array_attackers_to(bit_board_array, square, ~bit_board_array[EMPTY]);
 }
 
-static bool
-ct_position_is_black_king_attacked(CtPosition position)
+/* the pieces of the side to move that cannot leave the line between their king and an enemy queen, rook or bishop */
+CtBitBoard
+ct_position_pinned(CtPosition position)
 {
-  bool result = false;
   CtBitBoardArray bit_board_array = position->bit_board_array;
-  CtSquare square = ct_bit_board_find_first_square(bit_board_array[BLACK_KING]);
+  CtPieceColor color = position->is_white_to_move ? WHITE_PIECE : BLACK_PIECE;
+  CtSquare king_square = ct_bit_board_find_first_square(bit_board_array[color | WHITE_KING]);
 
-  if (square >= 0)
-    result = ct_bit_board_array_is_white_attacking(bit_board_array, square);
-  return result;
+  if (king_square < 0)
+    return BITB_EMPTY;
+  return ct_bit_board_array_pinned(bit_board_array, king_square, color);
 }
 
-CtCastleRights
-ct_position_can_castle(CtPosition position)
+/* Answers whether move, made by the side to move, would check the enemy king, without making it.  The moved piece
+   checks directly when its destination is one of the squares from which its kind attacks the king, given the pieces
+   left standing.  A discovered check needs a square the move empties -- the origin, the pawn captured en passant or
+   the castling rook's corner -- to share a line with the king, so the queens, rooks and bishops behind are looked at
+   only then. */
+bool
+ct_position_gives_check(CtPosition position, CtMove move)
 {
-  CtCastleRights result = CASTLE_NONE;
-  CtCastleRights castle = position->castle;
-  CtPiece *pieces = position->pieces;
-  bool verified_king_not_in_check = false;
-  CanCastleHelper helper = position->is_white_to_move ? white_castle_helper : black_castle_helper;
-  CtSquare king_square = helper->king_square;
-  CtSquare verify_to;
-
-  if (castle == CASTLE_NONE)
-    return result;
-
-  if ((castle & helper->castle_kingside_bit) != 0
-      && pieces[king_square + D_E] == EMPTY
-      && pieces[king_square + 2 * D_E] == EMPTY)
+  CtBitBoardArray bit_board_array = position->bit_board_array;
+  CtSquare from = ct_move_from(move);
+  CtSquare to = ct_move_to(move);
+  CtPiece piece = position->pieces[from];
+  CtPieceColor color = ct_piece_color(piece);
+  CtSquare king_square = ct_bit_board_find_first_square(bit_board_array[(color ^ COLOR_BIT) | WHITE_KING]);
+  CtBitBoard occupied = (~bit_board_array[EMPTY] & ~ct_bit_board_make(from)) | ct_bit_board_make(to);
+  CtSquare emptied = from;
+  CtSquare rook_to = SQUARE_NOT_FOUND;
+
+  if (king_square < 0)
+    return false;
+  switch (ct_move_type(move))
   {
-    if (helper->is_attacking(position->bit_board_array, king_square))
-      return result;
-    verified_king_not_in_check = true;
-    if (!helper->is_attacking_between(position, king_square + D_E, king_square + 2 * D_E))
-      result |= CASTLE_K;
+  case PROMOTION:
+    piece = ct_move_promotes_to(move);
+    break;
+  case EN_PASSANT_CAPTURE:
+    emptied = ct_square_make(ct_square_file(to), ct_square_rank(from));
+    occupied &= ~ct_bit_board_make(emptied);
+    break;
+  case CASTLE_KINGSIDE:
+    emptied = from + 3 * D_E;
+    rook_to = from + D_E;
+    break;
+  case CASTLE_QUEENSIDE:
+    emptied = from + 4 * D_W;
+    rook_to = from + D_W;
+    break;
+  default:
+    break;
   }
-
-  if ((castle & helper->castle_queenside_bit) != 0
-      && pieces[king_square + D_W] == EMPTY
-      && pieces[king_square + 2 * D_W] == EMPTY
-      && pieces[king_square + 3 * D_W] == EMPTY)
+  if (rook_to != SQUARE_NOT_FOUND)
   {
-    verify_to = verified_king_not_in_check ? king_square + D_W : king_square;
-    if (!helper->is_attacking_between(position, king_square + 2 * D_W, verify_to))
-      result |= CASTLE_Q;
+    occupied = (occupied & ~ct_bit_board_make(emptied)) | ct_bit_board_make(rook_to);
+    if (ct_bit_board_is_attacking_from(color | WHITE_ROOK, rook_to, king_square, occupied))
+      return true;
   }
-  return result;
+  else if (ct_bit_board_is_attacking_from(piece, to, king_square, occupied))
+    return true;
+  if (ct_bit_board_line(from, king_square) == BITB_EMPTY && ct_bit_board_line(emptied, king_square) == BITB_EMPTY)
+    return false;
+  return (ct_bit_board_array_attackers_to(bit_board_array, king_square, occupied)
+          & bit_board_array[color | WHITE_PIECES]) != 0;
 }
 
-static bool
-ct_position_is_white_attacking_between(CtPosition position, CtSquare from, CtSquare to)
-{
-  bool result = false;
-  CtSquare square;
+/* The white and black versions of the rules are written once and expanded for each color, so the color is settled
+   when the rule is chosen and not again for every square tested. */
+#define CT_POSITION_IS_KING_ATTACKED(color, COLOR, enemy)                                                             \
+  static bool                                                                                                         \
+  ct_position_is_##color##_king_attacked(CtPosition position)                                                         \
+  {                                                                                                                   \
+    bool result = false;                                                                                              \
+    CtBitBoardArray bit_board_array = position->bit_board_array;                                                      \
+    CtSquare square = ct_bit_board_find_first_square(bit_board_array[COLOR##_KING]);                                  \
+                                                                                                                      \
+    if (square >= 0)                                                                                                  \
+      result = ct_bit_board_array_is_##enemy##_attacking(bit_board_array, square);                                    \
+    return result;                                                                                                    \
+  }
 
-  for (square = from; result == false && square <= to; square++)
-    result = ct_bit_board_array_is_white_attacking(position->bit_board_array, square);
-  return result;
-}
+#define CT_POSITION_CAN_CASTLE(color, enemy, KINGSIDE_BIT, QUEENSIDE_BIT, KING_SQUARE)                                \
+  static CtCastleRights                                                                                               \
+  ct_position_can_##color##_castle(CtPosition position)                                                               \
+  {                                                                                                                   \
+    CtCastleRights result = CASTLE_NONE;                                                                              \
+    CtCastleRights castle = position->castle;                                                                         \
+    CtPiece *pieces = position->pieces;                                                                               \
+    bool verified_king_not_in_check = false;                                                                          \
+    CtSquare verify_to;                                                                                               \
+                                                                                                                      \
+    if ((castle & KINGSIDE_BIT) != 0                                                                                  \
+        && pieces[KING_SQUARE + D_E] == EMPTY                                                                         \
+        && pieces[KING_SQUARE + 2 * D_E] == EMPTY)                                                                    \
+    {                                                                                                                 \
+      if (ct_bit_board_array_is_##enemy##_attacking(position->bit_board_array, KING_SQUARE))                          \
+        return result;                                                                                                \
+      verified_king_not_in_check = true;                                                                              \
+      if (!ct_position_is_##enemy##_attacking_between(position, KING_SQUARE + D_E, KING_SQUARE + 2 * D_E))            \
+        result |= CASTLE_K;                                                                                           \
+    }                                                                                                                 \
+                                                                                                                      \
+    if ((castle & QUEENSIDE_BIT) != 0                                                                                 \
+        && pieces[KING_SQUARE + D_W] == EMPTY                                                                         \
+        && pieces[KING_SQUARE + 2 * D_W] == EMPTY                                                                     \
+        && pieces[KING_SQUARE + 3 * D_W] == EMPTY)                                                                    \
+    {                                                                                                                 \
+      verify_to = verified_king_not_in_check ? KING_SQUARE + D_W : KING_SQUARE;                                       \
+      if (!ct_position_is_##enemy##_attacking_between(position, KING_SQUARE + 2 * D_W, verify_to))                    \
+        result |= CASTLE_Q;                                                                                           \
+    }                                                                                                                 \
+    return result;                                                                                                    \
+  }
 
-static bool
-ct_position_is_black_attacking_between(CtPosition position, CtSquare from, CtSquare to)
-{
-  bool result = false;
-  CtSquare square;
+#define CT_POSITION_IS_ATTACKING_BETWEEN(color)                                                                       \
+  static bool                                                                                                         \
+  ct_position_is_##color##_attacking_between(CtPosition position, CtSquare from, CtSquare to)                         \
+  {                                                                                                                   \
+    bool result = false;                                                                                              \
+    CtSquare square;                                                                                                  \
+                                                                                                                      \
+    for (square = from; result == false && square <= to; square++)                                                    \
+      result = ct_bit_board_array_is_##color##_attacking(position->bit_board_array, square);                          \
+    return result;                                                                                                    \
+  }
 
-  for (square = from; result == false && square <= to; square++)
-    result = ct_bit_board_array_is_black_attacking(position->bit_board_array, square);
-  return result;
-}
+CT_POSITION_IS_KING_ATTACKED(white, WHITE, black)
+CT_POSITION_IS_KING_ATTACKED(black, BLACK, white)
+CT_POSITION_CAN_CASTLE(white, black, CASTLE_K, CASTLE_Q, E1)
+CT_POSITION_CAN_CASTLE(black, white, CASTLE_k, CASTLE_q, E8)
+CT_POSITION_IS_ATTACKING_BETWEEN(white)
+CT_POSITION_IS_ATTACKING_BETWEEN(black)
@@ -0,0 +1,179 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <config.h>
+#include "ct_position.h"
+#include "ct_position_private.h"
+#include "ct_bit_board.h"
+#include "ct_move.h"
+#include "ct_piece.h"
+#include "ct_square.h"
+
+enum
+{
+  PIECE_TYPE_MASK = 7,
+  MAX_EXCHANGE_LENGTH = 32        /* no more than 32 pieces can take part in an exchange */
+};
+
+/* in centipawns, indexed by the piece without its color bit -- the king is worth more than everything else together,
+   so capturing into a defended square with it never pays */
+static const int see_values[PIECE_TYPE_MASK + 1] = {
+  0, 100, 10000, 300, 900, 500, 300, 0
+};
+
+/* the attackers are tried from the least valuable to the most */
+static const CtPiece least_valuable_first[] = {
+  WHITE_PAWN, WHITE_KNIGHT, WHITE_BISHOP, WHITE_ROOK, WHITE_QUEEN, WHITE_KING
+};
+
+static CtBitBoard ct_position_see_start(CtPosition position, CtMove move, int *captured_value, int *moved_value);
+static CtPiece ct_position_least_valuable_attacker(CtBitBoardArray bit_board_array, CtBitBoard attackers,
+                                                   CtPieceColor color, CtSquare *from);
+
+/* Returns the material won by move, after both sides have made every capture on its destination square that pays
+   for them, in least valuable attacker order.  Pins and checks are not considered.  Each capture is pushed on a swap
+   list and the list is then folded back from its end, letting each side stop capturing when that is better. */
+int
+ct_position_see(CtPosition position, CtMove move)
+{
+  CtBitBoardArray bit_board_array = position->bit_board_array;
+  CtSquare to = ct_move_to(move);
+  CtSquare from = ct_move_from(move);
+  CtPieceColor color = ct_piece_color(position->pieces[from]);
+  int gain[MAX_EXCHANGE_LENGTH];
+  int depth = 0;
+  int on_square;
+  CtBitBoard occupied;
+  CtPiece attacker;
+
+  occupied = ct_position_see_start(position, move, &gain[0], &on_square);
+  do
+  {
+    depth++;
+    color ^= COLOR_BIT;
+    occupied &= ~ct_bit_board_make(from);
+    gain[depth] = on_square - gain[depth - 1];        /* in case color has a piece to capture with */
+    attacker = ct_position_least_valuable_attacker(bit_board_array,
+                                                   ct_bit_board_array_attackers_to(bit_board_array, to, occupied),
+                                                   color, &from);
+    on_square = see_values[attacker & PIECE_TYPE_MASK];
+  }
+  while (attacker != EMPTY && depth + 1 < MAX_EXCHANGE_LENGTH);
+  while (--depth)
+    gain[depth - 1] = -(-gain[depth - 1] > gain[depth] ? -gain[depth - 1] : gain[depth]);
+  return gain[0];
+}
+
+/* answers whether ct_position_see(position, move) >= threshold, stopping as soon as the outcome is certain */
+bool
+ct_position_see_ge(CtPosition position, CtMove move, int threshold)
+{
+  CtBitBoardArray bit_board_array = position->bit_board_array;
+  CtSquare to = ct_move_to(move);
+  CtSquare from = ct_move_from(move);
+  CtPieceColor color = ct_piece_color(position->pieces[from]);
+  int captured_value, on_square, swap;
+  bool result = true;
+  CtBitBoard occupied;
+  CtPiece attacker;
+
+  occupied = ct_position_see_start(position, move, &captured_value, &on_square);
+  swap = captured_value - threshold;
+  if (swap < 0)
+    return false;                /* even if the capture goes unanswered */
+  swap = on_square - swap;
+  if (swap <= 0)
+    return true;                /* even if the moved piece is lost */
+  occupied &= ~ct_bit_board_make(from);
+  for (;;)
+  {
+    color ^= COLOR_BIT;
+    attacker = ct_position_least_valuable_attacker(bit_board_array,
+                                                   ct_bit_board_array_attackers_to(bit_board_array, to, occupied),
+                                                   color, &from);
+    if (attacker == EMPTY)
+      break;
+    result = !result;
+    if ((attacker & PIECE_TYPE_MASK) == WHITE_KING)
+    {
+      /* the king may only capture if the square is no longer defended */
+      occupied &= ~ct_bit_board_make(from);
+      if (ct_position_least_valuable_attacker(bit_board_array,
+                                              ct_bit_board_array_attackers_to(bit_board_array, to, occupied),
+                                              color ^ COLOR_BIT, &from) != EMPTY)
+        result = !result;
+      break;
+    }
+    swap = see_values[attacker & PIECE_TYPE_MASK] - swap;
+    if (swap < (int) result)
+      break;
+    occupied &= ~ct_bit_board_make(from);
+  }
+  return result;
+}
+
+/* makes the first capture, returning the pieces still on the board other than the one that moved */
+static CtBitBoard
+ct_position_see_start(CtPosition position, CtMove move, int *captured_value, int *moved_value)
+{
+  CtSquare from = ct_move_from(move);
+  CtSquare to = ct_move_to(move);
+  CtBitBoard occupied = ~position->bit_board_array[EMPTY];
+
+  *captured_value = see_values[position->pieces[to] & PIECE_TYPE_MASK];
+  *moved_value = see_values[position->pieces[from] & PIECE_TYPE_MASK];
+  switch (ct_move_type(move))
+  {
+  case EN_PASSANT_CAPTURE:
+    *captured_value = see_values[WHITE_PAWN];
+    occupied &= ~ct_bit_board_make(ct_square_make(ct_square_file(to), ct_square_rank(from)));
+    break;
+  case PROMOTION:
+    *moved_value = see_values[ct_move_promotes_to(move) & PIECE_TYPE_MASK];
+    *captured_value += *moved_value - see_values[WHITE_PAWN];
+    break;
+  case CASTLE_KINGSIDE:
+  case CASTLE_QUEENSIDE:
+    *captured_value = 0;
+    *moved_value = 0;
+    break;
+  default:
+    break;
+  }
+  return occupied;
+}
+
+static CtPiece
+ct_position_least_valuable_attacker(CtBitBoardArray bit_board_array, CtBitBoard attackers, CtPieceColor color,
+                                    CtSquare *from)
+{
+  CtBitBoard bit_board;
+  int index;
+
+  attackers &= bit_board_array[color | WHITE_PIECES];
+  if (attackers == BITB_EMPTY)
+    return EMPTY;
+  for (index = 0; index < (int) (sizeof(least_valuable_first) / sizeof(least_valuable_first[0])); index++)
+  {
+    bit_board = attackers & bit_board_array[color | least_valuable_first[index]];
+    if (bit_board)
+    {
+      *from = ct_bit_board_find_first_square(bit_board);
+      return color | least_valuable_first[index];
+    }
+  }
+  return EMPTY;
+}
@@ -19,75 +19,26 @@
 #include "ct_rays.h"
 #include "ct_utilities.h"
 #include "ct_square.h"
+#include "ct_rays_tables.h"
 #include <strings.h>
 
 typedef struct CtRaysStruct
 {
-  unsigned char *directions_available;
-  CtDirection *direction_array;
+  const unsigned char *directions_available;
+  const CtDirection *direction_array;
   unsigned int directions_remaining;
   unsigned int bit;
 } CtRaysStruct;
 
-static unsigned char king_directions_available[64];
-static unsigned char knight_directions_available[64];
-static unsigned char rook_directions_available[64];
-static unsigned char bishop_directions_available[64];
-
-static CtDirection adjacent_direction_array[] = {
+static const CtDirection adjacent_direction_array[] = {
   D_N, D_NE, D_E, D_SE, D_S, D_SW, D_W, D_NW
 };
 
-static CtDirection knight_direction_array[] = {
+static const CtDirection knight_direction_array[] = {
   D_NNE, D_ENE, D_ESE, D_SSE, D_SSW, D_WSW, D_WNW, D_NNW
 };
 
-enum
-{
-  ROOK_MASK = 0x55,
-  BISHOP_MASK = 0xAA,
-};
-
-CtRays ct_rays_new(unsigned char *directions_available, CtDirection *direction_array);
-
-void
-ct_rays_init(void)
-{
-  CtSquare square;
-  CtRank rank;
-  CtFile file;
-
-  for (square = 0; square < NUMBER_OF_SQUARES; square++)
-  {
-    king_directions_available[square] = 0xFF;
-    knight_directions_available[square] = 0xFF;
-  }
-  for (rank = RANK_1; rank <= LAST_RANK; rank++)
-  {
-    king_directions_available[ct_square_make(FILE_A, rank)] &= 0x1F;
-    king_directions_available[ct_square_make(LAST_FILE, rank)] &= 0xF1;
-
-    knight_directions_available[ct_square_make(FILE_A, rank)] &= 0x0F;
-    knight_directions_available[ct_square_make(FILE_B, rank)] &= 0x9F;
-    knight_directions_available[ct_square_make(LAST_FILE - 1, rank)] &= 0xF9;
-    knight_directions_available[ct_square_make(LAST_FILE, rank)] &= 0xF0;
-  }
-  for (file = FILE_A; file <= LAST_FILE; file++)
-  {
-    king_directions_available[ct_square_make(file, RANK_1)] &= 0xC7;
-    king_directions_available[ct_square_make(file, LAST_RANK)] &= 0x7C;
-
-    knight_directions_available[ct_square_make(file, RANK_1)] &= 0xC3;
-    knight_directions_available[ct_square_make(file, RANK_2)] &= 0xE7;
-    knight_directions_available[ct_square_make(file, LAST_RANK - 1)] &= 0x7E;
-    knight_directions_available[ct_square_make(file, LAST_RANK)] &= 0x3C;
-  }
-  for (square = 0; square < NUMBER_OF_SQUARES; square++)
-  {
-    rook_directions_available[square] = king_directions_available[square] & ROOK_MASK;
-    bishop_directions_available[square] = king_directions_available[square] & BISHOP_MASK;
-  }
-}
+CtRays ct_rays_new(const unsigned char *directions_available, const CtDirection * direction_array);
 
 CtRays
 ct_rays_new_king(void)
@@ -121,7 +72,7 @@ ct_rays_new_bishop(void)
 }
 
 CtRays
-ct_rays_new(unsigned char *directions_available, CtDirection *direction_array)
+ct_rays_new(const unsigned char *directions_available, const CtDirection * direction_array)
 {
   CtRays rays;
 
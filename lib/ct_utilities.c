@@ -17,9 +17,24 @@
 
 #include <config.h>
 #include "ct_utilities.h"
+#include "ct_cpu_private.h"
 #include "ct_error.h"
 #include <stdlib.h>
 
+enum
+{
+  SHORT_TEXT_LENGTH = 32        /* shorter text is not worth loading into vector registers */
+};
+
+static int ct_count_newlines_generic(const char *text, int length, int *last_line_length);
+#ifdef CT_CPU_X86_64
+static int ct_count_newlines_sse2(const char *text, int length, int *last_line_length);
+static int ct_count_newlines_avx2(const char *text, int length, int *last_line_length);
+#endif
+
+/* chosen for the processor by ct_utilities_select_kernels */
+static int (*count_newlines_kernel) (const char *text, int length, int *last_line_length) = ct_count_newlines_generic;
+
 void *
 ct_malloc(int size)
 {
@@ -47,3 +62,91 @@ ct_free(void *ptr)
 {
   free(ptr);
 }
+
+void
+ct_utilities_select_kernels(CtCpuLevel level)
+{
+  count_newlines_kernel = ct_count_newlines_generic;
+#ifdef CT_CPU_X86_64
+  if (level >= CPU_AVX2)
+    count_newlines_kernel = ct_count_newlines_avx2;
+  else if (level >= CPU_POPCNT)
+    count_newlines_kernel = ct_count_newlines_sse2;
+#endif
+}
+
+/* the scanner counts the lines of every token, most of them a few characters long */
+int
+ct_count_newlines(const char *text, int length, int *last_line_length)
+{
+  if (length < SHORT_TEXT_LENGTH)
+    return ct_count_newlines_generic(text, length, last_line_length);
+  return count_newlines_kernel(text, length, last_line_length);
+}
+
+static int
+ct_count_newlines_generic(const char *text, int length, int *last_line_length)
+{
+  int newlines = 0;
+  int index;
+
+  *last_line_length = length;
+  for (index = 0; index < length; index++)
+  {
+    if (text[index] == '\n')
+    {
+      newlines++;
+      *last_line_length = length - index - 1;
+    }
+  }
+  return newlines;
+}
+
+#ifdef CT_CPU_X86_64
+/* Each block of characters is compared with a newline at once, and the comparison squeezed into a mask with a bit for
+   each character.  The newlines are the bits set, and the last of them is the highest bit of the last mask that is
+   not empty.  The characters after the last whole block are counted one at a time. */
+static CT_TARGET_POPCNT int
+ct_count_newlines_sse2(const char *text, int length, int *last_line_length)
+{
+  __m128i newline = _mm_set1_epi8('\n');
+  int newlines = 0, last_newline = -1;
+  int index, tail_newlines, tail_length;
+  unsigned int mask;
+
+  for (index = 0; index + 16 <= length; index += 16)
+  {
+    mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (text + index)), newline));
+    if (mask)
+    {
+      newlines += __builtin_popcount(mask);
+      last_newline = index + 31 - __builtin_clz(mask);
+    }
+  }
+  tail_newlines = ct_count_newlines_generic(text + index, length - index, &tail_length);
+  *last_line_length = tail_newlines ? tail_length : length - last_newline - 1;
+  return newlines + tail_newlines;
+}
+
+static CT_TARGET_AVX2 int
+ct_count_newlines_avx2(const char *text, int length, int *last_line_length)
+{
+  __m256i newline = _mm256_set1_epi8('\n');
+  int newlines = 0, last_newline = -1;
+  int index, tail_newlines, tail_length;
+  unsigned int mask;
+
+  for (index = 0; index + 32 <= length; index += 32)
+  {
+    mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *) (text + index)), newline));
+    if (mask)
+    {
+      newlines += __builtin_popcount(mask);
+      last_newline = index + 31 - __builtin_clz(mask);
+    }
+  }
+  tail_newlines = ct_count_newlines_generic(text + index, length - index, &tail_length);
+  *last_line_length = tail_newlines ? tail_length : length - last_newline - 1;
+  return newlines + tail_newlines;
+}
+#endif
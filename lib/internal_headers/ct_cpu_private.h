@@ -0,0 +1,38 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_CPU_PRIVATE_H
+#define CT_CPU_PRIVATE_H
+
+#include "ct_types.h"
+
+/* the kernels beyond CPU_GENERIC are only compiled for x86-64, each with the instructions of its level enabled just
+   for that function, so the rest of the library runs on any processor */
+#if defined(HAVE_IMMINTRIN_H) && defined(__GNUC__) && defined(__x86_64__)
+#define CT_CPU_X86_64 1
+#include <immintrin.h>
+#define CT_TARGET_POPCNT __attribute__ ((target("popcnt")))
+#define CT_TARGET_AVX2 __attribute__ ((target("popcnt,avx2,bmi,bmi2")))
+#define CT_TARGET_AVX512 __attribute__ ((target("popcnt,avx2,bmi,bmi2,avx512f")))
+#endif
+
+/* each module with kernels switches them to those of level */
+void ct_bit_board_select_kernels(CtCpuLevel level);
+void ct_bit_board_batch_select_kernels(CtCpuLevel level);
+void ct_utilities_select_kernels(CtCpuLevel level);
+
+#endif                                /* CT_CPU_PRIVATE_H */
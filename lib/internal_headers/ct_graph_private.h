@@ -21,6 +21,11 @@
 #include "ct_types.h"
 #include "ct_types_internal.h"
 
+/* The move stack holds the line of moves that have been made, which can run past the current ply after
+   ct_graph_goto_ply.  A snapshot of the position is taken every GRAPH_SNAPSHOT_INTERVAL plies along the line, so that
+   any ply can be reached from a snapshot with fewer moves than that.  Restoring a snapshot empties the move maker's
+   undo stack, so undo_ply is the lowest ply that can be reached by unmaking moves.  The legal moves of the position at
+   legal_moves_ply are kept until a move is made or unmade, so going back to that ply along the line finds them again. */
 typedef struct CtGraphStruct
 {
   CtPosition position;
@@ -28,9 +33,33 @@ typedef struct CtGraphStruct
   CtMoveGenerator move_generator;
   CtMoveMaker move_maker;
   CtMoveCommand command_for_each_legal_move;
-  CtMoveCommand command_for_each_move_made;
-  CtMoveCommand replay_move_command;
   CtMoveStack move_stack;
+  int ply;
+  int undo_ply;
+  CtPosition *snapshots;        /* snapshots[index] is the position at ply index * GRAPH_SNAPSHOT_INTERVAL */
+  int snapshot_count;
+  int snapshots_size;
+  CtPosition scratch_position;        /* used to find positions without disturbing the graph */
+  CtMoveMaker scratch_move_maker;
+  CtMoveCommand cache_legal_move;
+  CtMove *legal_moves;
+  int legal_move_count;
+  int legal_moves_size;
+  int legal_moves_ply;                /* -1 when no legal moves are cached */
+  CtMoveGenerator stage_move_generator;        /* created the first time moves are generated by stage */
+  CtMoveCommand filter_stage_moves;
+  CtMoveStage stage;
+  CtBitBoard evasion_targets;        /* the squares other than the king's that can answer a check */
+  CtSquare king_square;
+  CtMove *stage_moves;
+  int stage_move_count;
 } CtGraphStruct;
 
+/* generates the legal moves of the graph's position without the cache, for moves tried outside the graph's line */
+void ct_graph_generate_legal_moves(CtGraph graph, CtMoveCommand move_command);
+
+/* these are defined in ct_move_writer.c -- the check or checkmate of a move is added once the graph has made it */
+char *ct_graph_move_to_san_without_check(CtGraph graph, CtMove move, char *destination);
+char *ct_graph_add_check_to_san(CtGraph graph, char *notation);
+
 #endif                                /* CT_GRAPH_PRIVATE_H */
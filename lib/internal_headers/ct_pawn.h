@@ -25,5 +25,8 @@ CtPawn ct_pawn_new(CtMoveCommand move_command, CtPieceColor piece_color);
 void ct_pawn_free(CtPawn pawn);
 
 void ct_pawn_move(CtPawn pawn, CtPosition position, CtSquare from);
+void ct_pawn_moves(CtPawn pawn, CtPosition position);
+void ct_white_pawn_moves(CtPawn pawn, CtPosition position);
+void ct_black_pawn_moves(CtPawn pawn, CtPosition position);
 
 #endif                                /* CT_PAWN_H */
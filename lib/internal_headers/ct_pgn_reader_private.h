@@ -15,23 +15,27 @@
  * limitations under the License.
  */
 
-#ifndef CT_PGN_READER_H
-#define CT_PGN_READER_H
+#ifndef CT_PGN_READER_PRIVATE_H
+#define CT_PGN_READER_PRIVATE_H
 
 /* this header file is for use by the parser and scanner */
 
 #include "ct_types.h"
 
-typedef struct CtPgnReaderStruct *CtPgnReader;
-
 /* used by the scanner */
-void ct_pgn_reader_set_game_termination(CtPgnReader pgn_reader, char *result);
+int ct_pgn_reader_read(CtPgnReader pgn_reader, char *destination, int max_length);
+void ct_pgn_reader_count(CtPgnReader pgn_reader, char *text, int length);
+bool ct_pgn_reader_set_game_termination(CtPgnReader pgn_reader, char *result);
 void ct_pgn_reader_set_tag_key(CtPgnReader pgn_reader, char *key);
 void ct_pgn_reader_set_tag_value(CtPgnReader pgn_reader, char *quoted_string);
-CtMove ct_pgn_reader_make_move(CtPgnReader pgn_reader, char *move_notation, int line, int column);
+bool ct_pgn_reader_make_move(CtPgnReader pgn_reader, char *move_notation, int line, int column);
+void ct_pgn_reader_read_comment(CtPgnReader pgn_reader, char *text, int length);
+bool ct_pgn_reader_start_variation(CtPgnReader pgn_reader, int line, int column);
+bool ct_pgn_reader_end_variation(CtPgnReader pgn_reader, int line, int column);
 
 /* used by the parser */
 void *ct_pgn_reader_scanner(CtPgnReader pgn_reader);
 void ct_pgn_reader_syntax_error(CtPgnReader pgn_reader, int line, int column);
+bool ct_pgn_reader_recover(CtPgnReader pgn_reader);
 
-#endif                                /* CT_PGN_READER_H */
+#endif                                /* CT_PGN_READER_PRIVATE_H */
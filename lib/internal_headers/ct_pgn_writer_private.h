@@ -0,0 +1,27 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CT_PGN_WRITER_PRIVATE_H
+#define CT_PGN_WRITER_PRIVATE_H
+
+#include "ct_types.h"
+
+/* a PGN writer whose output stays in memory, used by ct_graph_to_new_pgn */
+CtPgnWriter ct_pgn_writer_new_string(void);
+char *ct_pgn_writer_free_to_new_string(CtPgnWriter pgn_writer);
+
+#endif                                /* CT_PGN_WRITER_PRIVATE_H */
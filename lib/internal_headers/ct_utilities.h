@@ -22,4 +22,8 @@ void *ct_malloc(int size);
 void *ct_realloc(void *ptr, int size);
 void ct_free(void *ptr);
 
+/* returns the number of newlines in the length characters of text, and sets last_line_length to the number of
+   characters after the last one (or to length when there is none) */
+int ct_count_newlines(const char *text, int length, int *last_line_length);
+
 #endif                                /* CT_UTILITIES_H */
@@ -22,10 +22,14 @@
 Suite *at_algebraic_notation_make_suite(void);
 Suite *at_perft_make_suite(void);
 Suite *ut_bit_board_make_suite(void);
+Suite *ut_bit_board_batch_make_suite(void);
 Suite *ut_bit_board_to_s_make_suite(void);
 Suite *ut_command_make_suite(void);
+Suite *ut_cpu_make_suite(void);
 Suite *ut_debug_utilities_make_suite(void);
 Suite *ut_error_make_suite(void);
+Suite *ut_game_annotations_make_suite(void);
+Suite *ut_game_filter_make_suite(void);
 Suite *ut_game_tags_make_suite(void);
 Suite *ut_graph_make_suite(void);
 Suite *ut_graph_dfs_make_suite(void);
@@ -37,8 +41,14 @@ Suite *ut_move_generator_make_suite(void);
 Suite *ut_move_maker_make_suite(void);
 Suite *ut_move_reader_make_suite(void);
 Suite *ut_move_stack_make_suite(void);
+Suite *ut_move_tree_make_suite(void);
 Suite *ut_move_writer_make_suite(void);
 Suite *ut_pawn_make_suite(void);
+Suite *ut_pgn_error_log_make_suite(void);
+Suite *ut_pgn_index_make_suite(void);
+Suite *ut_pgn_input_make_suite(void);
+Suite *ut_pgn_reader_make_suite(void);
+Suite *ut_pgn_writer_make_suite(void);
 Suite *ut_graph_from_pgn_make_suite(void);
 Suite *ut_piece_make_suite(void);
 Suite *ut_piece_command_make_suite(void);
@@ -46,6 +56,7 @@ Suite *ut_position_make_suite(void);
 Suite *ut_position_from_fen_make_suite(void);
 Suite *ut_position_hash_make_suite(void);
 Suite *ut_position_rules_make_suite(void);
+Suite *ut_position_see_make_suite(void);
 Suite *ut_position_to_fen_make_suite(void);
 Suite *ut_position_to_s_make_suite(void);
 Suite *ut_rays_make_suite(void);
@@ -62,10 +73,14 @@ static MakeSuiteMethod make_suite_methods[] =
   at_algebraic_notation_make_suite,
   at_perft_make_suite,
   ut_bit_board_make_suite,
+  ut_bit_board_batch_make_suite,
   ut_bit_board_to_s_make_suite,
   ut_command_make_suite,
+  ut_cpu_make_suite,
   ut_debug_utilities_make_suite,
   ut_error_make_suite,
+  ut_game_annotations_make_suite,
+  ut_game_filter_make_suite,
   ut_game_tags_make_suite,
   ut_graph_make_suite,
   ut_graph_dfs_make_suite,
@@ -77,15 +92,22 @@ static MakeSuiteMethod make_suite_methods[] =
   ut_move_maker_make_suite,
   ut_move_reader_make_suite,
   ut_move_stack_make_suite,
+  ut_move_tree_make_suite,
   ut_move_writer_make_suite,
   ut_pawn_make_suite,
   ut_graph_from_pgn_make_suite,
+  ut_pgn_error_log_make_suite,
+  ut_pgn_index_make_suite,
+  ut_pgn_input_make_suite,
+  ut_pgn_reader_make_suite,
+  ut_pgn_writer_make_suite,
   ut_piece_make_suite,
   ut_piece_command_make_suite,
   ut_position_make_suite,
   ut_position_from_fen_make_suite,
   ut_position_hash_make_suite,
   ut_position_rules_make_suite,
+  ut_position_see_make_suite,
   ut_position_to_fen_make_suite,
   ut_position_to_s_make_suite,
   ut_rays_make_suite,
@@ -36,6 +36,7 @@ static CtBitBoard ut_bit_board_make_from_squares(CtSquare *squares);
 static void ut_is_attacking_setup(void);
 static void ut_is_attacking_teardown(void);
 static void ut_king_is_attacked_when_piece_is_on(CtPiece which_king, CtPiece piece, UtBitBoardTest tests);
+static void ut_bit_board_array_from_fen(CtBitBoardArray bit_board_array, char *fen);
 
 START_TEST(ut_BITB)
 {
@@ -78,6 +79,98 @@ START_TEST(ut_bit_board_array_reset)
   ck_assert(bit_board_array[EMPTY] == BITB_FULL);
 } END_TEST
 
+START_TEST(ut_bit_board_between_and_line)
+{
+  CtSquare b2_to_g7[] = {B2, C3, D4, E5, F6, G7, SQUARE_NOT_FOUND};
+  CtSquare long_diagonal[] = {A1, B2, C3, D4, E5, F6, G7, H8, SQUARE_NOT_FOUND};
+  CtSquare rank_4[] = {A4, B4, C4, D4, E4, F4, G4, H4, SQUARE_NOT_FOUND};
+
+  ck_assert(ct_bit_board_between(A1, H8) == ut_bit_board_make_from_squares(b2_to_g7));
+  ck_assert(ct_bit_board_between(H8, A1) == ut_bit_board_make_from_squares(b2_to_g7));
+  ck_assert(ct_bit_board_between(A1, A2) == BITB_EMPTY);
+  ck_assert(ct_bit_board_between(A1, B3) == BITB_EMPTY);
+  ck_assert(ct_bit_board_line(C3, E5) == ut_bit_board_make_from_squares(long_diagonal));
+  ck_assert(ct_bit_board_line(G4, F4) == ut_bit_board_make_from_squares(rank_4));
+  ck_assert(ct_bit_board_line(A3, A7) == 0x0101010101010101);
+  ck_assert(ct_bit_board_line(A1, B3) == BITB_EMPTY);
+  ck_assert(ct_bit_board_line(E4, E4) == BITB_EMPTY);
+} END_TEST
+
+START_TEST(ut_bit_board_array_attackers_to)
+{
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH];
+  CtSquare attackers[] = {D2, B3, E4, F4, C6, E6, SQUARE_NOT_FOUND};
+  CtSquare x_ray_attackers[] = {D1, A8, SQUARE_NOT_FOUND};
+  CtSquare without_c6[] = {D2, B3, E4, F4, E6, A8, SQUARE_NOT_FOUND};
+  CtBitBoard occupied;
+
+  ut_bit_board_array_from_fen(bit_board_array, "b7/8/2p1k3/3q4/4PN2/1B6/3R4/3RK3 w - - 0 1");
+  occupied = ~bit_board_array[EMPTY];
+  ck_assert(ct_bit_board_array_attackers_to(bit_board_array, D5, occupied)
+            == ut_bit_board_make_from_squares(attackers));
+  ck_assert(ct_bit_board_array_x_ray_attackers_to(bit_board_array, D5, occupied)
+            == ut_bit_board_make_from_squares(x_ray_attackers));
+  occupied &= ~ct_bit_board_make(C6);
+  ck_assert(ct_bit_board_array_attackers_to(bit_board_array, D5, occupied)
+            == ut_bit_board_make_from_squares(without_c6));
+  ck_assert(ct_bit_board_array_attackers_to(bit_board_array, H7, ~bit_board_array[EMPTY]) == BITB_EMPTY);
+} END_TEST
+
+START_TEST(ut_bit_board_array_attacks)
+{
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH];
+
+  ut_bit_board_array_from_fen(bit_board_array, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+  ck_assert(ct_bit_board_array_white_attacks(bit_board_array) == 0x0000000000FFFF7E);
+  ck_assert(ct_bit_board_array_black_attacks(bit_board_array) == 0x7EFFFF0000000000);
+} END_TEST
+
+/* the attack sets must agree with the yes or no answers of is_attacking on every square */
+START_TEST(ut_bit_board_array_attacks_agree_with_is_attacking)
+{
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH];
+  char *fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    0
+  };
+  char **fen;
+  CtBitBoard white_attacks, black_attacks, attackers;
+  CtSquare square;
+
+  for (fen = fens; *fen; fen++)
+  {
+    ut_bit_board_array_from_fen(bit_board_array, *fen);
+    white_attacks = ct_bit_board_array_white_attacks(bit_board_array);
+    black_attacks = ct_bit_board_array_black_attacks(bit_board_array);
+    for (square = A1; square < NUMBER_OF_SQUARES; square++)
+    {
+      attackers = ct_bit_board_array_attackers_to(bit_board_array, square, ~bit_board_array[EMPTY]);
+      ck_assert(ct_bit_board_array_is_white_attacking(bit_board_array, square)
+                == ((attackers & bit_board_array[WHITE_PIECES]) != 0));
+      ck_assert(ct_bit_board_array_is_black_attacking(bit_board_array, square)
+                == ((attackers & bit_board_array[BLACK_PIECES]) != 0));
+      ck_assert(ct_bit_board_array_is_white_attacking(bit_board_array, square)
+                == ((white_attacks & ct_bit_board_make(square)) != 0));
+      ck_assert(ct_bit_board_array_is_black_attacking(bit_board_array, square)
+                == ((black_attacks & ct_bit_board_make(square)) != 0));
+    }
+  }
+} END_TEST
+
+START_TEST(ut_bit_board_array_pinned)
+{
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH];
+  CtSquare pinned[] = {D2, E4, SQUARE_NOT_FOUND};
+
+  /* the pawn on f2 is not pinned, because the bishop on g3 also stands between the king and the queen */
+  ut_bit_board_array_from_fen(bit_board_array, "4r1k1/8/8/b7/4R2q/6B1/3N1P2/4K3 w - - 0 1");
+  ck_assert(ct_bit_board_array_pinned(bit_board_array, E1, WHITE_PIECE) == ut_bit_board_make_from_squares(pinned));
+  ck_assert(ct_bit_board_array_pinned(bit_board_array, G8, BLACK_PIECE) == BITB_EMPTY);
+} END_TEST
+
 START_TEST(ut_bit_board_white_pawn_attacks)
 {
   UtBitBoardTestStruct tests[] = {
@@ -300,6 +393,18 @@ ut_is_attacking_teardown(void)
 {
 }
 
+static void
+ut_bit_board_array_from_fen(CtBitBoardArray bit_board_array, char *fen)
+{
+  CtPosition position = ct_position_new();
+  CtPiece piece;
+
+  ck_assert(ct_position_from_fen(position, fen) != 0);
+  for (piece = 0; piece < CT_BIT_BOARD_ARRAY_LENGTH; piece++)
+    bit_board_array[piece] = ct_position_get_bit_board(position, piece);
+  ct_position_free(position);
+}
+
 /* placing the specified piece on each of the empty squares, to test if the king is under attack */
 static void
 ut_king_is_attacked_when_piece_is_on(CtPiece which_king, CtPiece piece, UtBitBoardTest tests)
@@ -369,10 +474,15 @@ ut_bit_board_make_suite(void)
   test_case = tcase_create("BitBoard");
   tcase_add_test(test_case, ut_BITB);
   tcase_add_test(test_case, ut_bit_board_find_first_square);
+  tcase_add_test(test_case, ut_bit_board_between_and_line);
   suite_add_tcase(test_suite, test_case);
 
   test_case = tcase_create("BitBoardArray");
   tcase_add_test(test_case, ut_bit_board_array_reset);
+  tcase_add_test(test_case, ut_bit_board_array_attackers_to);
+  tcase_add_test(test_case, ut_bit_board_array_attacks);
+  tcase_add_test(test_case, ut_bit_board_array_attacks_agree_with_is_attacking);
+  tcase_add_test(test_case, ut_bit_board_array_pinned);
   suite_add_tcase(test_suite, test_case);
 
   test_case = tcase_create("BitBoardArray.is_attacking");
@@ -0,0 +1,172 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+
+enum
+{
+  UT_BATCH_MAX_POSITIONS = 1024
+};
+
+static CtBitBoardBatch batch;
+static CtGraph graph;
+static CtPosition positions[UT_BATCH_MAX_POSITIONS];
+static int position_count;
+
+static void setup(void);
+static void teardown(void);
+static void ut_bit_board_batch_add(void);
+static void ut_bit_board_batch_to_array(CtPosition position, CtBitBoard *bit_board_array);
+
+/* the positions and every position one move later, which is not a multiple of any vector's length */
+static void
+setup(void)
+{
+  char *fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    0
+  };
+  CtMove moves[CT_GRAPH_MAX_MOVES];
+  int count, index;
+  char **fen;
+
+  batch = ct_bit_board_batch_new();
+  graph = ct_graph_new();
+  position_count = 0;
+  for (fen = fens; *fen; fen++)
+  {
+    ck_assert_msg(ct_graph_from_fen(graph, *fen) != 0, *fen);
+    ut_bit_board_batch_add();
+    count = ct_graph_legal_move_count(graph);
+    for (index = 0; index < count; index++)
+      moves[index] = ct_graph_legal_moves(graph)[index];
+    for (index = 0; index < count; index++)
+    {
+      ct_graph_make_move(graph, moves[index]);
+      ut_bit_board_batch_add();
+      ct_graph_unmake_move(graph);
+    }
+  }
+}
+
+static void
+teardown(void)
+{
+  int index;
+
+  for (index = 0; index < position_count; index++)
+    ct_position_free(positions[index]);
+  ct_graph_free(graph);
+  ct_bit_board_batch_free(batch);
+}
+
+static void
+ut_bit_board_batch_add(void)
+{
+  ck_assert(position_count < UT_BATCH_MAX_POSITIONS);
+  positions[position_count] = ct_graph_to_position(graph, ct_position_new());
+  ck_assert_int_eq(ct_bit_board_batch_add(batch, positions[position_count]), position_count);
+  position_count++;
+}
+
+static void
+ut_bit_board_batch_to_array(CtPosition position, CtBitBoard *bit_board_array)
+{
+  int piece;
+
+  for (piece = 0; piece < CT_BIT_BOARD_ARRAY_LENGTH; piece++)
+    bit_board_array[piece] = ct_position_get_bit_board(position, piece);
+}
+
+START_TEST(ut_bit_board_batch_columns)
+{
+  ck_assert_int_eq(ct_bit_board_batch_count(batch), position_count);
+  ck_assert_int_eq(ct_bit_board_batch_result_words(batch), (position_count + 63) / 64);
+  ck_assert(position_count % 8 != 0);
+  ck_assert(ct_bit_board_batch_column(batch, WHITE_ROOK)[0] == ct_position_get_bit_board(positions[0], WHITE_ROOK));
+  ct_bit_board_batch_reset(batch);
+  ck_assert_int_eq(ct_bit_board_batch_count(batch), 0);
+} END_TEST
+
+START_TEST(ut_bit_board_batch_attacks_and_mobility)
+{
+  CtBitBoard white_attacks[UT_BATCH_MAX_POSITIONS], black_attacks[UT_BATCH_MAX_POSITIONS];
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH];
+  int mobility[UT_BATCH_MAX_POSITIONS];
+  int index;
+
+  ct_bit_board_batch_attacks(batch, WHITE_PIECE, white_attacks);
+  ct_bit_board_batch_attacks(batch, BLACK_PIECE, black_attacks);
+  ct_bit_board_batch_mobility(batch, BLACK_PIECE, mobility);
+  for (index = 0; index < position_count; index++)
+  {
+    ut_bit_board_batch_to_array(positions[index], bit_board_array);
+    ck_assert_msg(white_attacks[index] == ct_bit_board_array_white_attacks(bit_board_array), "position %d", index);
+    ck_assert_msg(black_attacks[index] == ct_bit_board_array_black_attacks(bit_board_array), "position %d", index);
+    ck_assert_int_eq(mobility[index],
+                     ct_bit_board_count_squares(black_attacks[index] & ~bit_board_array[BLACK_PIECES]));
+  }
+} END_TEST
+
+START_TEST(ut_bit_board_batch_is_attacked_and_is_check)
+{
+  uint64_t is_check[UT_BATCH_MAX_POSITIONS / 64], is_attacked[UT_BATCH_MAX_POSITIONS / 64];
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH];
+  CtSquare squares[] = { A1, E4, F7, H8 };
+  int index, square;
+  bool is_set;
+
+  ct_bit_board_batch_is_check(batch, is_check);
+  for (index = 0; index < position_count; index++)
+  {
+    is_set = (is_check[index / 64] >> (index % 64)) & 1;
+    ck_assert_msg(is_set == ct_position_is_check(positions[index]), "position %d", index);
+  }
+  for (square = 0; square < (int) (sizeof(squares) / sizeof(squares[0])); square++)
+  {
+    ct_bit_board_batch_is_attacked(batch, WHITE_PIECE, squares[square], is_attacked);
+    for (index = 0; index < position_count; index++)
+    {
+      ut_bit_board_batch_to_array(positions[index], bit_board_array);
+      is_set = (is_attacked[index / 64] >> (index % 64)) & 1;
+      ck_assert_msg(is_set == ct_bit_board_array_is_white_attacking(bit_board_array, squares[square]), "position %d",
+                    index);
+    }
+  }
+} END_TEST
+
+Suite *
+ut_bit_board_batch_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_bit_board_batch");
+  test_case = tcase_create("BitBoardBatch");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_bit_board_batch_columns);
+  tcase_add_test(test_case, ut_bit_board_batch_attacks_and_mobility);
+  tcase_add_test(test_case, ut_bit_board_batch_is_attacked_and_is_check);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
@@ -34,6 +34,11 @@ START_TEST(ut_command_execute)
   ct_command_execute(&command_struct);
   ck_assert_int_eq(counter, 3);
 
+  /* a command without a method does nothing */
+  command_struct = ct_command_make(&counter, 0);
+  ct_command_execute(&command_struct);
+  ck_assert_int_eq(counter, 3);
+
   ct_command_free(command);
 } END_TEST
 
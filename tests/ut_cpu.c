@@ -0,0 +1,146 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include <string.h>
+#include "chess_toolkit.h"
+#include "ct_utilities.h"
+
+static void teardown(void);
+static void ut_cpu_verify_kernels(CtCpuLevel level);
+
+static char *fens[] = {
+  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+  "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+  "Q7/8/8/3q4/8/8/8/7b b - -",
+  0
+};
+
+static void
+teardown(void)
+{
+  ct_cpu_force_level(ct_cpu_detected_level());
+}
+
+/* each kernel of level is checked against answers worked out without any kernel */
+static void
+ut_cpu_verify_kernels(CtCpuLevel level)
+{
+  CtBitBoard bit_boards[] = { BITB_EMPTY, BITB_ONE, BITB_FULL, BITB_FILE_H, BITB_RANK_1 << 56, 0x0123456789ABCDEF };
+  CtPosition position = ct_position_new();
+  CtBitBoardBatch batch = ct_bit_board_batch_new();
+  CtBitBoard bit_board_array[CT_BIT_BOARD_ARRAY_LENGTH], attacks[8];
+  char text[200];
+  int index, square, count, length, newlines, last_line_length, expected_newlines, expected_last_line_length;
+  char **fen;
+
+  ck_assert(ct_cpu_force_level(level));
+  ck_assert_int_eq(ct_cpu_level(), level);
+  for (index = 0; index < (int) (sizeof(bit_boards) / sizeof(bit_boards[0])); index++)
+  {
+    count = 0;
+    square = SQUARE_NOT_FOUND;
+    for (length = 63; length >= 0; length--)
+      if ((bit_boards[index] >> length) & 1)
+      {
+        count++;
+        square = length;
+      }
+    ck_assert_int_eq(ct_bit_board_find_first_square(bit_boards[index]), square);
+    ck_assert_int_eq(ct_bit_board_count_squares(bit_boards[index]), count);
+  }
+  for (fen = fens; *fen; fen++)
+  {
+    ck_assert(ct_position_from_fen(position, *fen) != 0);
+    ct_bit_board_batch_add(batch, position);
+    for (square = 0; square < CT_BIT_BOARD_ARRAY_LENGTH; square++)
+      bit_board_array[square] = ct_position_get_bit_board(position, square);
+    for (square = A1; square <= H8; square++)
+    {
+      ck_assert(((ct_bit_board_array_white_attacks(bit_board_array) >> square) & 1)
+                == ct_bit_board_array_is_white_attacking(bit_board_array, square));
+      ck_assert(((ct_bit_board_array_black_attacks(bit_board_array) >> square) & 1)
+                == ct_bit_board_array_is_black_attacking(bit_board_array, square));
+    }
+  }
+  ct_bit_board_batch_attacks(batch, BLACK_PIECE, attacks);
+  for (fen = fens, index = 0; *fen; fen++, index++)
+  {
+    ct_position_from_fen(position, *fen);
+    for (square = 0; square < CT_BIT_BOARD_ARRAY_LENGTH; square++)
+      bit_board_array[square] = ct_position_get_bit_board(position, square);
+    ck_assert(attacks[index] == ct_bit_board_array_black_attacks(bit_board_array));
+  }
+  for (index = 0; index < (int) sizeof(text); index++)
+    text[index] = index % 23 == 5 || index % 37 == 36 ? '\n' : 'a' + index % 26;
+  for (length = 0; length <= (int) sizeof(text); length++)
+  {
+    expected_newlines = 0;
+    expected_last_line_length = length;
+    for (index = 0; index < length; index++)
+      if (text[index] == '\n')
+      {
+        expected_newlines++;
+        expected_last_line_length = length - index - 1;
+      }
+    newlines = ct_count_newlines(text, length, &last_line_length);
+    ck_assert_int_eq(newlines, expected_newlines);
+    ck_assert_int_eq(last_line_length, expected_last_line_length);
+  }
+  ct_bit_board_batch_free(batch);
+  ct_position_free(position);
+}
+
+START_TEST(ut_cpu_levels)
+{
+  CtCpuLevel detected = ct_cpu_detected_level();
+
+  ck_assert(detected >= CPU_GENERIC && detected <= CPU_AVX512);
+  ck_assert_str_eq(ct_cpu_level_name(CPU_GENERIC), "generic");
+  ck_assert_str_eq(ct_cpu_level_name(CPU_AVX512), "avx512");
+  ck_assert(ct_cpu_force_level(CPU_GENERIC));
+  ck_assert_int_eq(ct_cpu_level(), CPU_GENERIC);
+  if (detected < CPU_AVX512)
+    ck_assert(!ct_cpu_force_level(detected + 1));
+  ck_assert(ct_cpu_force_level(detected));
+  ck_assert_int_eq(ct_cpu_level(), detected);
+} END_TEST
+
+START_TEST(ut_cpu_kernels_agree)
+{
+  CtCpuLevel level;
+
+  for (level = CPU_GENERIC; level <= ct_cpu_detected_level(); level++)
+    ut_cpu_verify_kernels(level);
+} END_TEST
+
+Suite *
+ut_cpu_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_cpu");
+  test_case = tcase_create("Cpu");
+  tcase_add_checked_fixture(test_case, 0, teardown);
+  tcase_add_test(test_case, ut_cpu_levels);
+  tcase_add_test(test_case, ut_cpu_kernels_agree);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
@@ -23,6 +23,7 @@
 static const char *capture_error_message = "";
 
 static void ut_error_simple_error_handler(const char *msg);
+static void ut_error_channel_method(void *delegate, const char *msg);
 
 START_TEST(ut_error)
 {
@@ -46,6 +47,53 @@ START_TEST(ut_error_set_custom_handler)
   ck_assert_str_eq(capture_error_message, "ut_error_set_custom_handler");
 } END_TEST
 
+static void
+ut_error_channel_method(void *delegate, const char *msg)
+{
+  int *calls = (int *) delegate;
+
+  *calls += 1;
+}
+
+START_TEST(ut_error_channel)
+{
+  CtErrorChannel recording_channel = ct_error_channel_new(0, 0);
+  CtErrorChannel calling_channel;
+  int calls = 0;
+
+  calling_channel = ct_error_channel_new(&calls, ut_error_channel_method);
+  ct_error_set_custom_handler(ut_error_simple_error_handler);
+  ck_assert(ct_error_use_channel(recording_channel) == 0);
+  ct_error("first");
+  ct_error("second");
+  ck_assert_int_eq(ct_error_channel_count(recording_channel), 2);
+  ck_assert_str_eq(ct_error_channel_last_error(recording_channel), "second");
+  ck_assert_str_eq(capture_error_message, "second");
+
+  ck_assert(ct_error_use_channel(calling_channel) == recording_channel);
+  ct_error("third");
+  ck_assert_int_eq(calls, 1);
+  ck_assert_str_eq(capture_error_message, "second");
+  ck_assert_int_eq(ct_error_channel_count(calling_channel), 1);
+  ck_assert_int_eq(ct_error_channel_count(recording_channel), 2);
+
+  ck_assert(ct_error_use_channel(0) == calling_channel);
+  ct_error_channel_free(calling_channel);
+  ct_error_channel_free(recording_channel);
+  ct_error_set_custom_handler(0);
+} END_TEST
+
+START_TEST(ut_error_channel_without_method)
+{
+  CtErrorChannel recording_channel = ct_error_channel_new(0, 0);
+
+  check_redirect_stdout();
+  ct_error_use_channel(recording_channel);
+  ct_error("ut_error_channel_without_method");
+  /* without a method or a custom handler, ct_error will exit here */
+  ck_abort_msg("ct_error failed to exit");
+} END_TEST
+
 Suite *
 ut_error_make_suite(void)
 {
@@ -54,9 +102,13 @@ ut_error_make_suite(void)
 
   test_suite = suite_create("ut_error");
   test_case = tcase_create("Error");
-  if (!check_fork_no())                /* if ut_error ran with CK_FORK=no, the test framework would fail */
+  if (!check_fork_no())                /* if these ran with CK_FORK=no, the test framework would fail */
+  {
     tcase_add_exit_test(test_case, ut_error, -1);
+    tcase_add_exit_test(test_case, ut_error_channel_without_method, -1);
+  }
   tcase_add_test(test_case, ut_error_set_custom_handler);
+  tcase_add_test(test_case, ut_error_channel);
   suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
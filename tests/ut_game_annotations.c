@@ -0,0 +1,159 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <string.h>
+
+static CtGameAnnotations game_annotations;
+
+static void setup(void);
+static void teardown(void);
+static void ut_game_annotations_read(char *comment, int ply);
+
+static void
+setup(void)
+{
+  game_annotations = ct_game_annotations_new();
+}
+
+static void
+teardown(void)
+{
+  ct_game_annotations_free(game_annotations);
+}
+
+static void
+ut_game_annotations_read(char *comment, int ply)
+{
+  ct_game_annotations_read_comment(game_annotations, ply, comment, strlen(comment));
+}
+
+START_TEST(ut_game_annotations_clock)
+{
+  int *clocks;
+
+  ut_game_annotations_read("{ [%clk 0:03:00] }", 1);
+  ut_game_annotations_read("{[%clk 1:05:09.5]}", 2);
+  ut_game_annotations_read("{ [%clk 59.27] }", 4);
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 5);
+  clocks = ct_game_annotations_clocks(game_annotations);
+  ck_assert_int_eq(clocks[0], GAME_ANNOTATIONS_MISSING);
+  ck_assert_int_eq(clocks[1], 18000);
+  ck_assert_int_eq(clocks[2], 390950);
+  ck_assert_int_eq(clocks[3], GAME_ANNOTATIONS_MISSING);
+  ck_assert_int_eq(clocks[4], 5927);
+  ck_assert_int_eq(ct_game_annotations_evals(game_annotations)[4], GAME_ANNOTATIONS_MISSING);
+} END_TEST
+
+START_TEST(ut_game_annotations_eval)
+{
+  int *evals;
+
+  ut_game_annotations_read("{ [%eval 0.35] [%clk 0:01:23] }", 1);
+  ut_game_annotations_read("{ [%eval -1.2] }", 2);
+  ut_game_annotations_read("{ [%eval 0.17,22] }", 3);
+  ut_game_annotations_read("{ [%eval #3] }", 4);
+  ut_game_annotations_read("{ [%eval #-2] }", 5);
+  ut_game_annotations_read("{ [%eval 0.125] }", 6);
+  evals = ct_game_annotations_evals(game_annotations);
+  ck_assert_int_eq(evals[1], 35);
+  ck_assert_int_eq(ct_game_annotations_clocks(game_annotations)[1], 8300);
+  ck_assert_int_eq(evals[2], -120);
+  ck_assert_int_eq(evals[3], 17);
+  ck_assert_int_eq(evals[4], GAME_ANNOTATIONS_MATE - 3);
+  ck_assert_int_eq(evals[5], 2 - GAME_ANNOTATIONS_MATE);
+  ck_assert_int_eq(evals[6], 13);
+} END_TEST
+
+START_TEST(ut_game_annotations_ignored)
+{
+  /* ordinary comments, other commands and malformed commands leave no annotations */
+  ut_game_annotations_read("{ a fine move [%csl Gd4] }", 1);
+  ut_game_annotations_read("{ [%clk] [%clk 1:xx] [%eval] [%eval abc] [%clk 0:01:00 }", 2);
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 0);
+
+  /* only the first length characters of the comment are read */
+  ct_game_annotations_read_comment(game_annotations, 1, "{ [%clk 0:00:10] }", 6);
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 0);
+
+  ut_game_annotations_read("{ [%clk 0:00:10] }", 1);
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 2);
+  ct_game_annotations_reset(game_annotations);
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 0);
+} END_TEST
+
+START_TEST(ut_game_annotations_from_pgn_input)
+{
+  FILE *file = tmpfile();
+  CtPgnInput pgn_input;
+  CtGraph graph = ct_graph_new();
+  CtGameTags game_tags = ct_game_tags_new();
+  CtPgnReader pgn_reader;
+  int *clocks;
+  int *evals;
+
+  fputs("[Event \"A\"]\n"
+        "1. e4 { [%eval 0.3] [%clk 0:03:00] } e5 { [%eval 0.25] [%clk 0:02:59] }\n"
+        "2. Nf3 { [%clk 0:02:58] } 1-0\n"
+        "[Event \"B\"]\n"
+        "{ [%clk 0:05:00] } 1. d4 *\n", file);
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ct_pgn_input_use_game_annotations(pgn_input, game_annotations);
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, pgn_input);
+
+  ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 4);
+  clocks = ct_game_annotations_clocks(game_annotations);
+  evals = ct_game_annotations_evals(game_annotations);
+  ck_assert_int_eq(clocks[1], 18000);
+  ck_assert_int_eq(clocks[2], 17900);
+  ck_assert_int_eq(clocks[3], 17800);
+  ck_assert_int_eq(evals[1], 30);
+  ck_assert_int_eq(evals[2], 25);
+  ck_assert_int_eq(evals[3], GAME_ANNOTATIONS_MISSING);
+
+  /* each game starts without annotations */
+  ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_int_eq(ct_game_annotations_ply_count(game_annotations), 1);
+  ck_assert_int_eq(ct_game_annotations_clocks(game_annotations)[0], 30000);
+
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(pgn_input);
+  ct_game_tags_free(game_tags);
+  ct_graph_free(graph);
+  fclose(file);
+} END_TEST
+
+Suite *
+ut_game_annotations_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_game_annotations");
+  test_case = tcase_create("GameAnnotations");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_game_annotations_clock);
+  tcase_add_test(test_case, ut_game_annotations_eval);
+  tcase_add_test(test_case, ut_game_annotations_ignored);
+  tcase_add_test(test_case, ut_game_annotations_from_pgn_input);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
@@ -0,0 +1,171 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <string.h>
+
+static CtGameFilter game_filter;
+static CtGameTags game_tags;
+
+static void setup(void);
+static void teardown(void);
+static bool ut_game_filter_is_round_10(void *delegate, CtGameTags game_tags);
+
+static void
+setup(void)
+{
+  game_filter = ct_game_filter_new();
+  game_tags = ct_game_tags_new();
+  ct_game_tags_set(game_tags, "Date", "2013.03.27");
+  ct_game_tags_set(game_tags, "Round", "10");
+  ct_game_tags_set(game_tags, "White", "Carlsen, Magnus");
+  ct_game_tags_set(game_tags, "Black", "Gelfand, Boris");
+  ct_game_tags_set(game_tags, "WhiteElo", "2872");
+  ct_game_tags_set(game_tags, "BlackElo", "2740");
+  ct_game_tags_set(game_tags, "ECO", "B30");
+}
+
+static void
+teardown(void)
+{
+  ct_game_tags_free(game_tags);
+  ct_game_filter_free(game_filter);
+}
+
+static bool
+ut_game_filter_is_round_10(void *delegate, CtGameTags game_tags)
+{
+  int *times_asked = (int *) delegate;
+
+  *times_asked += 1;
+  return strcmp(ct_game_tags_get(game_tags, "Round"), "10") == 0;
+}
+
+START_TEST(ut_game_filter_accepts_everything)
+{
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_tags_reset(game_tags);
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ck_assert(ct_game_filter_accepts(0, game_tags));
+} END_TEST
+
+START_TEST(ut_game_filter_elo_range)
+{
+  ct_game_filter_set_elo_range(game_filter, 2700, 0);
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_elo_range(game_filter, 2750, 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_elo_range(game_filter, 0, 2800);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_elo_range(game_filter, 2740, 2872);
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_tags_set(game_tags, "BlackElo", 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+} END_TEST
+
+START_TEST(ut_game_filter_date_range)
+{
+  ct_game_filter_set_date_range(game_filter, "2013.03.27", "2013.03.27");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_date_range(game_filter, "2013.03.28", 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_date_range(game_filter, 0, "2013.03.26");
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_date_range(game_filter, "2013", "2013");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_tags_set(game_tags, "Date", "2013.??.??");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_date_range(game_filter, "2013.01.01", 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_tags_set(game_tags, "Date", 0);
+  ct_game_filter_set_date_range(game_filter, "1900", 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+} END_TEST
+
+START_TEST(ut_game_filter_player)
+{
+  ct_game_filter_set_player(game_filter, "Carlsen, Magnus");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_player(game_filter, "Gelfand, Boris");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_player(game_filter, "Carlsen");
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+} END_TEST
+
+START_TEST(ut_game_filter_eco_range)
+{
+  ct_game_filter_set_eco_range(game_filter, "B00", "B99");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_eco_range(game_filter, "B30", "B30");
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_eco_range(game_filter, "C00", 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_eco_range(game_filter, 0, "A99");
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_set_eco_range(game_filter, "A00", "E99");
+  ct_game_tags_set(game_tags, "ECO", 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+} END_TEST
+
+START_TEST(ut_game_filter_predicate)
+{
+  int times_asked = 0;
+
+  ct_game_filter_set_predicate(game_filter, &times_asked, ut_game_filter_is_round_10);
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_tags_set(game_tags, "Round", "11");
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ck_assert_int_eq(times_asked, 2);
+  ct_game_filter_set_player(game_filter, "Nobody");
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ck_assert_int_eq(times_asked, 2);        /* the predicate is not asked once another criterion fails */
+  ct_game_filter_set_player(game_filter, 0);
+  ct_game_filter_set_predicate(game_filter, &times_asked, 0);
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+  ck_assert_int_eq(times_asked, 2);
+} END_TEST
+
+START_TEST(ut_game_filter_reset)
+{
+  ct_game_filter_set_player(game_filter, "Nobody");
+  ct_game_filter_set_elo_range(game_filter, 3000, 0);
+  ck_assert(!ct_game_filter_accepts(game_filter, game_tags));
+  ct_game_filter_reset(game_filter);
+  ck_assert(ct_game_filter_accepts(game_filter, game_tags));
+} END_TEST
+
+Suite *
+ut_game_filter_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_game_filter");
+  test_case = tcase_create("GameFilter");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_game_filter_accepts_everything);
+  tcase_add_test(test_case, ut_game_filter_elo_range);
+  tcase_add_test(test_case, ut_game_filter_date_range);
+  tcase_add_test(test_case, ut_game_filter_player);
+  tcase_add_test(test_case, ut_game_filter_eco_range);
+  tcase_add_test(test_case, ut_game_filter_predicate);
+  tcase_add_test(test_case, ut_game_filter_reset);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
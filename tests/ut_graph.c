@@ -19,6 +19,13 @@
 #include <check.h>
 #include "chess_toolkit.h"
 #include <stdio.h>
+#include <string.h>
+
+enum
+{
+  LONG_GAME_MAX_PLY = 200,
+  CT_GRAPH_TEST_MAX_MOVES = 256
+};
 
 static CtGraph graph;
 static CtMoveStack actual_move_stack;
@@ -28,6 +35,12 @@ static void setup(void);
 static void teardown(void);
 static void ut_graph_test_fen(char *fen);
 static void ut_graph_verify_move_made(void *delegate, CtMove move);
+static void ut_graph_save_fen(void *delegate, CtMove move);
+static int ut_graph_read_long_game(void);
+static void ut_graph_verify_is_legal_move(void);
+static void ut_graph_verify_moves_by_stage(void);
+
+static char long_game_fens[LONG_GAME_MAX_PLY + 1][CT_FEN_MAX_LENGTH];
 
 static void
 setup(void)
@@ -158,6 +171,362 @@ START_TEST(ut_graph_reset)
   ck_assert_str_eq(ct_graph_to_fen(graph, 0), "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -");
 } END_TEST
 
+static void
+ut_graph_save_fen(void *delegate, CtMove move)
+{
+  ct_graph_to_fen(graph, long_game_fens[ct_graph_ply(graph)]);
+}
+
+/* reads the longest game of the first few in the file, and saves the FEN at each of its plies */
+static int
+ut_graph_read_long_game(void)
+{
+  FILE *file = fopen("candidates2013.pgn", "r");
+  CtPgnInput pgn_input = ct_pgn_input_new(file);
+  CtPgnReader pgn_reader = ct_pgn_reader_open(graph, 0, pgn_input);
+  CtMoveCommand save_fen = ct_move_command_new(0, ut_graph_save_fen);
+  int ply;
+
+  do
+    ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  while (ct_graph_ply(graph) < 3 * GRAPH_SNAPSHOT_INTERVAL + 5);
+  ply = ct_graph_ply(graph);
+  ck_assert(ply <= LONG_GAME_MAX_PLY);
+  ct_graph_for_each_move_made(graph, save_fen);
+  ct_graph_to_fen(graph, long_game_fens[ply]);
+  ct_move_command_free(save_fen);
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(pgn_input);
+  fclose(file);
+  return ply;
+}
+
+START_TEST(ut_graph_goto_ply)
+{
+  int length = ut_graph_read_long_game();
+  int plies[] = {0, 1, length, 37, 5, length - 1, GRAPH_SNAPSHOT_INTERVAL, 36, 20, 21, length, 0};
+  char fen[CT_FEN_MAX_LENGTH];
+  int index;
+  int ply;
+
+  ck_assert_int_eq(ct_graph_line_length(graph), length);
+  for (index = 0; index < sizeof(plies) / sizeof(int); index++)
+  {
+    ck_assert(ct_graph_goto_ply(graph, plies[index]));
+    ck_assert_int_eq(ct_graph_ply(graph), plies[index]);
+    ck_assert_str_eq(ct_graph_to_fen(graph, fen), long_game_fens[plies[index]]);
+    ck_assert_int_eq(ct_graph_line_length(graph), length);
+  }
+  ck_assert(!ct_graph_goto_ply(graph, length + 1));
+  ck_assert(!ct_graph_goto_ply(graph, -1));
+  ck_assert_int_eq(ct_graph_ply(graph), 0);
+
+  /* unmaking works from a ply that was reached from a snapshot, and ends the line there */
+  ct_graph_goto_ply(graph, 40);
+  for (ply = 40; ply > 0; ply--)
+  {
+    ck_assert(ct_graph_unmake_move(graph) != NULL_MOVE);
+    ck_assert_int_eq(ct_graph_ply(graph), ply - 1);
+    ck_assert_int_eq(ct_graph_line_length(graph), ply - 1);
+    ck_assert_str_eq(ct_graph_to_fen(graph, fen), long_game_fens[ply - 1]);
+  }
+} END_TEST
+
+START_TEST(ut_graph_goto_ply_and_make_move)
+{
+  int length = ut_graph_read_long_game();
+  CtMove move;
+  char fen[CT_FEN_MAX_LENGTH];
+
+  /* making the same move again keeps the line going, but making another move replaces the rest of it */
+  ct_graph_goto_ply(graph, GRAPH_SNAPSHOT_INTERVAL + 3);
+  move = ct_graph_unmake_move(graph);
+  ct_graph_make_move(graph, move);
+  ck_assert_int_eq(ct_graph_line_length(graph), GRAPH_SNAPSHOT_INTERVAL + 3);
+  ct_graph_goto_ply(graph, GRAPH_SNAPSHOT_INTERVAL);
+  ct_move_stack_reset(actual_move_stack);
+  ct_graph_for_each_legal_move(graph, ct_move_stack_push_command(actual_move_stack));
+  ct_graph_make_move(graph, ct_move_stack_pop(actual_move_stack));
+  ck_assert_int_eq(ct_graph_ply(graph), GRAPH_SNAPSHOT_INTERVAL + 1);
+  ck_assert_int_eq(ct_graph_line_length(graph), GRAPH_SNAPSHOT_INTERVAL + 1);
+  ck_assert(!ct_graph_goto_ply(graph, length));
+  ck_assert(ct_graph_goto_ply(graph, 3));
+  ck_assert_str_eq(ct_graph_to_fen(graph, fen), long_game_fens[3]);
+  ck_assert(ct_graph_goto_ply(graph, GRAPH_SNAPSHOT_INTERVAL));
+  ck_assert_str_eq(ct_graph_to_fen(graph, fen), long_game_fens[GRAPH_SNAPSHOT_INTERVAL]);
+} END_TEST
+
+START_TEST(ut_graph_make_move_replaces_snapshots)
+{
+  char new_line_fens[GRAPH_SNAPSHOT_INTERVAL + 1][CT_FEN_MAX_LENGTH];
+  CtPosition position = ct_position_new();
+  char fen[CT_FEN_MAX_LENGTH];
+  CtMove old_move, move;
+  int ply;
+
+  /* a new line from ply 5 ends on the ply of one of the old line's snapshots, which must not be used for it */
+  ck_assert(ut_graph_read_long_game() > GRAPH_SNAPSHOT_INTERVAL + 1);
+  ct_graph_goto_ply(graph, 6);
+  old_move = ct_graph_unmake_move(graph);
+  for (ply = 5; ply < GRAPH_SNAPSHOT_INTERVAL; ply++)
+  {
+    ct_graph_to_fen(graph, new_line_fens[ply]);
+    ct_move_stack_reset(actual_move_stack);
+    ct_graph_for_each_legal_move(graph, ct_move_stack_push_command(actual_move_stack));
+    move = ct_move_stack_pop(actual_move_stack);
+    if (ply == 5 && move == old_move)
+      move = ct_move_stack_pop(actual_move_stack);
+    ct_graph_make_move(graph, move);
+  }
+  ct_graph_to_fen(graph, new_line_fens[ply]);
+  ck_assert_int_eq(ct_graph_line_length(graph), GRAPH_SNAPSHOT_INTERVAL);
+  ct_graph_goto_ply(graph, 0);
+  for (ply = 5; ply <= GRAPH_SNAPSHOT_INTERVAL; ply++)
+  {
+    ck_assert_str_eq(ct_position_to_fen(ct_graph_position_at(graph, ply, position), fen), new_line_fens[ply]);
+    ck_assert(ct_graph_goto_ply(graph, ply));
+    ck_assert_str_eq(ct_graph_to_fen(graph, fen), new_line_fens[ply]);
+  }
+  ct_position_free(position);
+} END_TEST
+
+START_TEST(ut_graph_position_at)
+{
+  int length = ut_graph_read_long_game();
+  CtPosition position = ct_position_new();
+  char fen[CT_FEN_MAX_LENGTH];
+  int ply;
+
+  ct_graph_goto_ply(graph, 25);
+  for (ply = 0; ply <= length; ply++)
+  {
+    ck_assert(ct_graph_position_at(graph, ply, position) == position);
+    ck_assert_str_eq(ct_position_to_fen(position, fen), long_game_fens[ply]);
+  }
+  ck_assert_str_eq(ct_position_to_fen(ct_graph_position_at(graph, 7, 0), fen), long_game_fens[7]);
+  ck_assert(ct_graph_position_at(graph, length + 1, position) == 0);
+
+  /* the graph is left alone */
+  ck_assert_int_eq(ct_graph_ply(graph), 25);
+  ck_assert_int_eq(ct_graph_line_length(graph), length);
+  ck_assert_str_eq(ct_graph_to_fen(graph, fen), long_game_fens[25]);
+  ct_position_free(position);
+} END_TEST
+
+START_TEST(ut_graph_legal_moves)
+{
+  CtMove *legal_moves;
+  int index;
+
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 20);
+  legal_moves = ct_graph_legal_moves(graph);
+  ct_graph_for_each_legal_move(graph, ct_move_stack_push_command(actual_move_stack));
+  ck_assert_int_eq(ct_move_stack_length(actual_move_stack), 20);
+  for (index = 0; index < 20; index++)
+    ck_assert_int_eq(ct_move_stack_get(actual_move_stack, index), legal_moves[index]);
+
+  /* fool's mate -- the moves change with every move made or unmade */
+  ct_graph_make_move(graph, ct_move_make(F2, F3));
+  ct_graph_make_move(graph, ct_move_make(E7, E5));
+  ct_graph_make_move(graph, ct_move_make(G2, G4));
+  ct_graph_make_move(graph, ct_move_make(D8, H4));
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 0);
+  ct_graph_unmake_move(graph);
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 30);
+  ck_assert_int_eq(ct_graph_move_from_san(graph, "Qh4"), ct_move_make(D8, H4));
+  ct_graph_make_move(graph, ct_move_make(D8, H4));
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 0);
+  ck_assert(ct_graph_goto_ply(graph, 3));
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 30);
+  ck_assert(ct_graph_goto_ply(graph, 4));
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 0);
+
+  /* black rook -- must capture to get out of check */
+  ct_graph_from_fen(graph, "k1Q4r/p7/P7/8/8/8/8/8 b - -");
+  ck_assert_int_eq(ct_graph_legal_move_count(graph), 1);
+  ck_assert_int_eq(ct_graph_legal_moves(graph)[0], ct_move_make(H8, C8));
+} END_TEST
+
+START_TEST(ut_graph_is_legal_move)
+{
+  char *fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+    "rnbqkb1r/pp1p1ppp/2p5/4P3/2B5/8/PPP1NnPP/RNBQK2R w KQkq -",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -",
+    0
+  };
+  char *moves[] = {"e4", "d5", "e5", "f5", 0};
+  CtMove legal_moves[CT_GRAPH_TEST_MAX_MOVES];
+  int index, count, fen_index;
+
+  /* every move from these positions and the positions after them -- the last ones can capture en passant */
+  for (fen_index = 0; fens[fen_index]; fen_index++)
+  {
+    ct_graph_from_fen(graph, fens[fen_index]);
+    ut_graph_verify_is_legal_move();
+    count = ct_graph_legal_move_count(graph);
+    memcpy(legal_moves, ct_graph_legal_moves(graph), count * sizeof(CtMove));
+    for (index = 0; index < count; index++)
+    {
+      ct_graph_make_move(graph, legal_moves[index]);
+      ut_graph_verify_is_legal_move();
+      ct_graph_unmake_move(graph);
+    }
+  }
+  ct_graph_reset(graph);
+  for (index = 0; moves[index]; index++)
+  {
+    ct_graph_make_move(graph, ct_graph_move_from_san(graph, moves[index]));
+    ut_graph_verify_is_legal_move();
+  }
+  ck_assert(ct_graph_is_legal_move(graph, ct_move_make_en_passant_capture(E5, F6)));
+  ck_assert(!ct_graph_is_legal_move(graph, ct_move_make(E5, F6)));
+  ck_assert(!ct_graph_is_legal_move(graph, ct_move_make_en_passant_capture(E5, D6)));
+
+  /* only the promotions to a white knight, bishop, rook or queen are legal, not EMPTY, a pawn, a king or a move type
+     without the promotion bit */
+  ct_graph_from_fen(graph, "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -");
+  ck_assert(ct_graph_is_legal_move(graph, ct_move_make_promotion_Q(D7, C8)));
+  ck_assert(ct_graph_is_legal_move(graph, ct_move_make_promotion_R(D7, C8)));
+  ck_assert(ct_graph_is_legal_move(graph, ct_move_make_promotion_B(D7, C8)));
+  ck_assert(ct_graph_is_legal_move(graph, ct_move_make_promotion_N(D7, C8)));
+  for (index = 0; index < 16; index++)
+  {
+    CtMove move = (CtMove) ((index << 12) | ct_move_make(D7, C8));
+    CtPiece promotes_to = ct_move_promotes_to(move);
+
+    ck_assert(!ct_piece_is_pawn(promotes_to) && ct_piece_to_white(promotes_to) != WHITE_KING);
+    ck_assert(ct_graph_is_legal_move(graph, move)
+              == (promotes_to != EMPTY && ct_piece_color(promotes_to) == WHITE_PIECE));
+  }
+  ck_assert(!ct_graph_is_legal_move(graph, (CtMove) (PROMOTION << 12 | ct_move_make(D7, C8))));
+  ck_assert_str_eq(ct_graph_to_fen(graph, 0), "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -");
+} END_TEST
+
+/* compares ct_graph_is_legal_move with the legal moves for every value a move can have */
+static void
+ut_graph_verify_is_legal_move(void)
+{
+  static bool is_legal[1 << 16];
+  CtMove *legal_moves = ct_graph_legal_moves(graph);
+  int count = ct_graph_legal_move_count(graph);
+  int index, value;
+  CtMove move;
+
+  memset(is_legal, 0, sizeof(is_legal));
+  for (index = 0; index < count; index++)
+    is_legal[(uint16_t) legal_moves[index]] = true;
+  for (value = 0; value < 1 << 16; value++)
+  {
+    move = (CtMove) value;
+    if (ct_graph_is_legal_move(graph, move) != is_legal[value])
+    {
+      char msg[CT_FEN_MAX_LENGTH + 100];
+      char move_to_s[CT_MOVE_TO_S_MAX_LENGTH];
+
+      snprintf(msg, sizeof(msg), "Failed fen=%s, move=%s (%04x)", ct_graph_to_fen(graph, 0),
+               ct_move_to_s(move, move_to_s), value);
+      ck_abort_msg(msg);
+    }
+  }
+}
+
+START_TEST(ut_graph_moves_by_stage)
+{
+  char *fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+    "rnbqkb1r/pp1p1ppp/2p5/4P3/2B5/8/PPP1NnPP/RNBQK2R w KQkq -",
+    "8/8/8/2k5/3Pp3/8/8/4K2B b - d3",
+    0
+  };
+  CtMove legal_moves[CT_GRAPH_MAX_MOVES];
+  CtMove moves[CT_GRAPH_MAX_MOVES];
+  int index, count, fen_index;
+
+  /* the positions after the first ones include checks by every kind of piece */
+  for (fen_index = 0; fens[fen_index]; fen_index++)
+  {
+    ct_graph_from_fen(graph, fens[fen_index]);
+    ut_graph_verify_moves_by_stage();
+    count = ct_graph_legal_move_count(graph);
+    memcpy(legal_moves, ct_graph_legal_moves(graph), count * sizeof(CtMove));
+    for (index = 0; index < count; index++)
+    {
+      ct_graph_make_move(graph, legal_moves[index]);
+      ut_graph_verify_moves_by_stage();
+      ct_graph_unmake_move(graph);
+    }
+  }
+
+  /* in double check only the king can move */
+  ct_graph_from_fen(graph, "4r1k1/8/8/8/8/3n4/8/4K3 w - -");
+  count = ct_graph_moves_by_stage(graph, EVASION_STAGE, moves);
+  ck_assert_int_eq(count, 3);
+  for (index = 0; index < count; index++)
+    ck_assert_int_eq(ct_move_from(moves[index]), E1);
+
+  ct_graph_reset(graph);
+  ck_assert_int_eq(ct_graph_moves_by_stage(graph, CAPTURE_STAGE, moves), 0);
+  ck_assert_int_eq(ct_graph_moves_by_stage(graph, QUIET_CHECK_STAGE, moves), 0);
+  ck_assert_int_eq(ct_graph_moves_by_stage(graph, EVASION_STAGE, moves), 0);
+  ck_assert_int_eq(ct_graph_moves_by_stage(graph, QUIET_STAGE, moves), 20);
+} END_TEST
+
+/* the captures and the quiet moves split the legal moves between them, the quiet checks are the quiet moves that give
+   check, and in check the evasions are all of the legal moves */
+static void
+ut_graph_verify_moves_by_stage(void)
+{
+  enum
+  {
+    CAPTURE = 1, QUIET = 2, QUIET_CHECK = 4
+  };
+  static int stage_of[1 << 16];
+  CtMove moves[CT_GRAPH_MAX_MOVES];
+  CtMove *legal_moves;
+  char fen[CT_FEN_MAX_LENGTH];
+  int index, count, capture_count, quiet_count, quiet_check_count = 0;
+  bool is_check;
+
+  ct_graph_to_fen(graph, fen);
+  memset(stage_of, 0, sizeof(stage_of));
+  capture_count = ct_graph_moves_by_stage(graph, CAPTURE_STAGE, moves);
+  for (index = 0; index < capture_count; index++)
+    stage_of[(uint16_t) moves[index]] |= CAPTURE;
+  quiet_count = ct_graph_moves_by_stage(graph, QUIET_STAGE, moves);
+  for (index = 0; index < quiet_count; index++)
+  {
+    stage_of[(uint16_t) moves[index]] |= QUIET;
+    ct_graph_make_move(graph, moves[index]);
+    if (ct_position_is_check(ct_graph_to_position(graph, 0)))
+    {
+      stage_of[(uint16_t) moves[index]] |= QUIET_CHECK;
+      quiet_check_count++;
+    }
+    ct_graph_unmake_move(graph);
+  }
+  count = ct_graph_moves_by_stage(graph, QUIET_CHECK_STAGE, moves);
+  ck_assert_msg(count == quiet_check_count, fen);
+  for (index = 0; index < count; index++)
+    ck_assert_msg(stage_of[(uint16_t) moves[index]] & QUIET_CHECK, fen);
+
+  legal_moves = ct_graph_legal_moves(graph);
+  count = ct_graph_legal_move_count(graph);
+  ck_assert_msg(capture_count + quiet_count == count, fen);
+  for (index = 0; index < count; index++)
+    ck_assert_msg((stage_of[(uint16_t) legal_moves[index]] & (CAPTURE | QUIET)) != 0, fen);
+
+  is_check = ct_position_is_check(ct_graph_to_position(graph, 0));
+  count = ct_graph_moves_by_stage(graph, EVASION_STAGE, moves);
+  ck_assert_msg(count == (is_check ? ct_graph_legal_move_count(graph) : 0), fen);
+  for (index = 0; index < count; index++)
+    ck_assert_msg(ct_graph_is_legal_move(graph, moves[index]), fen);
+}
+
 Suite *
 ut_graph_make_suite(void)
 {
@@ -171,6 +540,13 @@ ut_graph_make_suite(void)
   tcase_add_test(test_case, ut_graph_make_unmake_ply);
   tcase_add_test(test_case, ut_graph_for_each_move_made);
   tcase_add_test(test_case, ut_graph_reset);
+  tcase_add_test(test_case, ut_graph_goto_ply);
+  tcase_add_test(test_case, ut_graph_goto_ply_and_make_move);
+  tcase_add_test(test_case, ut_graph_make_move_replaces_snapshots);
+  tcase_add_test(test_case, ut_graph_position_at);
+  tcase_add_test(test_case, ut_graph_legal_moves);
+  tcase_add_test(test_case, ut_graph_is_legal_move);
+  tcase_add_test(test_case, ut_graph_moves_by_stage);
   suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
@@ -19,6 +19,7 @@
 #include <check.h>
 #include "chess_toolkit.h"
 #include <stdlib.h>
+#include <string.h>
 
 static CtGameTags game_tags;
 static CtGraph graph;
@@ -27,6 +28,21 @@ static char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
 static void setup(void);
 static void teardown(void);
 static void ut_graph_from_pgn_check_carlsen_round_10(void *delegate);
+static void ut_graph_from_pgn_count_game(void *delegate);
+static void ut_graph_from_pgn_save_checkpoint(void *delegate);
+static void ut_graph_from_pgn_save_white(void *delegate);
+
+enum
+{
+  GAMES_IN_FILE = 56,
+  RESUME_AT_GAME = 20
+};
+
+static CtPgnCheckpointStruct checkpoint;
+static CtPgnCheckpointStruct resume_checkpoint;
+static int checkpoints_taken;
+static int save_white_at_game;
+static char white_at_resume[GAME_TAGS_VALUE_MAX_LENGTH];
 
 static void
 setup(void)
@@ -140,6 +156,41 @@ START_TEST(ut_graph_from_pgn_error)
   ck_assert_str_eq(error_message, "syntax error on line 2 column 4");
 } END_TEST
 
+START_TEST(ut_graph_from_pgn_variations)
+{
+  CtGraph result;
+  CtGraph main_line = ct_graph_new();
+  char fen[CT_FEN_MAX_LENGTH];
+  char main_line_fen[CT_FEN_MAX_LENGTH];
+
+  /* the graph holds the moves of the game, whatever variations were read along the way */
+  ct_graph_from_pgn(main_line, 0, "1. e4 e5 2. Nf3 *", error_message);
+  result = ct_graph_from_pgn(graph, game_tags,
+                             "1. e4 e5 $1 (1... c5 2. Nf3 (2. c3 d5) 2... d6) (1... e6) 2. Nf3 $2 *", error_message);
+  ck_assert(result == graph);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(ct_graph_ply(graph), 3);
+  ck_assert_str_eq(ct_graph_to_fen(graph, fen), ct_graph_to_fen(main_line, main_line_fen));
+
+  result = ct_graph_from_pgn(graph, game_tags, "(1. d4) 1. e4 *", error_message);
+  ck_assert(result == 0);
+  ck_assert_str_eq(error_message, "syntax error on line 1 column 1");
+  result = ct_graph_from_pgn(graph, game_tags, "1. e4 e5 ((1... c5) 1... d5) *", error_message);
+  ck_assert(result == 0);
+  ck_assert_str_eq(error_message, "syntax error on line 1 column 11");
+  result = ct_graph_from_pgn(graph, game_tags, "1. e4 e5 ) *", error_message);
+  ck_assert(result == 0);
+  ck_assert_str_eq(error_message, "syntax error on line 1 column 10");
+  result = ct_graph_from_pgn(graph, game_tags, "1. e4 (1. e5) *", error_message);        /* illegal move */
+  ck_assert(result == 0);
+  ck_assert_str_eq(error_message, "syntax error on line 1 column 11");
+  result = ct_graph_from_pgn(graph, game_tags, "1. e4 (1. d4 *", error_message);
+  ck_assert(result == 0);
+  ck_assert_str_eq(error_message, "syntax error on line 1 column 14");
+
+  ct_graph_free(main_line);
+} END_TEST
+
 START_TEST(ut_graph_from_pgn_parse_file)
 {
   int found_it = 0;
@@ -154,6 +205,149 @@ START_TEST(ut_graph_from_pgn_parse_file)
   ct_command_free(command);
 } END_TEST
 
+START_TEST(ut_graph_from_pgn_parse_file_filtered)
+{
+  int found_it = 0;
+  int games_read = 0;
+  CtCommand command = ct_command_new(&found_it, ut_graph_from_pgn_check_carlsen_round_10);
+  CtCommand count_command = ct_command_new(&games_read, ut_graph_from_pgn_count_game);
+  CtGameFilter game_filter = ct_game_filter_new();
+  FILE *file = fopen("candidates2013.pgn", "r");
+  CtPgnInput pgn_input;
+
+  ck_assert(file != 0);
+  ct_game_filter_set_player(game_filter, "Carlsen, Magnus");
+  ct_game_filter_set_date_range(game_filter, "2013.03.27", "2013.03.27");
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_filtered(graph, game_tags, pgn_input, game_filter, command, error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_int_eq(found_it, 1);
+
+  ct_game_filter_reset(game_filter);
+  ct_game_filter_set_eco_range(game_filter, "B00", "B99");
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_filtered(graph, game_tags, pgn_input, game_filter, count_command, error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, 6);
+
+  fclose(file);
+  ct_game_filter_free(game_filter);
+  ct_command_free(count_command);
+  ct_command_free(command);
+} END_TEST
+
+static void
+ut_graph_from_pgn_save_checkpoint(void *delegate)
+{
+  checkpoints_taken++;
+  if (checkpoint.game == RESUME_AT_GAME)
+    resume_checkpoint = checkpoint;
+}
+
+/* saves the White player of game number save_white_at_game, counting games with the delegate */
+static void
+ut_graph_from_pgn_save_white(void *delegate)
+{
+  int *games_read = (int *) delegate;
+
+  if (*games_read == save_white_at_game)
+    strcpy(white_at_resume, ct_game_tags_get(game_tags, "White"));
+  *games_read += 1;
+}
+
+START_TEST(ut_graph_from_pgn_resumable)
+{
+  int games_read = 0;
+  CtCommand command = ct_command_new(&games_read, ut_graph_from_pgn_save_white);
+  CtCommand checkpoint_command = ct_command_new(0, ut_graph_from_pgn_save_checkpoint);
+  FILE *file = fopen("candidates2013.pgn", "r");
+  CtPgnInput pgn_input;
+  char white[GAME_TAGS_VALUE_MAX_LENGTH];
+
+  ck_assert(file != 0);
+  checkpoint.offset = 0;
+  checkpoint.game = 0;
+  checkpoints_taken = 0;
+  save_white_at_game = RESUME_AT_GAME;
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_resumable(graph, game_tags, pgn_input, &checkpoint, 10, checkpoint_command, command,
+                                    error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, GAMES_IN_FILE);
+  ck_assert_int_eq(checkpoints_taken, 6);        /* after games 10, 20, 30, 40 and 50, and at the end */
+  ck_assert_int_eq(checkpoint.game, GAMES_IN_FILE);
+  ck_assert_int_eq(resume_checkpoint.game, RESUME_AT_GAME);
+  strcpy(white, white_at_resume);
+
+  /* resuming skips straight to the game after the checkpoint */
+  rewind(file);
+  games_read = 0;
+  save_white_at_game = 0;
+  checkpoint = resume_checkpoint;
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_resumable(graph, game_tags, pgn_input, &checkpoint, 10, checkpoint_command, command,
+                                    error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, GAMES_IN_FILE - RESUME_AT_GAME);
+  ck_assert_str_eq(white_at_resume, white);
+  ck_assert_int_eq(checkpoint.game, GAMES_IN_FILE);
+
+  /* resuming past the end of the input is an error */
+  rewind(file);
+  checkpoint.offset = 1000000;
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_resumable(graph, game_tags, pgn_input, &checkpoint, 10, 0, command, error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_str_eq(error_message, "cannot resume reading at byte 1000000");
+
+  fclose(file);
+  ct_command_free(checkpoint_command);
+  ct_command_free(command);
+} END_TEST
+
+START_TEST(ut_graph_from_pgn_filtered_moves_are_lazy)
+{
+  int games_read = 0;
+  CtCommand command = ct_command_new(&games_read, ut_graph_from_pgn_count_game);
+  CtGameFilter game_filter = ct_game_filter_new();
+  FILE *file = tmpfile();
+  CtPgnInput pgn_input;
+
+  /* the moves of a game the filter rejects are never decoded, so an illegal move there is not noticed */
+  fputs("[White \"Rejected\"]\n\n1. e4 e5 2. Rd4 *\n\n[White \"Accepted\"]\n\n1. d4 d5 2. c4 *\n", file);
+  ct_game_filter_set_player(game_filter, "Accepted");
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_filtered(graph, game_tags, pgn_input, game_filter, command, error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, 1);
+
+  ct_game_filter_set_player(game_filter, "Rejected");
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ct_graph_from_pgn_input_filtered(graph, game_tags, pgn_input, game_filter, command, error_message);
+  ct_pgn_input_free(pgn_input);
+  ck_assert_str_eq(error_message, "syntax error on line 3 column 13");
+  ck_assert_int_eq(games_read, 1);
+
+  fclose(file);
+  ct_game_filter_free(game_filter);
+  ct_command_free(command);
+} END_TEST
+
+static void
+ut_graph_from_pgn_count_game(void *delegate)
+{
+  int *games_read = (int *) delegate;
+
+  *games_read += 1;
+}
+
 static void
 ut_graph_from_pgn_check_carlsen_round_10(void *delegate)
 {
@@ -206,7 +400,11 @@ ut_graph_from_pgn_make_suite(void)
   tcase_add_test(test_case, ut_graph_from_pgn);
   tcase_add_test(test_case, ut_graph_from_pgn_short);
   tcase_add_test(test_case, ut_graph_from_pgn_error);
+  tcase_add_test(test_case, ut_graph_from_pgn_variations);
   tcase_add_test(test_case, ut_graph_from_pgn_parse_file);
+  tcase_add_test(test_case, ut_graph_from_pgn_parse_file_filtered);
+  tcase_add_test(test_case, ut_graph_from_pgn_filtered_moves_are_lazy);
+  tcase_add_test(test_case, ut_graph_from_pgn_resumable);
   suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
@@ -106,6 +106,87 @@ START_TEST(ut_graph_move_from_san)
   }
 } END_TEST
 
+START_TEST(ut_graph_move_from_uci)
+{
+  UtMoveReaderTestStruct tests[] =
+  {
+    {false, "", "e2e4", ct_move_make(E2, E4)},
+    {false, "", "g1f3", ct_move_make(G1, F3)},
+    {false, "", "e2e5", NULL_MOVE},
+    {false, "", "e7e5", NULL_MOVE},        /* not black's turn */
+    {false, "", "e2e4 ", NULL_MOVE},
+    {false, "", "e2", NULL_MOVE},
+    {false, "", "e2e4q", NULL_MOVE},
+    {false, "5k2/8/8/8/8/p6p/P6P/R3K2R w KQ -", "e1g1", ct_move_make_castle_kingside(E1)},
+    {false, "", "e1c1", ct_move_make_castle_queenside(E1)},
+    {false, "", "e1f1", ct_move_make(E1, F1)},
+    {false, "rnbqkbnr/ppp1pppp/8/8/3p4/8/PPPPPPPP/RNBQKBNR w KQkq -", "c2c4", ct_move_make_en_passant_possible(C2, C4)},
+    {false, "", "a2a4", ct_move_make(A2, A4)},
+    {false, "rnbqkbnr/ppp1pppp/8/8/2Pp4/8/PP1PPPPP/RNBQKBNR b KQkq c3", "d4c3", ct_move_make_en_passant_capture(D4, C3)},
+    {false, "", "d4e3", NULL_MOVE},
+    {false, "r3k2r/Pppp1ppp/1b3nbN/nPP5/BB2P3/q4N2/Pp1P2PP/R2Q1RK1 b kq -", "b2b1q", ct_move_make_promotion_q(B2, B1)},
+    {false, "", "b2a1n", ct_move_make_promotion_n(B2, A1)},
+    {false, "", "b2b1", NULL_MOVE},
+    {false, "", "b2b1k", NULL_MOVE},
+    {true, "", "", 0}
+  };
+  UtMoveReaderTest test;
+  CtMove move, *legal_moves;
+  int index, count;
+
+  for (test = tests; !test->end_of_tests; test++)
+  {
+    if (strlen(test->fen) > 0)
+      ck_assert_msg(ct_graph_from_fen(graph, test->fen) != 0, test->fen);
+    move = ct_graph_move_from_uci(graph, test->notation);
+    if (move != test->expected_move)
+    {
+      char msg[CT_FEN_MAX_LENGTH + 100];
+
+      snprintf(msg, sizeof(msg), "Failed fen=%s, notation=%s, expected_move=%d, move=%d",
+               test->fen, test->notation, test->expected_move, move);
+      ck_abort_msg(msg);
+    }
+  }
+
+  /* every legal move reads back from what ct_graph_move_to_uci writes */
+  ct_graph_from_fen(graph, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -");
+  legal_moves = ct_graph_legal_moves(graph);
+  count = ct_graph_legal_move_count(graph);
+  for (index = 0; index < count; index++)
+    ck_assert_int_eq(ct_graph_move_from_uci(graph, ct_graph_move_to_uci(graph, legal_moves[index], 0)),
+                     legal_moves[index]);
+} END_TEST
+
+START_TEST(ut_graph_line_from_san)
+{
+  CtMove moves[10];
+  char to_s[10 * CT_SAN_MAX_LENGTH];
+
+  ck_assert_int_eq(ct_graph_line_from_san(graph, "  e4 e5\nBc4 Nc6 Qh5 Nf6 Qxf7# ", moves, 10), 7);
+  ck_assert_int_eq(moves[0], ct_move_make(E2, E4));
+  ck_assert_int_eq(moves[6], ct_move_make(H5, F7));
+  ck_assert_int_eq(ct_graph_ply(graph), 7);
+  ck_assert_str_eq(ct_graph_to_fen(graph, 0), "r1bqkb1r/pppp1Qpp/2n2n2/4p3/2B1P3/8/PPPP1PPP/RNB1K1NR b KQkq -");
+
+  /* and back again */
+  ct_graph_goto_ply(graph, 0);
+  ck_assert_str_eq(ct_graph_line_to_san(graph, moves, 7, to_s), "e4 e5 Bc4 Nc6 Qh5 Nf6 Qxf7#");
+
+  ct_graph_reset(graph);
+  ck_assert_int_eq(ct_graph_line_from_san(graph, "", moves, 10), 0);
+  ck_assert_int_eq(ct_graph_line_from_san(graph, "e4 e4", moves, 10), -1);
+  ck_assert_int_eq(ct_graph_ply(graph), 0);        /* the moves before the bad one are unmade */
+  ck_assert_int_eq(ct_graph_line_from_san(graph, "e4 e5 Nf3", moves, 2), -1);
+  ck_assert_int_eq(ct_graph_ply(graph), 0);
+
+  /* a line read from the middle of a game goes back to where it started */
+  ct_graph_line_from_san(graph, "d4 d5", moves, 10);
+  ck_assert_int_eq(ct_graph_line_from_san(graph, "c4 e6 Nc3 Qxh2", moves, 10), -1);
+  ck_assert_int_eq(ct_graph_ply(graph), 2);
+  ck_assert_str_eq(ct_graph_to_fen(graph, 0), "rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq -");
+} END_TEST
+
 Suite *
 ut_move_reader_make_suite(void)
 {
@@ -117,5 +198,13 @@ ut_move_reader_make_suite(void)
   tcase_add_checked_fixture(test_case, setup, teardown);
   tcase_add_test(test_case, ut_graph_move_from_san);
   suite_add_tcase(test_suite, test_case);
+  test_case = tcase_create("Graph.move_from_uci");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_graph_move_from_uci);
+  suite_add_tcase(test_suite, test_case);
+  test_case = tcase_create("Graph.line_from_san");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_graph_line_from_san);
+  suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
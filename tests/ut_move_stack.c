@@ -171,6 +171,24 @@ START_TEST(ut_move_stack_length)
   ck_assert_int_eq(ct_move_stack_length(move_stack), 0);
 } END_TEST
 
+START_TEST(ut_move_stack_get_and_truncate)
+{
+  CtSquare square;
+
+  for (square = A1; square < H1; square++)
+    ct_move_stack_push(move_stack, ct_move_make(square, square + 1));
+  ck_assert_int_eq(ct_move_stack_get(move_stack, 0), ct_move_make(A1, B1));
+  ck_assert_int_eq(ct_move_stack_get(move_stack, 6), ct_move_make(G1, H1));
+  ck_assert_int_eq(ct_move_stack_get(move_stack, 7), NULL_MOVE);
+  ct_move_stack_truncate(move_stack, 10);        /* already shorter than that */
+  ck_assert_int_eq(ct_move_stack_length(move_stack), 7);
+  ct_move_stack_truncate(move_stack, 3);
+  ck_assert_int_eq(ct_move_stack_length(move_stack), 3);
+  ck_assert_int_eq(ct_move_stack_pop(move_stack), ct_move_make(C1, D1));
+  ct_move_stack_truncate(move_stack, 0);
+  ck_assert(ct_move_stack_is_empty(move_stack));
+} END_TEST
+
 Suite *
 ut_move_stack_make_suite(void)
 {
@@ -187,6 +205,7 @@ ut_move_stack_make_suite(void)
   tcase_add_test(test_case, ut_move_stack_push_command);
   tcase_add_test(test_case, ut_move_stack_for_each);
   tcase_add_test(test_case, ut_move_stack_length);
+  tcase_add_test(test_case, ut_move_stack_get_and_truncate);
   suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
@@ -0,0 +1,189 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <string.h>
+
+static const char *pgn_with_variations =
+  "[Event \"Variations\"]\n"
+  "1. e4 { [%clk 0:03:00] } (1. d4 { [%clk 0:01:00] } d5) e5\n"
+  "(1... c5 2. Nf3 (2. c3 d5) 2... d6) 2. Nf3 *\n";
+
+static CtMoveTree move_tree;
+static CtGraph graph;
+static CtGameTags game_tags;
+static char plies_visited[40];
+
+static void setup(void);
+static void teardown(void);
+static void ut_move_tree_visit(void *delegate, CtMove move);
+static void ut_move_tree_check_game(void *delegate);
+
+static void
+setup(void)
+{
+  move_tree = ct_move_tree_new();
+  graph = ct_graph_new();
+  game_tags = ct_game_tags_new();
+  plies_visited[0] = 0;
+}
+
+static void
+teardown(void)
+{
+  ct_game_tags_free(game_tags);
+  ct_graph_free(graph);
+  ct_move_tree_free(move_tree);
+}
+
+static void
+ut_move_tree_visit(void *delegate, CtMove move)
+{
+  int length = strlen(plies_visited);
+
+  ck_assert(move == ct_move_tree_move(move_tree, ct_move_tree_visited_node(move_tree)));
+  plies_visited[length] = '0' + ct_graph_ply(graph);
+  plies_visited[length + 1] = 0;
+}
+
+/* root, 1. e4 e5 2. Nf3, 1. d4 d5, 1... c5 2. Nf3 d6 and 2. c3 d5 */
+static void
+ut_move_tree_check_game(void *delegate)
+{
+  int *games = (int *) delegate;
+  int e4 = ct_move_tree_first_child(move_tree, MOVE_TREE_ROOT);
+  int e5 = ct_move_tree_first_child(move_tree, e4);
+  int c5 = ct_move_tree_next_sibling(move_tree, e5);
+
+  (*games)++;
+  ck_assert_int_eq(ct_graph_ply(graph), 3);
+  ck_assert_int_eq(ct_move_tree_node_count(move_tree), 11);
+  ck_assert_int_eq(ct_move_tree_parent(move_tree, c5), e4);
+  ck_assert(ct_move_tree_next_sibling(move_tree, ct_move_tree_next_sibling(move_tree, e4)) == MOVE_TREE_NONE);
+  ck_assert(ct_move_tree_next_sibling(move_tree, c5) == MOVE_TREE_NONE);
+}
+
+START_TEST(ut_move_tree_add)
+{
+  CtMove e4 = ct_graph_move_from_san(graph, "e4");
+  CtMove d4 = ct_graph_move_from_san(graph, "d4");
+  int e4_node;
+  int d4_node;
+  int node;
+  int index;
+
+  ck_assert_int_eq(ct_move_tree_node_count(move_tree), 1);
+  ck_assert(ct_move_tree_first_child(move_tree, MOVE_TREE_ROOT) == MOVE_TREE_NONE);
+  e4_node = ct_move_tree_add(move_tree, MOVE_TREE_ROOT, e4);
+  d4_node = ct_move_tree_add(move_tree, MOVE_TREE_ROOT, d4);
+  ck_assert_int_eq(ct_move_tree_add(move_tree, MOVE_TREE_ROOT, e4), e4_node);        /* the move is already there */
+  ck_assert_int_eq(ct_move_tree_node_count(move_tree), 3);
+  ck_assert_int_eq(ct_move_tree_first_child(move_tree, MOVE_TREE_ROOT), e4_node);
+  ck_assert_int_eq(ct_move_tree_next_sibling(move_tree, e4_node), d4_node);
+  ck_assert_int_eq(ct_move_tree_parent(move_tree, d4_node), MOVE_TREE_ROOT);
+  ck_assert(ct_move_tree_move(move_tree, d4_node) == d4);
+
+  /* node numbers stay good as the tree grows */
+  node = d4_node;
+  for (index = 0; index < 1000; index++)
+    node = ct_move_tree_add(move_tree, node, index % 2 ? e4 : d4);
+  ck_assert_int_eq(ct_move_tree_node_count(move_tree), 1003);
+  ck_assert_int_eq(ct_move_tree_next_sibling(move_tree, e4_node), d4_node);
+  ck_assert_int_eq(ct_move_tree_parent(move_tree, node), node - 1);
+
+  ct_move_tree_reset(move_tree);
+  ck_assert_int_eq(ct_move_tree_node_count(move_tree), 1);
+  ck_assert(ct_move_tree_first_child(move_tree, MOVE_TREE_ROOT) == MOVE_TREE_NONE);
+} END_TEST
+
+START_TEST(ut_move_tree_from_pgn_input)
+{
+  FILE *file = tmpfile();
+  CtPgnInput pgn_input;
+  CtPgnReader pgn_reader;
+  CtGameAnnotations game_annotations = ct_game_annotations_new();
+  CtMoveCommand visit = ct_move_command_new(0, ut_move_tree_visit);
+  int games = 0;
+
+  fputs(pgn_with_variations, file);
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ct_pgn_input_use_move_tree(pgn_input, move_tree);
+  ct_pgn_input_use_game_annotations(pgn_input, game_annotations);
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, pgn_input);
+  ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  ut_move_tree_check_game(&games);
+
+  /* the clock in the variation is not the clock of the game */
+  ck_assert_int_eq(ct_game_annotations_clocks(game_annotations)[1], 18000);
+
+  /* depth first, with the main line before the variations */
+  while (ct_graph_ply(graph) > 0)
+    ct_graph_unmake_move(graph);
+  ct_move_tree_for_each_move(move_tree, graph, visit);
+  ck_assert_str_eq(plies_visited, "1232343412");
+  ck_assert_int_eq(ct_graph_ply(graph), 0);
+  ck_assert(ct_move_tree_visited_node(move_tree) == MOVE_TREE_NONE);
+
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(pgn_input);
+  ct_move_command_free(visit);
+  ct_game_annotations_free(game_annotations);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_move_tree_from_pgn_input_filtered)
+{
+  FILE *file = tmpfile();
+  CtPgnInput pgn_input;
+  CtGameFilter game_filter = ct_game_filter_new();
+  int games = 0;
+  CtCommand check_game = ct_command_new(&games, ut_move_tree_check_game);
+  char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+
+  /* variations are saved along with the moves of games read lazily */
+  fputs(pgn_with_variations, file);
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ct_pgn_input_use_move_tree(pgn_input, move_tree);
+  ct_graph_from_pgn_input_filtered(graph, game_tags, pgn_input, game_filter, check_game, error_message);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games, 1);
+
+  ct_pgn_input_free(pgn_input);
+  ct_command_free(check_game);
+  ct_game_filter_free(game_filter);
+  fclose(file);
+} END_TEST
+
+Suite *
+ut_move_tree_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_move_tree");
+  test_case = tcase_create("MoveTree");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_move_tree_add);
+  tcase_add_test(test_case, ut_move_tree_from_pgn_input);
+  tcase_add_test(test_case, ut_move_tree_from_pgn_input_filtered);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
@@ -19,6 +19,10 @@
 #include <check.h>
 #include "chess_toolkit.h"
 
+static int number_of_errors = 0;
+
+static void ut_move_writer_error_handler(const char *msg);
+
 typedef struct UtMoveToSTestStruct *UtMoveToSTest;
 typedef struct UtMoveToSTestStruct
 {
@@ -102,6 +106,73 @@ START_TEST(ut_graph_move_to_san)
   ct_graph_free(graph);
 } END_TEST
 
+START_TEST(ut_graph_move_to_uci)
+{
+  UtMoveToSTestStruct tests[] =
+  {
+    {false, ct_move_make(E2, E4), "e2e4"},
+    {false, ct_move_make_en_passant_possible(C7, C5), "c7c5"},
+    {false, ct_move_make_castle_kingside(E1), "e1g1"},
+    {false, ct_move_make_castle_queenside(E8), "e8c8"},
+    {false, ct_move_make_promotion_Q(D7, D8), "d7d8q"},
+    {false, ct_move_make_promotion_n(D2, C1), "d2c1n"},
+    {false, NULL_MOVE, "0000"},
+    {true, NULL_MOVE, 0}
+  };
+  UtMoveToSTest test;
+  char to_uci[CT_UCI_MAX_LENGTH];
+  char *result;
+
+  for (test = tests; !test->end_of_tests; test++)
+  {
+    result = ct_graph_move_to_uci(0, test->move, to_uci);
+    ck_assert_str_eq(result, test->expected_result);
+    ck_assert(result == to_uci);
+    result = ct_graph_move_to_uci(0, test->move, 0);
+    ck_assert_str_eq(result, test->expected_result);
+  }
+} END_TEST
+
+static void
+ut_move_writer_error_handler(const char *msg)
+{
+  number_of_errors++;
+}
+
+START_TEST(ut_graph_line_to_san)
+{
+  CtMove moves[] = {
+    ct_move_make(E2, E4), ct_move_make(E7, E5), ct_move_make(F1, C4), ct_move_make(B8, C6), ct_move_make(D1, H5),
+    ct_move_make(G8, F6), ct_move_make(H5, F7)
+  };
+  CtMove knight_moves[] = {ct_move_make(A1, C2), ct_move_make(A8, B7), ct_move_make(C2, B4)};
+  CtMove queen_moves[] = {ct_move_make(B1, B8)};
+  CtGraph graph = ct_graph_new();
+  char to_s[10 * CT_SAN_MAX_LENGTH];
+  char *result;
+
+  result = ct_graph_line_to_san(graph, moves, 7, to_s);
+  ck_assert(result == to_s);
+  ck_assert_str_eq(to_s, "e4 e5 Bc4 Nc6 Qh5 Nf6 Qxf7#");
+  ck_assert_int_eq(ct_graph_ply(graph), 7);
+  ck_assert_str_eq(ct_graph_line_to_san(graph, moves, 0, to_s), "");
+
+  ct_graph_from_fen(graph, "k7/8/8/8/8/N7/8/N3N3 w - -");
+  ck_assert_str_eq(ct_graph_line_to_san(graph, knight_moves, 3, to_s), "Na1c2 Kb7 Nb4");
+  ct_graph_from_fen(graph, "k7/8/8/8/8/8/8/1Q4K1 w - -");
+  ck_assert_str_eq(ct_graph_line_to_san(graph, queen_moves, 1, to_s), "Qb8+");
+
+  /* there is no shared destination to fall back on */
+  ct_error_set_custom_handler(ut_move_writer_error_handler);
+  number_of_errors = 0;
+  ct_graph_reset(graph);
+  ck_assert(ct_graph_line_to_san(graph, moves, 7, 0) == 0);
+  ck_assert_int_eq(number_of_errors, 1);
+  ck_assert_int_eq(ct_graph_ply(graph), 0);
+  ct_error_set_custom_handler(0);
+  ct_graph_free(graph);
+} END_TEST
+
 Suite *
 ut_move_writer_make_suite(void)
 {
@@ -115,5 +186,11 @@ ut_move_writer_make_suite(void)
   test_case = tcase_create("Graph.move_to_san");
   tcase_add_test(test_case, ut_graph_move_to_san);
   suite_add_tcase(test_suite, test_case);
+  test_case = tcase_create("Graph.move_to_uci");
+  tcase_add_test(test_case, ut_graph_move_to_uci);
+  suite_add_tcase(test_suite, test_case);
+  test_case = tcase_create("Graph.line_to_san");
+  tcase_add_test(test_case, ut_graph_line_to_san);
+  suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
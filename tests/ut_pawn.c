@@ -180,6 +180,30 @@ START_TEST(ut_pawn)
   ct_pawn_free(black_pawn);
 } END_TEST
 
+START_TEST(ut_pawn_moves)
+{
+  CtMoveStack move_stack = ct_move_stack_new();
+  CtPawn white_pawn = ct_pawn_new(ct_move_stack_push_command(move_stack), WHITE_PIECE);
+  CtPosition position = ct_position_from_fen(0, "1n6/P7/8/3Pp3/1p6/2r5/PP1P4/8 w - e6");
+  CtMove expected_moves[] = {
+    ct_move_make_promotion_Q(A7, A8), ct_move_make_promotion_R(A7, A8), ct_move_make_promotion_B(A7, A8),
+    ct_move_make_promotion_N(A7, A8), ct_move_make(A2, A3), ct_move_make(B2, B3), ct_move_make(D2, D3),
+    ct_move_make(D5, D6), ct_move_make(D2, D4), ct_move_make_en_passant_possible(A2, A4), ct_move_make(D2, C3),
+    ct_move_make_promotion_Q(A7, B8), ct_move_make_promotion_R(A7, B8), ct_move_make_promotion_B(A7, B8),
+    ct_move_make_promotion_N(A7, B8), ct_move_make(B2, C3), ct_move_make_en_passant_capture(D5, E6)
+  };
+  unsigned int index;
+
+  /* all of the pawns at once, each kind of move in square order */
+  ct_pawn_moves(white_pawn, position);
+  ck_assert_int_eq(ct_move_stack_length(move_stack), sizeof(expected_moves) / sizeof(CtMove));
+  for (index = 0; index < sizeof(expected_moves) / sizeof(CtMove); index++)
+    ck_assert_int_eq(ct_move_stack_get(move_stack, index), expected_moves[index]);
+
+  ct_pawn_free(white_pawn);
+  ct_move_stack_free(move_stack);
+} END_TEST
+
 Suite *
 ut_pawn_make_suite(void)
 {
@@ -194,6 +218,7 @@ ut_pawn_make_suite(void)
   test_case = tcase_create("Pawn Special");
   tcase_add_test(test_case, ut_pawn_promotion);
   tcase_add_test(test_case, ut_pawn_en_passant);
+  tcase_add_test(test_case, ut_pawn_moves);
   suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
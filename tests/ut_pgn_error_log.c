@@ -0,0 +1,195 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <string.h>
+
+/* the second game has an illegal move on line 6, and the fourth has a tag that is never closed (which is found at the
+   move on line 11) */
+static const char *pgn_with_errors =
+  "[Event \"Good 1\"]\n"
+  "\n"
+  "1. e4 e5 2. Nf3 1-0\n"
+  "\n"
+  "[Event \"Illegal move\"]\n"
+  "1. e4 e5 2. Ke3 Nc6 0-1\n"
+  "\n"
+  "[Event \"Good 2\"]\n"
+  "1. d4 d5 1/2-1/2\n"
+  "[Event \"Unclosed tag\"\n"
+  "1. c4 *\n"
+  "[Event \"Good 3\"]\n"
+  "1. Nf3 *\n";
+
+static CtGameTags game_tags;
+static CtGraph graph;
+static char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+static FILE *pgn_file;
+static CtPgnInput pgn_input;
+static int games_read;
+static char events_read[80];
+
+static void setup(void);
+static void teardown(void);
+static void ut_pgn_error_log_read_game(void *delegate);
+static void ut_pgn_error_log_read(CtPgnErrorLog pgn_error_log, CtGameFilter game_filter);
+
+static void
+setup(void)
+{
+  game_tags = ct_game_tags_new();
+  graph = ct_graph_new();
+  pgn_file = tmpfile();
+  fputs(pgn_with_errors, pgn_file);
+  rewind(pgn_file);
+  pgn_input = ct_pgn_input_new(pgn_file);
+  games_read = 0;
+  events_read[0] = 0;
+}
+
+static void
+teardown(void)
+{
+  ct_pgn_input_free(pgn_input);
+  fclose(pgn_file);
+  ct_graph_free(graph);
+  ct_game_tags_free(game_tags);
+}
+
+static void
+ut_pgn_error_log_read_game(void *delegate)
+{
+  games_read++;
+  strcat(events_read, ct_game_tags_get(game_tags, "Event"));
+  strcat(events_read, ";");
+}
+
+static void
+ut_pgn_error_log_read(CtPgnErrorLog pgn_error_log, CtGameFilter game_filter)
+{
+  CtCommand command = ct_command_new(0, ut_pgn_error_log_read_game);
+
+  ct_pgn_input_use_error_log(pgn_input, pgn_error_log);
+  ck_assert(ct_pgn_input_error_log(pgn_input) == pgn_error_log);
+  if (game_filter)
+    ct_graph_from_pgn_input_filtered(graph, game_tags, pgn_input, game_filter, command, error_message);
+  else
+    ct_graph_from_pgn_input(graph, game_tags, pgn_input, command, error_message);
+  ct_command_free(command);
+}
+
+START_TEST(ut_pgn_error_log_add)
+{
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_COLLECT);
+  char message[32];
+  int index;
+
+  ck_assert_int_eq(ct_pgn_error_log_policy(pgn_error_log), PGN_ERROR_COLLECT);
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 0);
+  for (index = 0; index < 40; index++)        /* enough to grow the log */
+  {
+    sprintf(message, "error %d", index);
+    ct_pgn_error_log_add(pgn_error_log, index * 2, message);
+  }
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 40);
+  ck_assert_int_eq(ct_pgn_error_log_game(pgn_error_log, 39), 78);
+  ck_assert_str_eq(ct_pgn_error_log_message(pgn_error_log, 39), "error 39");
+  ck_assert_str_eq(ct_pgn_error_log_message(pgn_error_log, 0), "error 0");
+  ct_pgn_error_log_reset(pgn_error_log);
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 0);
+  ct_pgn_error_log_free(pgn_error_log);
+} END_TEST
+
+START_TEST(ut_pgn_error_log_no_log)
+{
+  ut_pgn_error_log_read(0, 0);
+  ck_assert_int_eq(games_read, 1);
+  ck_assert_str_eq(error_message, "syntax error on line 6 column 13");
+} END_TEST
+
+START_TEST(ut_pgn_error_log_abort)
+{
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_ABORT);
+
+  ut_pgn_error_log_read(pgn_error_log, 0);
+  ck_assert_int_eq(games_read, 1);
+  ck_assert_str_eq(error_message, "syntax error on line 6 column 13");
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 0);
+  ct_pgn_error_log_free(pgn_error_log);
+} END_TEST
+
+START_TEST(ut_pgn_error_log_skip_game)
+{
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_SKIP_GAME);
+
+  ut_pgn_error_log_read(pgn_error_log, 0);
+  ck_assert_int_eq(games_read, 3);
+  ck_assert_str_eq(events_read, "Good 1;Good 2;Good 3;");
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 2);
+  ct_pgn_error_log_free(pgn_error_log);
+} END_TEST
+
+START_TEST(ut_pgn_error_log_collect)
+{
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_COLLECT);
+
+  ut_pgn_error_log_read(pgn_error_log, 0);
+  ck_assert_str_eq(events_read, "Good 1;Good 2;Good 3;");
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 2);
+  ck_assert_int_eq(ct_pgn_error_log_game(pgn_error_log, 0), 1);
+  ck_assert_str_eq(ct_pgn_error_log_message(pgn_error_log, 0), "syntax error on line 6 column 13");
+  ck_assert_int_eq(ct_pgn_error_log_game(pgn_error_log, 1), 3);
+  ck_assert_str_eq(ct_pgn_error_log_message(pgn_error_log, 1), "syntax error on line 11 column 4");
+  ct_pgn_error_log_free(pgn_error_log);
+} END_TEST
+
+START_TEST(ut_pgn_error_log_collect_filtered)
+{
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_COLLECT);
+  CtGameFilter game_filter = ct_game_filter_new();
+
+  ut_pgn_error_log_read(pgn_error_log, game_filter);
+  ck_assert_str_eq(events_read, "Good 1;Good 2;Good 3;");
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 2);
+  ck_assert_int_eq(ct_pgn_error_log_game(pgn_error_log, 0), 1);
+  ck_assert_str_eq(ct_pgn_error_log_message(pgn_error_log, 0), "syntax error on line 6 column 13");
+  ct_game_filter_free(game_filter);
+  ct_pgn_error_log_free(pgn_error_log);
+} END_TEST
+
+Suite *
+ut_pgn_error_log_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_pgn_error_log");
+  test_case = tcase_create("PgnErrorLog");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_pgn_error_log_add);
+  tcase_add_test(test_case, ut_pgn_error_log_no_log);
+  tcase_add_test(test_case, ut_pgn_error_log_abort);
+  tcase_add_test(test_case, ut_pgn_error_log_skip_game);
+  tcase_add_test(test_case, ut_pgn_error_log_collect);
+  tcase_add_test(test_case, ut_pgn_error_log_collect_filtered);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
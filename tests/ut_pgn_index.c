@@ -0,0 +1,240 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <stdlib.h>
+#include <string.h>
+#ifdef HAVE_LIBZ
+#include <unistd.h>
+#include <zlib.h>
+#endif
+
+enum
+{
+  GAMES_IN_FILE = 56,
+  BYTES_IN_FILE = 43773,
+  CHECK_GAME = 37
+};
+
+static CtPgnIndex pgn_index;
+static CtGameTags game_tags;
+static CtGraph graph;
+static char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+static FILE *pgn_file;
+static char *saved_pgn;
+
+static void setup(void);
+static void teardown(void);
+static void ut_pgn_index_count_game(void *delegate);
+static void ut_pgn_index_save_game(void *delegate);
+
+static void
+setup(void)
+{
+  pgn_index = ct_pgn_index_new();
+  game_tags = ct_game_tags_new();
+  graph = ct_graph_new();
+  pgn_file = fopen("candidates2013.pgn", "r");
+  ck_assert(pgn_file != 0);
+  saved_pgn = 0;
+}
+
+static void
+teardown(void)
+{
+  free(saved_pgn);
+  fclose(pgn_file);
+  ct_graph_free(graph);
+  ct_game_tags_free(game_tags);
+  ct_pgn_index_free(pgn_index);
+}
+
+static void
+ut_pgn_index_count_game(void *delegate)
+{
+  int *games_read = (int *) delegate;
+
+  *games_read += 1;
+}
+
+/* saves the pgn of the game number CHECK_GAME, counting games with the delegate */
+static void
+ut_pgn_index_save_game(void *delegate)
+{
+  int *game = (int *) delegate;
+
+  if (*game == CHECK_GAME)
+    saved_pgn = ct_graph_to_new_pgn(graph, game_tags);
+  *game += 1;
+}
+
+START_TEST(ut_pgn_index_from_pgn_file)
+{
+  char game_text[8];
+  int game;
+
+  ck_assert(ct_pgn_index_from_pgn_file(pgn_index, pgn_file, error_message) == pgn_index);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(ct_pgn_index_game_count(pgn_index), GAMES_IN_FILE);
+  ck_assert(ct_pgn_index_offset(pgn_index, 0) == 0);
+  for (game = 0; game < GAMES_IN_FILE; game++)
+  {
+    int64_t offset = ct_pgn_index_offset(pgn_index, game);
+    int64_t length = ct_pgn_index_length(pgn_index, game);
+
+    fseek(pgn_file, offset, SEEK_SET);
+    ck_assert_int_eq(fread(game_text, 1, 6, pgn_file), 6);
+    ck_assert(strncmp(game_text, "[Event", 6) == 0);
+    fseek(pgn_file, offset + length - 3, SEEK_SET);
+    ck_assert_int_eq(fread(game_text, 1, 3, pgn_file), 3);
+    ck_assert(strncmp(game_text, "1-0", 3) == 0 || strncmp(game_text, "0-1", 3) == 0
+              || strncmp(game_text, "1/2", 3) == 0);
+    if (game > 0)
+      ck_assert(offset > ct_pgn_index_offset(pgn_index, game - 1) + ct_pgn_index_length(pgn_index, game - 1));
+  }
+  ck_assert(ct_pgn_index_offset(pgn_index, GAMES_IN_FILE - 1) + ct_pgn_index_length(pgn_index, GAMES_IN_FILE - 1)
+            <= BYTES_IN_FILE);
+  ck_assert(ct_pgn_index_header_hash(pgn_index, 0) != ct_pgn_index_header_hash(pgn_index, 1));
+} END_TEST
+
+START_TEST(ut_pgn_index_to_and_from_file)
+{
+  CtPgnIndex loaded_index = ct_pgn_index_new();
+  FILE *file = tmpfile();
+  FILE *short_file;
+  char sidecar[100];
+  int game;
+
+  ct_pgn_index_from_pgn_file(pgn_index, pgn_file, error_message);
+  ck_assert(ct_pgn_index_to_file(pgn_index, file));
+  fseek(file, 0, SEEK_END);
+  ck_assert_int_eq(ftell(file), 24 + 24 * GAMES_IN_FILE);
+  rewind(file);
+  ck_assert(ct_pgn_index_from_file(loaded_index, file) == loaded_index);
+  ck_assert_int_eq(ct_pgn_index_game_count(loaded_index), GAMES_IN_FILE);
+  for (game = 0; game < GAMES_IN_FILE; game++)
+  {
+    ck_assert(ct_pgn_index_offset(loaded_index, game) == ct_pgn_index_offset(pgn_index, game));
+    ck_assert(ct_pgn_index_length(loaded_index, game) == ct_pgn_index_length(pgn_index, game));
+    ck_assert(ct_pgn_index_header_hash(loaded_index, game) == ct_pgn_index_header_hash(pgn_index, game));
+  }
+
+  /* a cut short file leaves the index empty */
+  rewind(file);
+  ck_assert_int_eq(fread(sidecar, 1, sizeof(sidecar), file), sizeof(sidecar));
+  short_file = tmpfile();
+  fwrite(sidecar, 1, sizeof(sidecar), short_file);
+  rewind(short_file);
+  ck_assert(ct_pgn_index_from_file(loaded_index, short_file) == 0);
+  ck_assert_int_eq(ct_pgn_index_game_count(loaded_index), 0);
+  rewind(pgn_file);
+  ck_assert(ct_pgn_index_from_file(loaded_index, pgn_file) == 0);
+
+  fclose(short_file);
+  fclose(file);
+  ct_pgn_index_free(loaded_index);
+} END_TEST
+
+START_TEST(ut_pgn_index_read_games)
+{
+  int game = 0;
+  int games_read = 0;
+  CtCommand save_command = ct_command_new(&game, ut_pgn_index_save_game);
+  CtCommand count_command = ct_command_new(&games_read, ut_pgn_index_count_game);
+  char *expected_pgn;
+
+  ct_graph_from_pgn_file(graph, game_tags, pgn_file, save_command, error_message);
+  ck_assert_int_eq(game, GAMES_IN_FILE);
+  expected_pgn = saved_pgn;
+  saved_pgn = 0;
+
+  rewind(pgn_file);
+  ct_pgn_index_from_pgn_file(pgn_index, pgn_file, error_message);
+  game = CHECK_GAME;
+  ct_graph_from_pgn_index(graph, game_tags, pgn_file, pgn_index, CHECK_GAME, 1, save_command, error_message);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(game, CHECK_GAME + 1);
+  ck_assert_str_eq(saved_pgn, expected_pgn);
+
+  ct_graph_from_pgn_index(graph, game_tags, pgn_file, pgn_index, 10, 5, count_command, error_message);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, 5);
+  ct_graph_from_pgn_index(graph, game_tags, pgn_file, pgn_index, GAMES_IN_FILE - 1, 1, count_command, error_message);
+  ck_assert_int_eq(games_read, 6);
+
+  ct_graph_from_pgn_index(graph, game_tags, pgn_file, pgn_index, GAMES_IN_FILE - 1, 2, count_command, error_message);
+  ck_assert_str_eq(error_message, "game 56 is not in the index");
+  ck_assert_int_eq(games_read, 6);
+
+  free(expected_pgn);
+  ct_command_free(count_command);
+  ct_command_free(save_command);
+} END_TEST
+
+START_TEST(ut_pgn_index_stale)
+{
+  CtPgnIndex stale_index = ct_pgn_index_new();
+  int games_read = 0;
+  CtCommand command = ct_command_new(&games_read, ut_pgn_index_count_game);
+  int game;
+
+  ct_pgn_index_from_pgn_file(pgn_index, pgn_file, error_message);
+  for (game = 0; game < GAMES_IN_FILE; game++)
+    ct_pgn_index_add(stale_index, ct_pgn_index_offset(pgn_index, game), ct_pgn_index_length(pgn_index, game),
+                     ct_pgn_index_header_hash(pgn_index, game == 3 ? 4 : game));
+  ct_graph_from_pgn_index(graph, game_tags, pgn_file, stale_index, 1, 5, command, error_message);
+  ck_assert_str_eq(error_message, "the index does not match game 3");
+  ck_assert_int_eq(games_read, 2);
+
+  ct_command_free(command);
+  ct_pgn_index_free(stale_index);
+} END_TEST
+
+START_TEST(ut_pgn_index_compressed)
+{
+#ifdef HAVE_LIBZ
+  FILE *file = tmpfile();
+  gzFile gz_file = gzdopen(dup(fileno(file)), "wb");
+
+  gzputs(gz_file, "[Event \"Compressed\"]\n\n1. e4 *\n");
+  gzclose(gz_file);
+  rewind(file);
+  ck_assert(ct_pgn_index_from_pgn_file(pgn_index, file, error_message) == 0);
+  ck_assert_str_eq(error_message, "gzip files cannot be indexed");
+  fclose(file);
+#endif
+} END_TEST
+
+Suite *
+ut_pgn_index_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_pgn_index");
+  test_case = tcase_create("PgnIndex");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_pgn_index_from_pgn_file);
+  tcase_add_test(test_case, ut_pgn_index_to_and_from_file);
+  tcase_add_test(test_case, ut_pgn_index_read_games);
+  tcase_add_test(test_case, ut_pgn_index_stale);
+  tcase_add_test(test_case, ut_pgn_index_compressed);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
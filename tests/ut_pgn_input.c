@@ -0,0 +1,256 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef HAVE_LIBBZ2
+#include <bzlib.h>
+#endif
+
+enum
+{
+  GAMES_IN_FILE = 56,
+  BYTES_IN_FILE = 43773,
+  COPIES = 20                        /* enough copies to fill the decompression buffers several times */
+};
+
+static CtGameTags game_tags;
+static CtGraph graph;
+static char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+static char *pgn;
+static int games_read;
+
+static void setup(void);
+static void teardown(void);
+static void ut_pgn_input_count_game(void *delegate);
+static int ut_pgn_input_read_games(FILE * file, char *expected_format);
+
+static void
+setup(void)
+{
+  FILE *file = fopen("candidates2013.pgn", "r");
+
+  ck_assert(file != 0);
+  game_tags = ct_game_tags_new();
+  graph = ct_graph_new();
+  pgn = malloc(BYTES_IN_FILE);
+  ck_assert_int_eq(fread(pgn, 1, BYTES_IN_FILE, file), BYTES_IN_FILE);
+  fclose(file);
+  games_read = 0;
+}
+
+static void
+teardown(void)
+{
+  free(pgn);
+  ct_graph_free(graph);
+  ct_game_tags_free(game_tags);
+}
+
+static void
+ut_pgn_input_count_game(void *delegate)
+{
+  int *games_read = (int *) delegate;
+
+  *games_read += 1;
+}
+
+static int
+ut_pgn_input_read_games(FILE * file, char *expected_format)
+{
+  CtCommand command = ct_command_new(&games_read, ut_pgn_input_count_game);
+  CtPgnInput pgn_input;
+  int64_t bytes_read;
+
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ck_assert_str_eq(ct_pgn_input_format(pgn_input), expected_format);
+  ct_graph_from_pgn_input(graph, game_tags, pgn_input, command, error_message);
+  bytes_read = ct_pgn_input_bytes_read(pgn_input);
+  if (bytes_read > 0)
+    ck_assert(ct_pgn_input_megabytes_per_second(pgn_input) > 0);
+  ct_pgn_input_free(pgn_input);
+  ct_command_free(command);
+  return bytes_read;
+}
+
+START_TEST(ut_pgn_input_plain)
+{
+  FILE *file = tmpfile();
+  int index;
+
+  for (index = 0; index < COPIES; index++)
+    fwrite(pgn, 1, BYTES_IN_FILE, file);
+  ck_assert_int_eq(ut_pgn_input_read_games(file, "pgn"), COPIES * BYTES_IN_FILE);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, COPIES * GAMES_IN_FILE);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_input_empty)
+{
+  FILE *file = tmpfile();
+
+  ck_assert_int_eq(ut_pgn_input_read_games(file, "pgn"), 0);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, 0);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_input_file_is_decompressed)
+{
+#ifdef HAVE_LIBZ
+  FILE *file = tmpfile();
+  gzFile gz_file = gzdopen(dup(fileno(file)), "wb");
+  int found_it = 0;
+  CtCommand command = ct_command_new(&found_it, ut_pgn_input_count_game);
+
+  gzwrite(gz_file, pgn, BYTES_IN_FILE);
+  gzclose(gz_file);
+  rewind(file);
+  ct_graph_from_pgn_file(graph, game_tags, file, command, error_message);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(found_it, GAMES_IN_FILE);
+  ct_command_free(command);
+  fclose(file);
+#endif
+} END_TEST
+
+START_TEST(ut_pgn_input_gzip)
+{
+#ifdef HAVE_LIBZ
+  FILE *file = tmpfile();
+  int index;
+
+  /* each copy is its own gzip member, the way files compressed in pieces and concatenated are */
+  for (index = 0; index < COPIES; index++)
+  {
+    gzFile gz_file = gzdopen(dup(fileno(file)), "ab");
+
+    ck_assert_int_eq(gzwrite(gz_file, pgn, BYTES_IN_FILE), BYTES_IN_FILE);
+    gzclose(gz_file);
+  }
+  ck_assert_int_eq(ut_pgn_input_read_games(file, "gzip"), COPIES * BYTES_IN_FILE);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, COPIES * GAMES_IN_FILE);
+  fclose(file);
+#endif
+} END_TEST
+
+START_TEST(ut_pgn_input_gzip_truncated)
+{
+#ifdef HAVE_LIBZ
+  FILE *file = tmpfile();
+  gzFile gz_file = gzdopen(dup(fileno(file)), "wb");
+  long length;
+
+  gzwrite(gz_file, pgn, BYTES_IN_FILE);
+  gzclose(gz_file);
+  fseek(file, 0, SEEK_END);
+  length = ftell(file);
+  ck_assert(ftruncate(fileno(file), length / 2) == 0);
+  ut_pgn_input_read_games(file, "gzip");
+  ck_assert(strncmp(error_message, "gzip data is corrupt after byte ", 32) == 0);
+  ck_assert(games_read < GAMES_IN_FILE);
+  fclose(file);
+#endif
+} END_TEST
+
+START_TEST(ut_pgn_input_skip)
+{
+  FILE *file = tmpfile();
+  CtPgnInput pgn_input;
+  char text[16];
+
+  fwrite(pgn, 1, BYTES_IN_FILE, file);
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ck_assert(ct_pgn_input_skip(pgn_input, 2));        /* part of the bytes used to detect the format */
+  ck_assert(ct_pgn_input_skip(pgn_input, 1000));
+  ck_assert_int_eq(ct_pgn_input_bytes_read(pgn_input), 1002);
+  ck_assert_int_eq(ct_pgn_input_read(pgn_input, text, sizeof(text)), sizeof(text));
+  ck_assert(memcmp(text, pgn + 1002, sizeof(text)) == 0);
+  ct_pgn_input_free(pgn_input);
+  fclose(file);
+#ifdef HAVE_LIBZ
+  file = tmpfile();
+  {
+    gzFile gz_file = gzdopen(dup(fileno(file)), "wb");
+
+    gzwrite(gz_file, pgn, BYTES_IN_FILE);
+    gzclose(gz_file);
+  }
+  rewind(file);
+  pgn_input = ct_pgn_input_new(file);
+  ck_assert(ct_pgn_input_skip(pgn_input, 30000));
+  ck_assert_int_eq(ct_pgn_input_read(pgn_input, text, sizeof(text)), sizeof(text));
+  ck_assert(memcmp(text, pgn + 30000, sizeof(text)) == 0);
+  ck_assert(!ct_pgn_input_skip(pgn_input, BYTES_IN_FILE));
+  ct_pgn_input_free(pgn_input);
+  fclose(file);
+#endif
+} END_TEST
+
+START_TEST(ut_pgn_input_bzip2)
+{
+#ifdef HAVE_LIBBZ2
+  FILE *file = tmpfile();
+  int index, error;
+
+  for (index = 0; index < COPIES; index++)
+  {
+    BZFILE *bz_file = BZ2_bzWriteOpen(&error, file, 9, 0, 0);
+
+    ck_assert_int_eq(error, BZ_OK);
+    BZ2_bzWrite(&error, bz_file, pgn, BYTES_IN_FILE);
+    ck_assert_int_eq(error, BZ_OK);
+    BZ2_bzWriteClose(&error, bz_file, 0, 0, 0);
+  }
+  fflush(file);
+  ck_assert_int_eq(ut_pgn_input_read_games(file, "bzip2"), COPIES * BYTES_IN_FILE);
+  ck_assert_str_eq(error_message, "");
+  ck_assert_int_eq(games_read, COPIES * GAMES_IN_FILE);
+  fclose(file);
+#endif
+} END_TEST
+
+Suite *
+ut_pgn_input_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_pgn_input");
+  test_case = tcase_create("PgnInput");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_pgn_input_plain);
+  tcase_add_test(test_case, ut_pgn_input_empty);
+  tcase_add_test(test_case, ut_pgn_input_file_is_decompressed);
+  tcase_add_test(test_case, ut_pgn_input_gzip);
+  tcase_add_test(test_case, ut_pgn_input_gzip_truncated);
+  tcase_add_test(test_case, ut_pgn_input_bzip2);
+  tcase_add_test(test_case, ut_pgn_input_skip);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
@@ -0,0 +1,267 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+enum
+{
+  GAMES_IN_FILE = 56
+};
+
+static CtGameTags game_tags;
+static CtGraph graph;
+static FILE *pgn_file;
+static CtPgnInput pgn_input;
+
+static void setup(void);
+static void teardown(void);
+static void ut_pgn_reader_save_white(void *delegate);
+static void ut_pgn_reader_count_move(void *delegate, CtMove move);
+
+static char whites[GAMES_IN_FILE][GAME_TAGS_VALUE_MAX_LENGTH];
+
+static void
+setup(void)
+{
+  game_tags = ct_game_tags_new();
+  graph = ct_graph_new();
+  pgn_file = fopen("candidates2013.pgn", "r");
+  ck_assert(pgn_file != 0);
+  pgn_input = ct_pgn_input_new(pgn_file);
+}
+
+static void
+teardown(void)
+{
+  ct_pgn_input_free(pgn_input);
+  fclose(pgn_file);
+  ct_graph_free(graph);
+  ct_game_tags_free(game_tags);
+}
+
+static void
+ut_pgn_reader_save_white(void *delegate)
+{
+  int *game = (int *) delegate;
+
+  strcpy(whites[(*game)++], ct_game_tags_get(game_tags, "White"));
+}
+
+static void
+ut_pgn_reader_count_move(void *delegate, CtMove move)
+{
+  int *moves = (int *) delegate;
+
+  (*moves)++;
+}
+
+START_TEST(ut_pgn_reader_next_game)
+{
+  int game = 0;
+  CtCommand command = ct_command_new(&game, ut_pgn_reader_save_white);
+  CtPgnReader pgn_reader;
+  char error_message[CT_GRAPH_FROM_PGN_ERROR_MESSAGE_MAX_LENGTH];
+
+  /* the games pulled one at a time match the games read with a command */
+  ct_graph_from_pgn_input(graph, game_tags, pgn_input, command, error_message);
+  ck_assert_int_eq(game, GAMES_IN_FILE);
+  ct_pgn_input_free(pgn_input);
+  rewind(pgn_file);
+  pgn_input = ct_pgn_input_new(pgn_file);
+
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, pgn_input);
+  for (game = 0; ct_pgn_reader_next_game(pgn_reader); game++)
+  {
+    ck_assert_str_eq(ct_game_tags_get(game_tags, "White"), whites[game]);
+    ck_assert(ct_graph_ply(graph) > 0);
+  }
+  ck_assert_int_eq(game, GAMES_IN_FILE);
+  ck_assert_str_eq(ct_pgn_reader_error_message(pgn_reader), "");
+  ck_assert(!ct_pgn_reader_next_game(pgn_reader));
+  ct_pgn_reader_close(pgn_reader);
+  ct_command_free(command);
+} END_TEST
+
+START_TEST(ut_pgn_reader_side_by_side)
+{
+  FILE *other_file = fopen("candidates2013.pgn", "r");
+  CtPgnInput other_input = ct_pgn_input_new(other_file);
+  CtGraph other_graph = ct_graph_new();
+  CtGameTags other_game_tags = ct_game_tags_new();
+  CtPgnReader pgn_reader = ct_pgn_reader_open(graph, game_tags, pgn_input);
+  CtPgnReader other_reader = ct_pgn_reader_open(other_graph, other_game_tags, other_input);
+  int games = 0;
+
+  /* the other reader stays one game ahead */
+  ck_assert(ct_pgn_reader_next_game(other_reader));
+  while (ct_pgn_reader_next_game(pgn_reader))
+  {
+    games++;
+    if (games < GAMES_IN_FILE)
+    {
+      ck_assert(ct_pgn_reader_next_game(other_reader));
+      ck_assert(strcmp(ct_game_tags_get(game_tags, "Round"), ct_game_tags_get(other_game_tags, "Round")) != 0
+                || strcmp(ct_game_tags_get(game_tags, "White"), ct_game_tags_get(other_game_tags, "White")) != 0);
+    }
+  }
+  ck_assert_int_eq(games, GAMES_IN_FILE);
+  ck_assert(!ct_pgn_reader_next_game(other_reader));
+
+  ct_pgn_reader_close(other_reader);
+  ct_pgn_reader_close(pgn_reader);
+  ct_game_tags_free(other_game_tags);
+  ct_graph_free(other_graph);
+  ct_pgn_input_free(other_input);
+  fclose(other_file);
+} END_TEST
+
+START_TEST(ut_pgn_reader_error)
+{
+  FILE *file = tmpfile();
+  CtPgnInput input;
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_SKIP_GAME);
+  CtPgnReader pgn_reader;
+  int games;
+
+  fputs("[Event \"A\"]\n1. e4 1-0\n[Event \"B\"]\n1. e5 0-1\n[Event \"C\"]\n1. d4 *\n", file);
+  rewind(file);
+  input = ct_pgn_input_new(file);
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, input);
+  ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_str_eq(ct_game_tags_get(game_tags, "Event"), "A");
+  ck_assert(!ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_str_eq(ct_pgn_reader_error_message(pgn_reader), "syntax error on line 4 column 4");
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(input);
+
+  /* with an error log that skips bad games, the reader carries on after them */
+  rewind(file);
+  input = ct_pgn_input_new(file);
+  ct_pgn_input_use_error_log(input, pgn_error_log);
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, input);
+  for (games = 0; ct_pgn_reader_next_game(pgn_reader); games++)
+    ck_assert(strcmp(ct_game_tags_get(game_tags, "Event"), "B") != 0);
+  ck_assert_int_eq(games, 2);
+  ck_assert_str_eq(ct_pgn_reader_error_message(pgn_reader), "");
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 1);
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(input);
+
+  ct_pgn_error_log_free(pgn_error_log);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_reader_error_moves)
+{
+  FILE *file = tmpfile();
+  CtPgnInput input;
+  CtPgnErrorLog pgn_error_log = ct_pgn_error_log_new(PGN_ERROR_SKIP_GAME);
+  CtPgnReader pgn_reader;
+  int moves = 0;
+  CtMoveCommand move_command = ct_move_command_new(&moves, ut_pgn_reader_count_move);
+  int games;
+
+  /* the moves after 2. Kd3 are legal, but the rest of the game is skipped, so only e4 e5 are seen from game B */
+  fputs("[Event \"A\"]\n1. e4 1-0\n[Event \"B\"]\n1. e4 e5 2. Kd3 Nf3 3. Nc6 Bc4 0-1\n[Event \"C\"]\n1. d4 *\n", file);
+  rewind(file);
+  input = ct_pgn_input_new(file);
+  ct_pgn_input_use_error_log(input, pgn_error_log);
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, input);
+  ct_pgn_reader_use_move_command(pgn_reader, move_command);
+  for (games = 0; ct_pgn_reader_next_game(pgn_reader); games++)
+    ck_assert_int_eq(ct_graph_ply(graph), 1);
+  ck_assert_int_eq(games, 2);
+  ck_assert_int_eq(moves, 4);
+  ck_assert_int_eq(ct_pgn_error_log_count(pgn_error_log), 1);
+
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(input);
+  ct_move_command_free(move_command);
+  ct_pgn_error_log_free(pgn_error_log);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_reader_follow)
+{
+  char path[] = "ut_pgn_reader_follow_XXXXXX";
+  int descriptor = mkstemp(path);
+  FILE *file = fdopen(descriptor, "w+");
+  CtPgnInput input;
+  CtPgnReader pgn_reader;
+  int moves = 0;
+  CtMoveCommand move_command = ct_move_command_new(&moves, ut_pgn_reader_count_move);
+  pid_t writer;
+
+  /* the second game is finished by another process while the reader is waiting for it */
+  fputs("[Event \"A\"]\n1. e4 e5 1-0\n[Event \"B\"]\n1. d4 ", file);
+  fflush(file);
+  rewind(file);
+  writer = fork();
+  ck_assert(writer >= 0);
+  if (writer == 0)
+  {
+    FILE *append_file = fopen(path, "a");
+
+    usleep(100000);
+    fputs("d5 2. c4 *\n", append_file);
+    fclose(append_file);
+    _exit(0);
+  }
+  input = ct_pgn_input_new(file);
+  ck_assert(ct_pgn_input_follow(input, 1000));
+  pgn_reader = ct_pgn_reader_open(graph, game_tags, input);
+  ct_pgn_reader_use_move_command(pgn_reader, move_command);
+  ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_str_eq(ct_game_tags_get(game_tags, "Event"), "A");
+  ck_assert(ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_str_eq(ct_game_tags_get(game_tags, "Event"), "B");
+  ck_assert_int_eq(ct_graph_ply(graph), 3);
+  ck_assert_int_eq(moves, 5);
+  ck_assert(!ct_pgn_reader_next_game(pgn_reader));
+  ck_assert_str_eq(ct_pgn_reader_error_message(pgn_reader), "");
+  waitpid(writer, 0, 0);
+
+  ct_pgn_reader_close(pgn_reader);
+  ct_pgn_input_free(input);
+  ct_move_command_free(move_command);
+  fclose(file);
+  unlink(path);
+} END_TEST
+
+Suite *
+ut_pgn_reader_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_pgn_reader");
+  test_case = tcase_create("PgnReader");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_pgn_reader_next_game);
+  tcase_add_test(test_case, ut_pgn_reader_side_by_side);
+  tcase_add_test(test_case, ut_pgn_reader_error);
+  tcase_add_test(test_case, ut_pgn_reader_error_moves);
+  tcase_add_test(test_case, ut_pgn_reader_follow);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
@@ -0,0 +1,211 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+enum
+{
+  MANY_GAMES = 1000                /* enough games to fill the writer's buffer several times */
+};
+
+static CtGameTags game_tags;
+static CtGraph graph;
+static char *expected_pgn = "[Event \"Russia vs The Rest of the World\"]\n"
+  "[Site \"Moscow RUS\"]\n"
+  "[Date \"2002.09.09\"]\n"
+  "[Round \"5\"]\n"
+  "[White \"Judit Polgar\"]\n"
+  "[Black \"Garry Kasparov\"]\n"
+  "[Result \"1-0\"]\n"
+  "[WhiteElo \"2681\"]\n"
+  "[BlackElo \"2838\"]\n"
+  "\n"
+  "1. e4 e5 2. Nf3 Nc6 3. Bb5 Nf6 4. O-O Nxe4 5. d4 Nd6 6. Bxc6 dxc6 7. dxe5 Nf5\n"
+  "8. Qxd8+ Kxd8 9. Nc3 h6 10. Rd1+ Ke8 11. h3 Be7 12. Ne2 Nh4 13. Nxh4 Bxh4 14.\n"
+  "Be3 Bf5 15. Nd4 Bh7 16. g4 Be7 17. Kg2 h5 18. Nf5 Bf8 19. Kf3 Bg6 20. Rd2 hxg4+\n"
+  "21. hxg4 Rh3+ 22. Kg2 Rh7 23. Kg3 f6 24. Bf4 Bxf5 25. gxf5 fxe5 26. Re1 Bd6 27.\n"
+  "Bxe5 Kd7 28. c4 c5 29. Bxd6 cxd6 30. Re6 Rah8 31. Rexd6+ Kc8 32. R2d5 Rh3+ 33.\n"
+  "Kg2 Rh2+ 34. Kf3 R2h3+ 35. Ke4 b6 36. Rc6+ Kb8 37. Rd7 Rh2 38. Ke3 Rf8 39. Rcc7\n"
+  "Rxf5 40. Rb7+ Kc8 41. Rdc7+ Kd8 42. Rxg7 Kc8 1-0\n";
+
+static void setup(void);
+static void teardown(void);
+static char *ut_pgn_writer_read_file(FILE * file, int *length);
+
+static void
+setup(void)
+{
+  game_tags = ct_game_tags_new();
+  graph = ct_graph_new();
+  ck_assert(ct_graph_from_pgn(graph, game_tags, expected_pgn, 0) == graph);
+}
+
+static void
+teardown(void)
+{
+  ct_graph_free(graph);
+  ct_game_tags_free(game_tags);
+}
+
+static char *
+ut_pgn_writer_read_file(FILE * file, int *length)
+{
+  long file_length;
+  char *result;
+
+  fseek(file, 0, SEEK_END);
+  file_length = ftell(file);
+  rewind(file);
+  result = malloc(file_length + 1);
+  ck_assert(fread(result, 1, file_length, file) == file_length);
+  result[file_length] = 0;
+  if (length)
+    *length = file_length;
+  return result;
+}
+
+START_TEST(ut_pgn_writer_file)
+{
+  FILE *file = tmpfile();
+  CtPgnWriter pgn_writer;
+  char *expected_result = "[Event \"Russia vs The Rest of the World\"]\n"
+  "[Site \"Moscow RUS\"]\n"
+  "[Date \"2002.09.09\"]\n"
+  "[Round \"5\"]\n"
+  "[White \"Judit Polgar\"]\n"
+  "[Black \"Garry Kasparov\"]\n"
+  "[Result \"*\"]\n"
+  "[WhiteElo \"2681\"]\n"
+  "[BlackElo \"2838\"]\n"
+  "\n"
+  "1. e4 e5 *\n";
+  char *result;
+
+  ck_assert(file != 0);
+  pgn_writer = ct_pgn_writer_new(file);
+  ct_pgn_writer_write(pgn_writer, graph, game_tags);
+  while (ct_graph_ply(graph) > 2)
+    ct_graph_unmake_move(graph);
+  ct_game_tags_set(game_tags, "Result", "*");
+  ct_pgn_writer_write(pgn_writer, graph, game_tags);
+  ct_pgn_writer_free(pgn_writer);
+
+  result = ut_pgn_writer_read_file(file, 0);
+  ck_assert(strncmp(result, expected_pgn, strlen(expected_pgn)) == 0);
+  ck_assert(result[strlen(expected_pgn)] == '\n');        /* games are separated by an empty line */
+  ck_assert_str_eq(result + strlen(expected_pgn) + 1, expected_result);
+  free(result);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_writer_fd_many_games)
+{
+  FILE *file = tmpfile();
+  CtPgnWriter pgn_writer;
+  int expected_length = strlen(expected_pgn);
+  int index, length;
+  char *result;
+
+  ck_assert(file != 0);
+  pgn_writer = ct_pgn_writer_new_fd(fileno(file));
+  for (index = 0; index < MANY_GAMES; index++)
+    ct_pgn_writer_write(pgn_writer, graph, game_tags);
+  ct_pgn_writer_flush(pgn_writer);
+  ct_pgn_writer_free(pgn_writer);
+
+  result = ut_pgn_writer_read_file(file, &length);
+  ck_assert_int_eq(length, MANY_GAMES * (expected_length + 1) - 1);
+  for (index = 0; index < MANY_GAMES; index++)
+    ck_assert(strncmp(result + index * (expected_length + 1), expected_pgn, expected_length) == 0);
+  free(result);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_writer_without_tags_or_graph)
+{
+  FILE *file = tmpfile();
+  CtPgnWriter pgn_writer;
+  char *result;
+
+  while (ct_graph_ply(graph) > 3)
+    ct_graph_unmake_move(graph);
+  pgn_writer = ct_pgn_writer_new(file);
+  ct_pgn_writer_write(pgn_writer, graph, 0);
+  ct_pgn_writer_write(pgn_writer, 0, game_tags);
+  ct_pgn_writer_free(pgn_writer);
+  result = ut_pgn_writer_read_file(file, 0);
+  ck_assert(strncmp(result, "1. e4 e5 2. Nf3 *\n\n", 19) == 0);
+  ck_assert(strncmp(result + 19, expected_pgn, strstr(expected_pgn, "\n\n") - expected_pgn + 1) == 0);
+  ck_assert(strstr(result + 19, "\n\n") == 0);        /* no movetext section follows the tags */
+  free(result);
+  fclose(file);
+} END_TEST
+
+START_TEST(ut_pgn_writer_gzip)
+{
+  FILE *file = tmpfile();
+  CtPgnWriter pgn_writer;
+
+  pgn_writer = ct_pgn_writer_new_gzip_fd(fileno(file));
+#ifdef HAVE_LIBZ
+  {
+    char result[4096];
+    gzFile gz_file;
+    int length;
+
+    ck_assert(pgn_writer != 0);
+    ct_pgn_writer_write(pgn_writer, graph, game_tags);
+    ct_pgn_writer_free(pgn_writer);
+    lseek(fileno(file), 0, SEEK_SET);
+    gz_file = gzdopen(dup(fileno(file)), "rb");
+    ck_assert(gz_file != 0);
+    length = gzread(gz_file, result, sizeof(result) - 1);
+    ck_assert_int_eq(length, strlen(expected_pgn));
+    result[length] = 0;
+    ck_assert_str_eq(result, expected_pgn);
+    gzclose(gz_file);
+  }
+#else
+  ck_assert(pgn_writer == 0);
+#endif
+  fclose(file);
+} END_TEST
+
+Suite *
+ut_pgn_writer_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_pgn_writer");
+  test_case = tcase_create("PgnWriter");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_pgn_writer_file);
+  tcase_add_test(test_case, ut_pgn_writer_fd_many_games);
+  tcase_add_test(test_case, ut_pgn_writer_without_tags_or_graph);
+  tcase_add_test(test_case, ut_pgn_writer_gzip);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}
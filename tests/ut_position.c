@@ -142,6 +142,8 @@ START_TEST(ut_position_bit_boards)
   ck_assert(ct_position_get_bit_board(position, BLACK_BISHOP) == (ct_bit_board_make(C8) | ct_bit_board_make(F8)));
   ck_assert(ct_position_get_bit_board(position, BLACK_PAWN) == (0xFF000000000000));        /* A7 - H7 set */
   ck_assert(ct_position_get_bit_board(position, EMPTY) == (0xFFFFFFFF0000));        /* A3 - H6 set */
+  ck_assert(ct_position_get_bit_board(position, WHITE_PIECES) == 0xFFFF);        /* A1 - H2 set */
+  ck_assert(ct_position_get_bit_board(position, BLACK_PIECES) == 0xFFFF000000000000);        /* A7 - H8 set */
 
   ct_position_clear(position);
   ck_assert(ct_position_get_bit_board(position, EMPTY) == BITB_FULL);
@@ -151,6 +153,12 @@ START_TEST(ut_position_bit_boards)
   ct_position_set_piece(position, E2, WHITE_KING);
   ck_assert(ct_position_get_bit_board(position, WHITE_KING) == ct_bit_board_make(E2));
   ck_assert(ct_position_get_bit_board(position, EMPTY) == ~ct_bit_board_make(E2));
+  ck_assert(ct_position_get_bit_board(position, WHITE_PIECES) == ct_bit_board_make(E2));
+  ct_position_set_piece(position, E2, BLACK_ROOK);
+  ck_assert(ct_position_get_bit_board(position, WHITE_PIECES) == BITB_EMPTY);
+  ck_assert(ct_position_get_bit_board(position, BLACK_PIECES) == ct_bit_board_make(E2));
+  ct_position_set_piece(position, E2, EMPTY);
+  ck_assert(ct_position_get_bit_board(position, BLACK_PIECES) == BITB_EMPTY);
 
   ct_position_reset(position);
   ck_assert(ct_position_get_bit_board(position, EMPTY) == (0xFFFFFFFF0000));        /* A3 - H6 set */
@@ -17,6 +17,7 @@
 
 #include <config.h>
 #include <check.h>
+#include <string.h>
 #include "chess_toolkit.h"
 
 typedef struct IsLegalTestStruct *IsLegalTest;
@@ -48,6 +49,7 @@ static CtPosition position;
 
 static void setup(void);
 static void teardown(void);
+static void ut_position_verify_gives_check(CtGraph graph, CtMove move);
 
 static void
 setup(void)
@@ -61,6 +63,21 @@ teardown(void)
   ct_position_free(position);
 }
 
+static void
+ut_position_verify_gives_check(CtGraph graph, CtMove move)
+{
+  char fen[CT_FEN_MAX_LENGTH], san[CT_SAN_MAX_LENGTH];
+  bool gives_check;
+
+  ct_graph_to_position(graph, position);
+  gives_check = ct_position_gives_check(position, move);
+  ct_graph_move_to_san(graph, move, san);
+  ct_graph_to_fen(graph, fen);
+  ct_graph_make_move(graph, move);
+  ck_assert_msg(gives_check == ct_position_is_check(ct_graph_to_position(graph, position)), "%s %s", fen, san);
+  ct_graph_unmake_move(graph);
+}
+
 START_TEST(ut_position_is_position_legal)
 {
   IsLegalTestStruct tests[] =
@@ -145,6 +162,59 @@ START_TEST(ut_position_can_castle)
   }
 } END_TEST
 
+START_TEST(ut_position_attackers_to_and_pinned)
+{
+  ck_assert(ct_position_from_fen(position, "4r1k1/8/8/b7/4R2q/6B1/3N1P2/4K3 w - - 0 1") != 0);
+  ck_assert(ct_position_attackers_to(position, E5)
+            == (ct_bit_board_make(E4) | ct_bit_board_make(G3) | ct_bit_board_make(E8)));
+  ck_assert(ct_position_attackers_to(position, A2) == BITB_EMPTY);
+  ck_assert(ct_position_pinned(position) == (ct_bit_board_make(D2) | ct_bit_board_make(E4)));
+  ct_position_change_turns(position);
+  ck_assert(ct_position_pinned(position) == BITB_EMPTY);
+} END_TEST
+
+/* checks every legal move of each position and of the positions one move later against making the move */
+START_TEST(ut_position_gives_check)
+{
+  char *fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -",
+    /* castling, en passant and promotion that check */
+    "5k2/8/8/8/8/8/8/4K2R w K -",
+    "3k4/8/8/8/8/8/8/R3K3 w Q -",
+    "8/8/8/R2pP2k/8/8/8/4K3 w - d6",
+    "4k3/1P6/8/8/8/8/8/4K3 w - -",
+    0
+  };
+  CtGraph graph = ct_graph_new();
+  CtMove moves[CT_GRAPH_MAX_MOVES], replies[CT_GRAPH_MAX_MOVES];
+  int move_count, reply_count, index, reply_index;
+  char **fen;
+
+  for (fen = fens; *fen; fen++)
+  {
+    ck_assert_msg(ct_graph_from_fen(graph, *fen) != 0, *fen);
+    move_count = ct_graph_legal_move_count(graph);
+    memcpy(moves, ct_graph_legal_moves(graph), move_count * sizeof(CtMove));
+    for (index = 0; index < move_count; index++)
+    {
+      ut_position_verify_gives_check(graph, moves[index]);
+      ct_graph_make_move(graph, moves[index]);
+      reply_count = ct_graph_legal_move_count(graph);
+      memcpy(replies, ct_graph_legal_moves(graph), reply_count * sizeof(CtMove));
+      for (reply_index = 0; reply_index < reply_count; reply_index++)
+        ut_position_verify_gives_check(graph, replies[reply_index]);
+      ct_graph_unmake_move(graph);
+    }
+  }
+  ct_graph_free(graph);
+  ck_assert(ct_position_from_fen(position, "8/8/8/R2pP2k/8/8/8/4K3 w - d6") != 0);
+  ck_assert(ct_position_gives_check(position, ct_move_make_en_passant_capture(E5, D6)));
+  ck_assert(!ct_position_gives_check(position, ct_move_make(E5, E6)));
+} END_TEST
+
 Suite *
 ut_position_rules_make_suite(void)
 {
@@ -157,6 +227,8 @@ ut_position_rules_make_suite(void)
   tcase_add_test(test_case, ut_position_is_position_legal);
   tcase_add_test(test_case, ut_position_is_check);
   tcase_add_test(test_case, ut_position_can_castle);
+  tcase_add_test(test_case, ut_position_attackers_to_and_pinned);
+  tcase_add_test(test_case, ut_position_gives_check);
   suite_add_tcase(test_suite, test_case);
   return test_suite;
 }
@@ -0,0 +1,128 @@
+/*
+ * Chess Toolkit: a software library for creating chess programs
+ * Copyright (C) 2013 Steve Ortiz
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <config.h>
+#include <check.h>
+#include "chess_toolkit.h"
+
+typedef struct UtSeeTestStruct
+{
+  char *fen;
+  char *move;
+  int see;
+} UtSeeTestStruct;
+
+static CtGraph graph;
+static CtPosition position;
+
+static void setup(void);
+static void teardown(void);
+
+static void
+setup(void)
+{
+  graph = ct_graph_new();
+  position = ct_position_new();
+}
+
+static void
+teardown(void)
+{
+  ct_position_free(position);
+  ct_graph_free(graph);
+}
+
+/* values are 100 for a pawn, 300 for a knight or bishop, 500 for a rook and 900 for a queen */
+START_TEST(ut_position_see)
+{
+  UtSeeTestStruct tests[] = {
+    {"4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1", "exd5", 100},
+    {"1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "Rxe5", 100},
+    {"1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "Nxe5", -200},
+    {"3rk3/8/8/3p4/8/8/3R4/3RK3 w - - 0 1", "Rxd5", 100},
+    {"4k3/2p5/3p4/8/8/8/3Q4/4K3 w - - 0 1", "Qxd6", -800},
+    {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "Qxh3", -300},
+    {"4k3/8/2p5/8/8/2N5/8/4K3 w - - 0 1", "Nd5", -300},
+    {"4k3/8/2p5/8/8/2N5/8/4K3 w - - 0 1", "Ne4", 0},
+    {"4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "exd6", 100},
+    {"3r3k/4P3/8/8/8/8/8/4K3 w - - 0 1", "exd8=Q", 1300},
+    {"3r3k/4P3/8/8/8/8/8/4K3 w - - 0 1", "e8=Q", -100},
+    {"4k3/8/8/8/8/8/3r4/4K3 w - - 0 1", "Kxd2", 500},
+    {"r3k3/8/8/8/8/8/8/R3K3 b Qq - 0 1", "Rxa1", 500},
+    {0, 0, 0}
+  };
+  UtSeeTestStruct *test;
+  CtMove move;
+
+  for (test = tests; test->fen; test++)
+  {
+    ck_assert_msg(ct_graph_from_fen(graph, test->fen) != 0, test->fen);
+    move = ct_graph_move_from_san(graph, test->move);
+    ck_assert_msg(move != NULL_MOVE, test->move);
+    ct_graph_to_position(graph, position);
+    ck_assert_msg(ct_position_see(position, move) == test->see, "%s %s: %d", test->fen, test->move,
+                  ct_position_see(position, move));
+    ck_assert(ct_position_see_ge(position, move, test->see));
+    ck_assert(!ct_position_see_ge(position, move, test->see + 1));
+  }
+} END_TEST
+
+/* the threshold version must agree with the full evaluation for every move of some busy positions */
+START_TEST(ut_position_see_ge_agrees_with_see)
+{
+  char *fens[] = {
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    0
+  };
+  int thresholds[] = {-1000, -301, -300, -299, -200, -100, -1, 0, 1, 99, 100, 101, 300, 500, 900, 1300};
+  char **fen;
+  CtMove *moves;
+  int index, count, see, threshold;
+
+  for (fen = fens; *fen; fen++)
+  {
+    ck_assert_msg(ct_graph_from_fen(graph, *fen) != 0, *fen);
+    ct_graph_to_position(graph, position);
+    moves = ct_graph_legal_moves(graph);
+    count = ct_graph_legal_move_count(graph);
+    for (index = 0; index < count; index++)
+    {
+      see = ct_position_see(position, moves[index]);
+      for (threshold = 0; threshold < (int) (sizeof(thresholds) / sizeof(thresholds[0])); threshold++)
+        ck_assert_msg(ct_position_see_ge(position, moves[index], thresholds[threshold])
+                      == (see >= thresholds[threshold]), "%s %s: see %d, threshold %d", *fen,
+                      ct_move_to_s(moves[index], 0), see, thresholds[threshold]);
+    }
+  }
+} END_TEST
+
+Suite *
+ut_position_see_make_suite(void)
+{
+  Suite *test_suite;
+  TCase *test_case;
+
+  test_suite = suite_create("ut_position_see");
+  test_case = tcase_create("Position.see");
+  tcase_add_checked_fixture(test_case, setup, teardown);
+  tcase_add_test(test_case, ut_position_see);
+  tcase_add_test(test_case, ut_position_see_ge_agrees_with_see);
+  suite_add_tcase(test_suite, test_case);
+  return test_suite;
+}